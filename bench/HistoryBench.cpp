@@ -0,0 +1,92 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <SFML/System.hpp>
+
+#include "GameSimulation.h"
+#include "Snapshot.h"
+#include "StateHistory.h"
+
+/** Benchmarks recording a minute of game state into a StateHistory.
+ *
+ * Usage: HistoryBench.out [enemies] [ticks]
+ *
+ * The enemies are spawned into a headless GameSimulation and circle around, so every
+ * Transform changes every tick, which is the worst case for the deltas. Each tick is what
+ * GameSimulation::saveTo() writes. Doesn't open a window, so it runs on headless machines;
+ * run from the repo root, the simulation loads its definitions from assets/.
+ * Exits with 1 if recording a tick averages 50 us or more, if the history needs more than
+ * its 4MB, or if a tick doesn't rebuild into exactly what was recorded.
+ */
+
+int main(int argc, char **argv)
+{
+    const int enemyCount = argc > 1 ? atoi(argv[1]) : 50;
+    const int ticks = argc > 2 ? atoi(argv[2]) : 3600;
+    const float deltaTime = 1.0f / 60;
+
+    GameSimulation sim(true, 1);
+    EntityWorld &world = sim.getWorld();
+    for(int i = 0; i < enemyCount; i++)
+    {
+        sim.getWave().spawnEnemy(0, sf::Vector2<float>((i * 37) % 1500, (i * 53) % 1125));
+    }
+
+    // Same sizes GameManager uses
+    StateHistory history(4 * 1024 * 1024, 3600, 60);
+    Snapshot snapshot;
+    Snapshot check;
+    Snapshot rebuilt;
+
+    sf::Int64 total = 0, worst = 0;
+    int mismatches = 0;
+    for(int tick = 0; tick < ticks; tick++)
+    {
+        const float time = tick * deltaTime;
+        world.eachBatch<Transform>([time](std::size_t count, const EntityId *ids, Transform *transform)
+        {
+            for(std::size_t i = 0; i < count; i++)
+            {
+                transform[i].velocity = sf::Vector2<float>(std::cos(time + i) * 60, std::sin(time + i) * 60);
+            }
+        });
+        integrateMotion(world, deltaTime);
+        if(tick % 30 == 0)
+        {
+            sim.getProjectiles().fire(sf::Vector2<float>(750, 560), sf::Vector2<float>(200, 100), 5, EnemyTeam, 4);
+        }
+
+        sf::Clock timer;
+        snapshot.beginWrite();
+        sim.saveTo(snapshot);
+        history.record(snapshot);
+        sf::Int64 recordTime = timer.getElapsedTime().asMicroseconds();
+        total += recordTime;
+        worst = recordTime > worst ? recordTime : worst;
+
+        // Every so often make sure the newest tick and one from the middle come back the same
+        if(tick % 97 == 0)
+        {
+            if(!history.getFrame(history.size() - 1, rebuilt) || rebuilt.getData() != snapshot.getData())
+            {
+                mismatches++;
+            }
+            check = snapshot;
+        }
+        if(tick % 97 == 48 && (!history.getFrame(history.size() - 49, rebuilt)
+                || rebuilt.getData() != check.getData()))
+        {
+            mismatches++;
+        }
+    }
+
+    printf("%d enemies, %d ticks, %zu byte ticks\n", enemyCount, ticks, snapshot.size());
+    printf("record     mean %8.3f us   max %8.3f us\n", (double)total / ticks, (double)worst);
+    printf("history    %d ticks in %.2f MB (%.2f MB uncompressed)\n", history.size(),
+            history.getBytesUsed() / 1048576.0, (double)snapshot.size() * history.size() / 1048576.0);
+    printf("mismatches %d\n", mismatches);
+
+    const bool pass = total < 50 * ticks && history.getBytesUsed() <= history.getCapacity() && mismatches == 0;
+    printf("%s\n", pass ? "PASS" : "FAIL");
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,371 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "GameSimulation.h"
+#include "Enemy.h"
+#include "Player.h"
+#include "SpriteBatch.h"
+#include "ScriptScheduler.h"
+
+/** Micro-benchmarks for the hot per-tick kernels, each swept across input sizes.
+ *
+ * Usage: KernelBench.out [--csv] [--samples n] [kernel...]
+ *
+ * Kernels:
+ *     player_update  Player::updateAll() over n player controlled entities, with input that
+ *                    cycles through every direction and none, so the dead axis path runs too
+ *     enemy_update   Enemy::updateAll() for n enemies chasing the player
+ *     raycast        GameSimulation::rayCast() from the player through n enemies
+ *     sprite_build   SpriteBatch::build() depth sorting n enemies that each move a little per call,
+ *                    so it mostly patches up the order of the call before
+ *     begin_wave     WaveManager::beginWave() planning a wave of n enemies on the spot, then
+ *                    spawnPending() bringing in every one its script lets in straight away.
+ *                    No n is a multiple of 5, so every wave is a steady one that lets all n in
+ *     script_update  ScriptScheduler::update() with n scripts each sleeping 1 to 10 seconds at
+ *                    a time, so only about one in 205 of them wakes per tick
+ *
+ * Each size is warmed up, then timed as a number of samples. Every sample runs the kernel
+ * enough times to take at least a couple of milliseconds, and reports the time per call.
+ * The table (or CSV with --csv) has the mean, standard deviation, median and 95% confidence
+ * interval of the mean over the samples, all in nanoseconds per call. Run from the repo
+ * root, the simulation loads its definitions from assets/.
+ */
+
+typedef std::chrono::steady_clock BenchClock;
+
+/** Runs a kernel some number of times and returns how many seconds the kernel itself took. */
+typedef std::function<double(int iterations)> Kernel;
+
+struct Stats
+{
+    double mean;
+    double stddev;
+    double median;
+    double ciLow;
+    double ciHigh;
+};
+
+struct Sweep
+{
+    const char *name;
+    std::vector<int> sizes;
+
+    /** Sets a kernel up for a size */
+    std::function<Kernel(int size)> setup;
+};
+
+static const double minSampleSeconds = 0.002;
+static const double warmupSeconds = 0.05;
+
+// Keeps results alive so the kernels can't be optimized away
+static volatile std::uint32_t sink;
+
+static double secondsSince(BenchClock::time_point start)
+{
+    return std::chrono::duration<double>(BenchClock::now() - start).count();
+}
+
+// Two sided 95% critical value of Student's t distribution
+static double tCritical(int degrees)
+{
+    static const double table[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228};
+    if(degrees < 1)
+    {
+        return 0;
+    }
+    if(degrees <= 10)
+    {
+        return table[degrees - 1];
+    }
+    return degrees <= 20 ? 2.086 : degrees <= 30 ? 2.042 : degrees <= 60 ? 2.000 : 1.960;
+}
+
+static Stats measure(Kernel &kernel, int samples)
+{
+    // Warm up the caches and branch predictors, and find how many calls make a sample long enough
+    int iterations = 1;
+    double elapsed = 0;
+    BenchClock::time_point warmup = BenchClock::now();
+    while(secondsSince(warmup) < warmupSeconds || elapsed < minSampleSeconds)
+    {
+        elapsed = kernel(iterations);
+        if(elapsed < minSampleSeconds)
+        {
+            iterations *= 2;
+        }
+    }
+
+    std::vector<double> times(samples);
+    for(int i = 0; i < samples; i++)
+    {
+        times[i] = kernel(iterations) / iterations * 1e9;
+    }
+
+    Stats stats;
+    double sum = 0;
+    for(int i = 0; i < samples; i++)
+    {
+        sum += times[i];
+    }
+    stats.mean = sum / samples;
+
+    double squares = 0;
+    for(int i = 0; i < samples; i++)
+    {
+        squares += (times[i] - stats.mean) * (times[i] - stats.mean);
+    }
+    stats.stddev = samples > 1 ? std::sqrt(squares / (samples - 1)) : 0;
+
+    std::sort(times.begin(), times.end());
+    stats.median = samples % 2 == 1 ? times[samples / 2] : (times[samples / 2 - 1] + times[samples / 2]) / 2;
+
+    const double margin = tCritical(samples - 1) * stats.stddev / std::sqrt((double)samples);
+    stats.ciLow = stats.mean - margin;
+    stats.ciHigh = stats.mean + margin;
+    return stats;
+}
+
+// A simulation with n enemies spread over the map on a grid, touching enemies refuse to move
+static GameSimulation* spawnCrowd(int enemies)
+{
+    GameSimulation *sim = new GameSimulation(true, 1);
+    for(int i = 0; i < enemies; i++)
+    {
+        sim->getWave().spawnEnemy(i % 2, sf::Vector2<float>(100 + (i % 28) * 48, 100 + (i / 28 % 20) * 48));
+    }
+    sim->step(0);
+    return sim;
+}
+
+static Kernel playerUpdate(int entities)
+{
+    std::shared_ptr<EntityWorld> world(new EntityWorld());
+    for(int i = 0; i < entities; i++)
+    {
+        Transform transform = {sf::Vector2<float>(i, i), sf::Vector2<float>(0, 0)};
+        PlayerControl control = {};
+        world->create(transform, control);
+    }
+
+    return [world](int iterations)
+    {
+        static const float directions[9][2] = {{0, 0}, {1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1},
+            {0, -1}, {1, -1}};
+        double seconds = 0;
+        for(int i = 0; i < iterations; i++)
+        {
+            // Input is set up outside the timed part, like GameSimulation::applyInput() does
+            int entity = i;
+            world->each<PlayerControl>([&entity](EntityId id, PlayerControl &control)
+            {
+                const float *direction = directions[entity++ % 9];
+                control.moveVec = sf::Vector2<float>(direction[0], direction[1]);
+            });
+
+            BenchClock::time_point start = BenchClock::now();
+            Player::updateAll(*world, 1.0f / 60);
+            seconds += secondsSince(start);
+        }
+        return seconds;
+    };
+}
+
+static Kernel enemyUpdate(int enemies)
+{
+    std::shared_ptr<GameSimulation> sim(spawnCrowd(enemies));
+    std::shared_ptr<BehaviorGroups> groups(new BehaviorGroups());
+    groups->reserve(sim->getWorld().getEntityCount(), sim->getWave().getArchetypes().getBehaviors().getStateCount());
+    return [sim, groups](int iterations)
+    {
+        BenchClock::time_point start = BenchClock::now();
+        for(int i = 0; i < iterations; i++)
+        {
+            Enemy::updateAll(sim->getWorld(), sim->getWave().getArchetypes(), sim->getPlayer(),
+                    sim->getProjectiles(), *groups, 1.0f / 60);
+        }
+        return secondsSince(start);
+    };
+}
+
+static Kernel rayCast(int enemies)
+{
+    std::shared_ptr<GameSimulation> sim(spawnCrowd(enemies));
+    return [sim](int iterations)
+    {
+        const EntityId player = sim->getPlayer().getId();
+        std::uint32_t hits = 0;
+        BenchClock::time_point start = BenchClock::now();
+        for(int i = 0; i < iterations; i++)
+        {
+            // Sweep the ray around, so some calls hit early and some never do
+            const float angle = i * 0.1f;
+            hits += sim->rayCast(player, sf::Vector2<float>(std::cos(angle), std::sin(angle)) * 250.0f).isValid();
+        }
+        const double seconds = secondsSince(start);
+        sink = hits;
+        return seconds;
+    };
+}
+
+static Kernel spriteBuild(int enemies)
+{
+    std::shared_ptr<GameSimulation> sim(spawnCrowd(enemies));
+    std::shared_ptr<SpriteBatch> sprites(new SpriteBatch());
+    return [sim, sprites](int iterations)
+    {
+        EntityWorld &world = sim->getWorld();
+        double seconds = 0;
+        int reused = 0;
+        for(int i = 0; i < iterations; i++)
+        {
+            // A frame's worth of walking, about a pixel each
+            int step = i;
+            world.each<Transform, EnemyBrain>([&step](EntityId id, Transform &transform, EnemyBrain &brain)
+            {
+                transform.position.y += (step++ % 3) - 1;
+            });
+
+            BenchClock::time_point start = BenchClock::now();
+            sprites->build(world, sim->getTextures());
+            seconds += secondsSince(start);
+            reused += sprites->reusedOrder();
+        }
+        sink = reused;
+        return seconds;
+    };
+}
+
+static Kernel beginWave(int enemies)
+{
+    std::shared_ptr<GameSimulation> sim(new GameSimulation(true, 1));
+
+    // Nothing steps the simulation to hand its events out, so don't let them pile up. Every
+    // wave is planned inside beginWave(), with no thread started for the one after it.
+    sim->getWave().setEvents(nullptr);
+    sim->getWave().setPlanAhead(false);
+    return [sim, enemies](int iterations)
+    {
+        WaveManager &wave = sim->getWave();
+        double seconds = 0;
+        for(int i = 0; i < iterations; i++)
+        {
+            // Wave n spawns n enemies
+            wave.setWave(enemies - 1);
+            BenchClock::time_point start = BenchClock::now();
+            wave.beginWave();
+            wave.spawnPending(enemies);
+            seconds += secondsSince(start);
+            wave.endWave();
+        }
+        return seconds;
+    };
+}
+
+// Sleeps on and on, each time for as many seconds as it was started with
+static WaveScript sleeper(WaveManager &, int seconds)
+{
+    while(true)
+    {
+        co_await Sleep {(float)seconds};
+    }
+}
+
+static const ScriptFunction benchScripts[] = {sleeper};
+
+static Kernel scriptUpdate(int scripts)
+{
+    std::shared_ptr<GameSimulation> sim(new GameSimulation(true, 1));
+    std::shared_ptr<ScriptScheduler> scheduler(new ScriptScheduler(sim->getWave(), benchScripts, 1));
+    for(int i = 0; i < scripts; i++)
+    {
+        scheduler->start(0, i % 10 + 1);
+    }
+    return [sim, scheduler](int iterations)
+    {
+        BenchClock::time_point start = BenchClock::now();
+        for(int i = 0; i < iterations; i++)
+        {
+            scheduler->update(1.0f / 60);
+        }
+        return secondsSince(start);
+    };
+}
+
+int main(int argc, char **argv)
+{
+    bool csv = false;
+    int samples = 30;
+    std::vector<std::string> only;
+    for(int i = 1; i < argc; i++)
+    {
+        if(strcmp(argv[i], "--csv") == 0)
+        {
+            csv = true;
+        }
+        else if(strcmp(argv[i], "--samples") == 0 && i + 1 < argc)
+        {
+            samples = std::max(2, atoi(argv[++i]));
+        }
+        else
+        {
+            only.push_back(argv[i]);
+        }
+    }
+
+    // beginWave() places enemies at random at least 30 apart, which runs out of room on the map
+    // as a wave nears 1000, so its sweep stays well under that
+    std::vector<Sweep> sweeps = {
+        {"player_update", {1, 16, 256, 4096}, playerUpdate},
+        {"enemy_update", {10, 100, 500, 2000}, enemyUpdate},
+        {"raycast", {10, 100, 500, 2000}, rayCast},
+        {"sprite_build", {10, 100, 500, 2000}, spriteBuild},
+        {"begin_wave", {11, 51, 201, 501}, beginWave},
+        {"script_update", {10, 100, 1000, 10000}, scriptUpdate}
+    };
+
+    if(csv)
+    {
+        printf("kernel,size,samples,mean_ns,stddev_ns,median_ns,ci95_low_ns,ci95_high_ns\n");
+    }
+    else
+    {
+        printf("%-14s %6s %12s %12s %12s %12s\n", "kernel", "size", "mean ns", "+/- 95%", "median ns", "stddev");
+    }
+
+    for(std::size_t i = 0; i < sweeps.size(); i++)
+    {
+        if(!only.empty() && std::find(only.begin(), only.end(), sweeps[i].name) == only.end())
+        {
+            continue;
+        }
+
+        for(std::size_t j = 0; j < sweeps[i].sizes.size(); j++)
+        {
+            const int size = sweeps[i].sizes[j];
+            Kernel kernel = sweeps[i].setup(size);
+            const Stats stats = measure(kernel, samples);
+            if(csv)
+            {
+                printf("%s,%d,%d,%.1f,%.1f,%.1f,%.1f,%.1f\n", sweeps[i].name, size, samples, stats.mean,
+                        stats.stddev, stats.median, stats.ciLow, stats.ciHigh);
+            }
+            else
+            {
+                printf("%-14s %6d %12.1f %12.1f %12.1f %12.1f\n", sweeps[i].name, size, stats.mean,
+                        stats.ciHigh - stats.mean, stats.median, stats.stddev);
+            }
+            fflush(stdout);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <SFML/System.hpp>
+
+#include "GameServer.h"
+#include "GameClient.h"
+#include "NetProtocol.h"
+
+/** Runs a server and a few clients in one process over localhost.
+ *
+ * Usage: NetLoopbackBench.out [clients] [seconds] [enemies]
+ *
+ * The server is ticked as fast as it'll go rather than in real time, so bandwidth is per
+ * second of game time. The first wave gets topped up with extra enemies, so there's a crowd
+ * moving every snapshot. Clients wander around like the --bot client does. At the end every
+ * client's newest snapshot has to match the server's exactly, which checks the deltas
+ * rebuild into the right thing. Exits with 1 if any client doesn't match or dropped a snapshot.
+ */
+
+static bool sameEntities(const NetFrame &lhs, const NetFrame &rhs)
+{
+    if(lhs.tick != rhs.tick || lhs.entities.size() != rhs.entities.size())
+    {
+        return false;
+    }
+    for(std::size_t i = 0; i < lhs.entities.size(); i++)
+    {
+        const NetEntity &a = lhs.entities[i];
+        const NetEntity &b = rhs.entities[i];
+        if(a.id != b.id || a.generation != b.generation || a.flags != b.flags || a.archetype != b.archetype
+                || a.x != b.x || a.y != b.y || a.health != b.health || a.sprite != b.sprite)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    const int clientCount = argc > 1 ? atoi(argv[1]) : 4;
+    const int seconds = argc > 2 ? atoi(argv[2]) : 20;
+    const int enemies = argc > 3 ? atoi(argv[3]) : 100;
+
+    GameServer server(sf::Socket::AnyPort);
+    server.setLogging(false);
+    if(!server.isListening())
+    {
+        return 1;
+    }
+    // Spread out on a grid, enemies spawned touching each other refuse to move
+    for(int i = 0; i < enemies; i++)
+    {
+        server.getSimulation().getWave().spawnEnemy(i % 2, sf::Vector2<float>(100 + (i % 28) * 48,
+                    100 + (i / 28 % 20) * 48));
+    }
+
+    std::vector<GameClient*> clients;
+    for(int i = 0; i < clientCount; i++)
+    {
+        clients.push_back(new GameClient());
+        clients.back()->setLogging(false);
+        clients.back()->connect(sf::IpAddress::LocalHost, server.getPort());
+    }
+
+    float totalSim = 0, totalSend = 0, totalBytes = 0, maxBytes = 0, packetSize = 0;
+    int statSeconds = 0;
+    int dropped = 0;
+    PlayerInput input = {sf::Vector2<float>(0, 0), false, false};
+    NetFrame frame;
+
+    const int ticks = seconds * GameServer::tickRate + 1;
+    for(int tick = 0; tick < ticks; tick++)
+    {
+        if(tick % 30 == 0)
+        {
+            input.move = sf::Vector2<float>(rand() % 3 - 1, rand() % 3 - 1);
+        }
+        input.attack = tick % 45 == 0;
+
+        for(int i = 0; i < clientCount; i++)
+        {
+            clients[i]->sendInput(input);
+        }
+
+        // Give loopback a moment, then let everyone take in what arrived
+        sf::sleep(sf::microseconds(200));
+        server.tick();
+        sf::sleep(sf::microseconds(200));
+        for(int i = 0; i < clientCount; i++)
+        {
+            clients[i]->update();
+            clients[i]->interpolate(frame);
+        }
+
+        if(tick % GameServer::tickRate == GameServer::tickRate - 1 && tick > GameServer::tickRate)
+        {
+            const ServerStats &stats = server.getStats();
+            totalSim += stats.simTime.asMicroseconds();
+            totalSend += stats.sendTime.asMicroseconds();
+            totalBytes += stats.bytesPerClient;
+            maxBytes = std::max(maxBytes, stats.maxBytesPerClient);
+            packetSize += stats.packetSize;
+            statSeconds++;
+        }
+    }
+
+    // One more pass so the last snapshot has certainly arrived
+    sf::sleep(sf::milliseconds(20));
+    int mismatched = 0;
+    for(int i = 0; i < clientCount; i++)
+    {
+        clients[i]->update();
+        dropped += clients[i]->getStats().dropped;
+        if(!sameEntities(clients[i]->getNewestFrame(), server.getLastFrame()))
+        {
+            mismatched++;
+        }
+    }
+
+    printf("%d clients, %d seconds, %d connected, %d entities\n", clientCount, seconds,
+            server.getClientCount(), (int)server.getLastFrame().entities.size());
+    printf("tick       sim %8.1f us   send %8.1f us\n", totalSim / statSeconds, totalSend / statSeconds);
+    printf("bandwidth  %8.2f KB/s per client (max %.2f), %.0f byte snapshots\n",
+            totalBytes / statSeconds / 1024, maxBytes / 1024, packetSize / statSeconds);
+    printf("mismatched %d, dropped %d\n", mismatched, dropped);
+
+    for(int i = 0; i < clientCount; i++)
+    {
+        delete clients[i];
+    }
+
+    const bool pass = mismatched == 0 && dropped == 0 && server.getClientCount() == clientCount;
+    printf("%s\n", pass ? "PASS" : "FAIL");
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <SFML/Graphics.hpp>
+
+#include "GameSimulation.h"
+#include "GameRenderer.h"
+#include "RenderCounter.h"
+#include "FrameArena.h"
+
+/** Draws synthetic scenes through the game's real draw path into an offscreen texture.
+ *
+ * Usage: RenderBench.out [frames] [enemies...]
+ *
+ * Each enemy count gets its own scene: that many enemies spread over the map, a hit effect
+ * and a damage number every frame, and the full HUD and minimap, drawn by GameRenderer into
+ * an sf::RenderTexture the size of the window. Nothing is shown on screen.
+ *
+ * Mesa's software rasterizer is asked for unless LIBGL_ALWAYS_SOFTWARE is already set, so
+ * numbers from different machines are comparable. SFML still needs an X display for its
+ * context, on a host without one run it under xvfb-run.
+ *
+ * Time per frame includes waiting for the last frame to finish rasterizing. The particle
+ * columns are from ParticleSystem::getStats(): how many are alive on average, the time spent
+ * updating and building them per frame, and how many bursts trimmed over the whole run.
+ */
+
+static const unsigned width = 1280;
+static const unsigned height = 720;
+static const int warmupFrames = 30;
+
+int main(int argc, char **argv)
+{
+    setenv("LIBGL_ALWAYS_SOFTWARE", "1", 0);
+
+    const int frames = argc > 1 ? atoi(argv[1]) : 300;
+    if(frames <= 0)
+    {
+        // Every average is per frame
+        printf("ERROR: frames has to be at least 1!!\n");
+        return 1;
+    }
+    std::vector<int> enemyCounts;
+    for(int i = 2; i < argc; i++)
+    {
+        enemyCounts.push_back(atoi(argv[i]));
+    }
+    if(enemyCounts.empty())
+    {
+        enemyCounts = {0, 100, 500, 2000};
+    }
+
+    sf::RenderTexture texture;
+    if(!texture.create(width, height))
+    {
+        printf("ERROR: offscreen target can not be created!!\n");
+        return 1;
+    }
+
+    printf("%d frames at %ux%u\n", frames, width, height);
+    printf("%8s %12s %12s %10s %10s %10s %12s %10s\n", "enemies", "draw calls", "vertices", "binds",
+            "ms/frame", "particles", "particle ms", "dropped");
+    for(std::size_t scene = 0; scene < enemyCounts.size(); scene++)
+    {
+        const int enemies = enemyCounts[scene];
+        GameSimulation sim(false, 1);
+        for(int i = 0; i < enemies; i++)
+        {
+            sim.getWave().spawnEnemy(i % 2, sf::Vector2<float>(40 + (i % 40) * 36, 40 + (i / 40 % 30) * 36));
+        }
+
+        // One tick so the grid, animations and health are all set up
+        sim.step(0);
+
+        // The view the game uses, half the window each way
+        GameRenderer renderer(sf::Vector2<float>(width / 2.0, height / 2.0));
+        RenderCounter target(texture);
+        // Bigger than the game's, the HUD bars of 2000 enemies don't fit in 256KB
+        FrameArena arena(1024 * 1024);
+        const EntityId focus = sim.getPlayer().getId();
+        RoundInfo round = {1, enemies, enemies};
+
+        RenderCounts counts = {0, 0, 0, 0, 0};
+        long particles = 0, dropped = 0;
+        sf::Time particleTime;
+        sf::Clock clock;
+        for(int frame = -warmupFrames; frame < frames; frame++)
+        {
+            if(frame == 0)
+            {
+                // Wait for the warm-up to finish before starting the clock
+                texture.getTexture().copyToImage();
+                clock.restart();
+            }
+
+            // Keep the effects busy, the same way a fight would
+            if(enemies > 0)
+            {
+                const EntityId hit = sim.getWave().getEnemy((frame + warmupFrames) % enemies);
+                const sf::Vector2<float> position = sim.getWorld().get<Transform>(hit)->position;
+                renderer.getParticles().burst(ParticleSystem::hitEffect, position);
+                renderer.getDamageNumbers().spawn(position, 40, sf::Color(255, 230, 140));
+            }
+            renderer.updateEffects(1 / 60.0);
+            renderer.updateMinimap(1 / 60.0, sim, focus, false);
+
+            arena.reset();
+            target.reset();
+            texture.clear();
+            renderer.draw(target, sim, focus, round, arena);
+            texture.display();
+
+            if(frame >= 0)
+            {
+                counts.drawCalls += target.getCounts().drawCalls;
+                counts.vertices += target.getCounts().vertices;
+                counts.textureBinds += target.getCounts().textureBinds;
+
+                const ParticleStats &stats = renderer.getParticles().getStats();
+                particles += stats.live;
+                dropped += stats.dropped;
+                particleTime += stats.updateTime + stats.buildTime;
+            }
+        }
+        texture.getTexture().copyToImage();
+        const float elapsed = clock.getElapsedTime().asSeconds();
+
+        printf("%8d %12.1f %12.0f %10.1f %10.3f %10.0f %12.4f %10ld\n", enemies, (float)counts.drawCalls / frames,
+                (float)counts.vertices / frames, (float)counts.textureBinds / frames, elapsed * 1000 / frames,
+                (float)particles / frames, particleTime.asSeconds() * 1000 / frames, dropped);
+    }
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include <cstdio>
+#include <cstdlib>
+#include <SFML/System.hpp>
+
+#include "GameSimulation.h"
+#include "Snapshot.h"
+
+/** Benchmarks capturing and restoring a game state with a big wave of enemies.
+ *
+ * Usage: SnapshotBench.out [enemies] [iterations]
+ *
+ * The wave is spawned into a headless GameSimulation, and saved and restored with its own
+ * saveTo() and loadFrom(). Doesn't open a window, so it runs on headless machines; run from
+ * the repo root, the simulation loads its definitions from assets/.
+ * Exits with 1 if either the mean save or the mean restore takes 1 ms or more.
+ */
+
+static void save(Snapshot &snapshot, const GameSimulation &sim)
+{
+    snapshot.beginWrite();
+    sim.saveTo(snapshot);
+}
+
+static bool restore(Snapshot &snapshot, GameSimulation &sim)
+{
+    return snapshot.beginRead() && sim.loadFrom(snapshot);
+}
+
+static void report(const char *name, sf::Int64 total, sf::Int64 best, sf::Int64 worst, int iterations)
+{
+    printf("%-10s mean %8.3f ms   min %8.3f ms   max %8.3f ms\n", name,
+            total / 1000.0 / iterations, best / 1000.0, worst / 1000.0);
+}
+
+int main(int argc, char **argv)
+{
+    const int enemyCount = argc > 1 ? atoi(argv[1]) : 10000;
+    const int iterations = argc > 2 ? atoi(argv[2]) : 200;
+
+    GameSimulation sim(true, 1);
+    ProjectileSystem &projectiles = sim.getProjectiles();
+    for(int i = 0; i < enemyCount; i++)
+    {
+        sim.getWave().spawnEnemy(0, sf::Vector2<float>((i * 37) % 1500, (i * 53) % 1125));
+    }
+    for(int i = 0; i < enemyCount / 5; i++)
+    {
+        projectiles.fire(sf::Vector2<float>((i * 11) % 1500, (i * 13) % 1125),
+                sf::Vector2<float>(100, 50), 5, EnemyTeam, 4);
+    }
+
+    Snapshot snapshot;
+
+    // Warm up, so the snapshot buffer and the world's storage are already big enough. Every
+    // entity has to come back, the player as well as the wave.
+    const std::size_t entities = sim.getWorld().getEntityCount();
+    save(snapshot, sim);
+    if(!restore(snapshot, sim) || sim.getWorld().getEntityCount() != entities)
+    {
+        printf("ERROR: restored state doesn't match!!\n");
+        return 1;
+    }
+
+    sf::Int64 saveTotal = 0, saveBest = -1, saveWorst = 0;
+    sf::Int64 restoreTotal = 0, restoreBest = -1, restoreWorst = 0;
+    for(int i = 0; i < iterations; i++)
+    {
+        sf::Clock timer;
+        save(snapshot, sim);
+        sf::Int64 saveTime = timer.restart().asMicroseconds();
+        restore(snapshot, sim);
+        sf::Int64 restoreTime = timer.getElapsedTime().asMicroseconds();
+
+        saveTotal += saveTime;
+        saveBest = saveBest < 0 || saveTime < saveBest ? saveTime : saveBest;
+        saveWorst = saveTime > saveWorst ? saveTime : saveWorst;
+        restoreTotal += restoreTime;
+        restoreBest = restoreBest < 0 || restoreTime < restoreBest ? restoreTime : restoreBest;
+        restoreWorst = restoreTime > restoreWorst ? restoreTime : restoreWorst;
+    }
+
+    // One checkpoint file round trip, for reference
+    sf::Clock fileTimer;
+    snapshot.saveToFile("bench_checkpoint.hss");
+    snapshot.loadFromFile("bench_checkpoint.hss");
+    const bool fileOk = restore(snapshot, sim);
+    sf::Int64 fileTime = fileTimer.getElapsedTime().asMicroseconds();
+    remove("bench_checkpoint.hss");
+
+    printf("%d enemies, %d projectiles, snapshot %zu bytes, %d iterations\n", enemyCount,
+            projectiles.size(), snapshot.size(), iterations);
+    report("save", saveTotal, saveBest, saveWorst, iterations);
+    report("restore", restoreTotal, restoreBest, restoreWorst, iterations);
+    printf("%-10s %8.3f ms (write, read and restore)\n", "file", fileTime / 1000.0);
+
+    const bool fast = saveTotal < 1000 * iterations && restoreTotal < 1000 * iterations;
+    printf("%s\n", fast && fileOk ? "PASS: save and restore under 1 ms" : "FAIL: over the 1 ms budget");
+    return fast && fileOk ? 0 : 1;
+}
@@ -0,0 +1,199 @@
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <execinfo.h>
+#include <unistd.h>
+
+#include "AllocTracker.h"
+
+// Everything is per thread and plain data, so the hooks never need a lock or an allocation
+static thread_local AllocPhase currentPhase = UpdatePhase;
+static thread_local AllocCounts frameCounts[AllocPhaseCount];
+static thread_local AllocCounts lastFrameCounts[AllocPhaseCount];
+
+// Totals since the last report
+static thread_local AllocCounts reportCounts[AllocPhaseCount];
+static thread_local int reportFrames = 0;
+static thread_local int reportAllocatingFrames = 0;
+
+// Name of the innermost NoAllocZone, or nullptr outside of one
+static thread_local const char *currentZone = nullptr;
+
+// Set while the hook itself is running, backtrace() can allocate the first time it's used
+static thread_local bool inHook = false;
+
+static int sampleEvery = 0;
+static thread_local int sampleCountdown = 0;
+
+static const char *phaseNames[AllocPhaseCount] = {"input", "update", "collisions", "draw"};
+
+// Writes the current stack straight to stderr, which doesn't allocate either
+static void printStack()
+{
+    void *frames[32];
+    const int depth = backtrace(frames, 32);
+
+    // Skip printStack and onAllocate themselves
+    backtrace_symbols_fd(frames + 2, depth - 2, STDERR_FILENO);
+}
+
+bool AllocTracker::isEnabled()
+{
+#ifdef ALLOC_TRACKING
+    return true;
+#else
+    return false;
+#endif
+}
+
+void AllocTracker::beginFrame()
+{
+    std::size_t allocations = 0;
+    for(int i = 0; i < AllocPhaseCount; i++)
+    {
+        allocations += frameCounts[i].allocations;
+        reportCounts[i].allocations += frameCounts[i].allocations;
+        reportCounts[i].bytes += frameCounts[i].bytes;
+        lastFrameCounts[i] = frameCounts[i];
+        frameCounts[i].allocations = 0;
+        frameCounts[i].bytes = 0;
+    }
+
+    reportFrames++;
+    reportAllocatingFrames += allocations > 0 ? 1 : 0;
+}
+
+void AllocTracker::printReport()
+{
+    if(reportFrames == 0)
+    {
+        return;
+    }
+
+    printf("Allocations per frame:");
+    for(int i = 0; i < AllocPhaseCount; i++)
+    {
+        printf(" %s %.1f (%.0f bytes)", phaseNames[i], (float)reportCounts[i].allocations / reportFrames,
+                (float)reportCounts[i].bytes / reportFrames);
+        reportCounts[i].allocations = 0;
+        reportCounts[i].bytes = 0;
+    }
+    printf(", %d of %d frames allocated\n", reportAllocatingFrames, reportFrames);
+
+    reportFrames = 0;
+    reportAllocatingFrames = 0;
+}
+
+AllocPhase AllocTracker::setPhase(AllocPhase phase)
+{
+    const AllocPhase previous = currentPhase;
+    currentPhase = phase;
+    return previous;
+}
+
+AllocCounts AllocTracker::getLastFrame(AllocPhase phase)
+{
+    return lastFrameCounts[phase];
+}
+
+const char* AllocTracker::getPhaseName(AllocPhase phase)
+{
+    return phaseNames[phase];
+}
+
+void AllocTracker::setSampling(int every)
+{
+    sampleEvery = every;
+}
+
+void AllocTracker::onAllocate(std::size_t size)
+{
+    if(inHook)
+    {
+        return;
+    }
+    inHook = true;
+
+    frameCounts[currentPhase].allocations++;
+    frameCounts[currentPhase].bytes += size;
+
+    if(currentZone != nullptr)
+    {
+        fprintf(stderr, "ERROR: %u byte allocation inside no-allocation zone %s!!\n", (unsigned)size, currentZone);
+        printStack();
+        assert(!"allocation inside a no-allocation zone");
+    }
+    else if(sampleEvery > 0 && --sampleCountdown <= 0)
+    {
+        sampleCountdown = sampleEvery;
+        fprintf(stderr, "%u byte allocation during %s:\n", (unsigned)size, phaseNames[currentPhase]);
+        printStack();
+    }
+
+    inHook = false;
+}
+
+NoAllocZone::NoAllocZone(const char *name) :
+    _previous(currentZone)
+{
+    currentZone = name;
+}
+
+NoAllocZone::~NoAllocZone()
+{
+    currentZone = _previous;
+}
+
+#ifdef ALLOC_TRACKING
+
+// Replacements for the global allocation functions, every other form of new and delete
+// ends up in one of these
+void* operator new(std::size_t size)
+{
+    AllocTracker::onAllocate(size);
+    void *data = malloc(size != 0 ? size : 1);
+    if(data == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return data;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    AllocTracker::onAllocate(size);
+    return malloc(size != 0 ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return operator new(size, std::nothrow);
+}
+
+void operator delete(void *data) noexcept
+{
+    free(data);
+}
+
+void operator delete[](void *data) noexcept
+{
+    free(data);
+}
+
+void operator delete(void *data, const std::nothrow_t&) noexcept
+{
+    free(data);
+}
+
+void operator delete[](void *data, const std::nothrow_t&) noexcept
+{
+    free(data);
+}
+
+#endif
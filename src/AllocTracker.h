@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+
+/** The parts of a frame allocations are counted against. */
+enum AllocPhase
+{
+    /** Polling events and reading the keyboard. */
+    InputPhase,
+    /** Moving the player and enemies, and anything else that isn't one of the others. */
+    UpdatePhase,
+    /** Building the grid and sweeping projectiles against it. */
+    CollisionPhase,
+    /** Building and drawing everything on screen. */
+    DrawPhase,
+    AllocPhaseCount
+};
+
+/** Allocations made during one phase of a frame. */
+struct AllocCounts
+{
+    std::size_t allocations;
+    std::size_t bytes;
+};
+
+/** Counts every heap allocation, by which phase of the frame made it.
+ *
+ * Only builds made with ALLOC_TRACKING defined (the default debug build) hook operator new
+ * and delete; everywhere else the counts stay at 0 and isEnabled() is false. Counts are
+ * kept per thread, so the batch simulator's workers don't share them.
+ *
+ * Code that must not allocate once the game is running can be wrapped in a NoAllocZone.
+ * An allocation inside one prints the zone and where it came from, then asserts.
+ * setSampling() prints where every so many of the other allocations come from too, to
+ * track down what's allocating in the first place.
+ */
+class AllocTracker
+{
+    public:
+        /**
+         * @brief Checks if allocations are being counted at all
+         *
+         * @return true in ALLOC_TRACKING builds
+         */
+        static bool isEnabled();
+
+        /**
+         * @brief Starts counting a new frame, the counts so far become the last frame's
+         */
+        static void beginFrame();
+
+        /**
+         * @brief Prints what each phase allocated per frame on average since the last report,
+         *  and how many of those frames allocated at all
+         */
+        static void printReport();
+
+        /**
+         * @brief Counts allocations from now on against a phase
+         *
+         * @param phase The phase that's starting
+         *
+         * @return The phase that was being counted, to go back to afterwards
+         */
+        static AllocPhase setPhase(AllocPhase phase);
+
+        /**
+         * @brief Getter for what a phase allocated during the last frame
+         *
+         * @param phase Which phase
+         *
+         * @return Allocations and bytes
+         */
+        static AllocCounts getLastFrame(AllocPhase phase);
+
+        /**
+         * @brief Getter for the name of a phase, for printing
+         *
+         * @param phase Which phase
+         *
+         * @return The name
+         */
+        static const char* getPhaseName(AllocPhase phase);
+
+        /**
+         * @brief Prints the stack of every so many allocations, to find out where they come from
+         *
+         * @param every Print one in this many, 0 turns it off
+         */
+        static void setSampling(int every);
+
+        /**
+         * @brief Called by the operator new hook for every allocation
+         *
+         * @param size Bytes asked for
+         */
+        static void onAllocate(std::size_t size);
+};
+
+/** Marks code that mustn't allocate for as long as this is alive.
+ *
+ * Zones can nest, the innermost one is the one named when something allocates.
+ */
+class NoAllocZone
+{
+    public:
+        /**
+         * @brief Starts the zone
+         *
+         * @param name What to call the zone when something in it allocates, must outlive it
+         */
+        explicit NoAllocZone(const char *name);
+
+        ~NoAllocZone();
+
+    private:
+        const char *_previous;
+
+        NoAllocZone(const NoAllocZone&);
+        NoAllocZone& operator=(const NoAllocZone&);
+};
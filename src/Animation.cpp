@@ -0,0 +1,159 @@
+#include <cstdio>
+#include <sstream>
+
+#include "Animation.h"
+#include "AssetArchive.h"
+
+AnimationLibrary::AnimationLibrary()
+{
+
+}
+
+bool AnimationLibrary::load(const std::string &path, TextureCache &textures)
+{
+    _clips.clear();
+    _frames.clear();
+
+    std::string text;
+    if(!readAsset(path, text))
+    {
+        printf("ERROR: animations can not be loaded from %s!!\n", path.c_str());
+        return false;
+    }
+
+    std::istringstream file(text);
+    std::string line;
+    int lineNumber = 0;
+    while(std::getline(file, line))
+    {
+        lineNumber++;
+
+        // Skip blank lines and comments
+        std::size_t start = line.find_first_not_of(" \t\r");
+        if(start == std::string::npos || line[start] == '#')
+        {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        AnimationClip clip;
+        std::string texturePath;
+        sf::IntRect rect;
+        int columns, loop;
+        float fps;
+
+        if(!(fields >> clip.name >> texturePath >> rect.left >> rect.top >> rect.width >> rect.height
+                >> clip.frameCount >> columns >> fps >> loop) || clip.frameCount < 1 || columns < 1 || fps <= 0)
+        {
+            printf("ERROR: %s:%d is not a valid animation clip!!\n", path.c_str(), lineNumber);
+            continue;
+        }
+        clip.frameTime = 1.0f / fps;
+        clip.loop = loop != 0;
+
+        // Frames run left to right from the first one, wrapping onto the next row every
+        // few columns. Each becomes its own sprite now so playing it never touches rects.
+        const int texture = textures.load(texturePath);
+        clip.firstFrame = (int)_frames.size();
+        for(int i = 0; i < clip.frameCount; i++)
+        {
+            sf::IntRect frame(rect.left + (i % columns) * rect.width, rect.top + (i / columns) * rect.height,
+                    rect.width, rect.height);
+            _frames.push_back((std::uint16_t)textures.addSprite(texture, frame));
+        }
+        _clips.push_back(clip);
+    }
+
+    return true;
+}
+
+int AnimationLibrary::addStill(const std::string &name, int sprite)
+{
+    AnimationClip clip;
+    clip.name = name;
+    clip.firstFrame = (int)_frames.size();
+    clip.frameCount = 1;
+    clip.frameTime = 1;
+    clip.loop = true;
+
+    _frames.push_back((std::uint16_t)sprite);
+    _clips.push_back(clip);
+    return (int)_clips.size() - 1;
+}
+
+int AnimationLibrary::find(const std::string &name) const
+{
+    for(std::size_t i = 0; i < _clips.size(); i++)
+    {
+        if(_clips[i].name == name)
+        {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+const AnimationClip& AnimationLibrary::get(int index) const
+{
+    return _clips.at(index);
+}
+
+std::uint16_t AnimationLibrary::getSprite(int clip, int frame) const
+{
+    return _frames[_clips[clip].firstFrame + frame];
+}
+
+int AnimationLibrary::size() const
+{
+    return (int)_clips.size();
+}
+
+void playAnimation(EntityWorld &world, EntityId id, const AnimationLibrary &animations, int clip,
+        bool restart)
+{
+    Animation *animation = world.get<Animation>(id);
+    if(animation == nullptr || (animation->clip == clip && !restart))
+    {
+        return;
+    }
+
+    animation->clip = (std::uint16_t)clip;
+    animation->frame = 0;
+    animation->time = 0;
+    animation->finished = false;
+    world.get<SpriteRef>(id)->sprite = animations.getSprite(clip, 0);
+}
+
+void updateAnimations(EntityWorld &world, const AnimationLibrary &animations, float deltaTime)
+{
+    world.eachBatch<Animation, SpriteRef>([&animations, deltaTime](std::size_t count, const EntityId *ids,
+            Animation *animation, SpriteRef *sprite)
+    {
+        for(std::size_t i = 0; i < count; i++)
+        {
+            Animation &current = animation[i];
+            const AnimationClip &clip = animations.get(current.clip);
+
+            // A long frame can skip more than one frame of the clip
+            current.time += deltaTime;
+            while(current.time >= clip.frameTime && !current.finished)
+            {
+                current.time -= clip.frameTime;
+                if(current.frame + 1 < clip.frameCount)
+                {
+                    current.frame++;
+                }
+                else if(clip.loop)
+                {
+                    current.frame = 0;
+                }
+                else
+                {
+                    current.finished = true;
+                }
+            }
+
+            sprite[i].sprite = animations.getSprite(current.clip, current.frame);
+        }
+    });
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Entity.h"
+#include "TextureCache.h"
+
+/** One animation, a run of frames played back at a fixed rate. */
+struct AnimationClip
+{
+    std::string name;
+
+    /** Where the clip's frames start in AnimationLibrary's frame table, and how many there are */
+    int firstFrame;
+    int frameCount;
+
+    /** Seconds each frame is shown for */
+    float frameTime;
+
+    /** Whether it starts over once it reaches the end, otherwise it holds the last frame */
+    bool loop;
+};
+
+/** Component holding which clip an entity is playing and how far into it it is.
+ *
+ * updateAnimations() points the entity's SpriteRef at the current frame, so SpriteBatch
+ * draws it the same way as any other sprite.
+ */
+struct Animation
+{
+    /** Index of the clip in the AnimationLibrary */
+    std::uint16_t clip;
+
+    /** Frame of the clip being shown */
+    std::uint16_t frame;
+
+    /** Time spent on the current frame, in seconds */
+    float time;
+
+    /** Set once a clip that doesn't loop has shown its last frame for its full time */
+    bool finished;
+};
+
+template<> struct ComponentInfo<Animation> { enum { id = AnimationComponent }; };
+
+/** Class which holds every animation clip.
+ *
+ * Clips are read once from a data file. Every frame of every clip is defined as a sprite
+ * in the TextureCache while loading, so the frame table is just sprite indices and playing
+ * an animation never works out a texture rect again.
+ */
+class AnimationLibrary
+{
+    public:
+        AnimationLibrary();
+
+        /**
+         * @brief Reads the clip definitions from a file
+         *
+         *  Each non-comment line is:
+         *  name texture x y w h frames columns fps loop
+         *  If a clip can't be read it's skipped, find() then won't find it.
+         *
+         * @param path Path of the definition file
+         * @param textures Where the spritesheets get loaded into and the frames defined
+         *
+         * @return true if the file was read
+         */
+        bool load(const std::string &path, TextureCache &textures);
+
+        /**
+         * @brief Adds a clip made of a single sprite, for things that aren't animated yet
+         *
+         * @param name Name of the clip
+         * @param sprite Index of the sprite in the TextureCache
+         *
+         * @return Index of the new clip
+         */
+        int addStill(const std::string &name, int sprite);
+
+        /**
+         * @brief Finds a clip by name
+         *
+         * @param name Name of the clip
+         *
+         * @return Index of the clip, or -1 if there isn't one with that name
+         */
+        int find(const std::string &name) const;
+
+        /**
+         * @brief Getter for a clip
+         *
+         * @param index Index of the clip
+         *
+         * @return The clip
+         */
+        const AnimationClip& get(int index) const;
+
+        /**
+         * @brief Getter for the sprite of a frame
+         *
+         * @param clip Index of the clip
+         * @param frame Frame of the clip
+         *
+         * @return Index of the sprite in the TextureCache
+         */
+        std::uint16_t getSprite(int clip, int frame) const;
+
+        /**
+         * @brief Getter for the number of clips
+         *
+         * @return Number of clips
+         */
+        int size() const;
+
+    private:
+        std::vector<AnimationClip> _clips;
+
+        /** Sprite index of every frame, each clip's frames next to each other */
+        std::vector<std::uint16_t> _frames;
+};
+
+/**
+ * @brief Starts an entity playing a clip
+ *
+ * @param world The world the entity lives in
+ * @param id The entity, it needs an Animation and a SpriteRef
+ * @param animations The clips
+ * @param clip Index of the clip to play
+ * @param restart true to start the clip over if it's already playing, otherwise it carries on
+ */
+void playAnimation(EntityWorld &world, EntityId id, const AnimationLibrary &animations, int clip,
+        bool restart = false);
+
+/**
+ * @brief Called from GameSimulation, moves every animation on and points each entity's
+ *  SpriteRef at its current frame
+ *
+ * @param world The world to update
+ * @param animations The clips the entities are playing
+ * @param deltaTime The time between this update and the previous update
+ */
+void updateAnimations(EntityWorld &world, const AnimationLibrary &animations, float deltaTime);
@@ -0,0 +1,261 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "AssetArchive.h"
+
+// Layout of an archive, every number is little endian:
+//   "HSPK", version, file count, index bytes      (4 x 4 bytes)
+//   per file: offset, size, hash (3 x 8 bytes), name length (4 bytes), name
+//   the contents of each file, starting on 16 byte boundaries
+static const char archiveMagic[4] = {'H', 'S', 'P', 'K'};
+static const std::uint32_t archiveVersion = 1;
+static const std::size_t headerSize = 16;
+static const std::size_t entryHeaderSize = 28;
+static const std::size_t contentAlign = 16;
+
+// The archive every loader looks in, see AssetArchive::mount()
+static AssetArchive mounted;
+
+template<typename T>
+static void appendValue(std::vector<char> &out, T value)
+{
+    const char *bytes = (const char*)&value;
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+template<typename T>
+static bool readValue(const char *data, std::size_t size, std::size_t &cursor, T &value)
+{
+    if(cursor + sizeof(T) > size)
+    {
+        return false;
+    }
+    memcpy(&value, data + cursor, sizeof(T));
+    cursor += sizeof(T);
+    return true;
+}
+
+AssetArchive::AssetArchive() :
+    _data(nullptr),
+    _size(0)
+{
+
+}
+
+AssetArchive::~AssetArchive()
+{
+    close();
+}
+
+bool AssetArchive::open(const std::string &path)
+{
+    close();
+
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+    {
+        return false;
+    }
+
+    struct stat info;
+    void *mapping = MAP_FAILED;
+    if(fstat(fd, &info) == 0 && info.st_size >= (off_t)headerSize)
+    {
+        mapping = mmap(nullptr, (std::size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+
+    // The mapping holds its own reference to the file
+    ::close(fd);
+    if(mapping == MAP_FAILED)
+    {
+        printf("ERROR: asset archive %s can not be mapped!!\n", path.c_str());
+        return false;
+    }
+    _data = (const char*)mapping;
+    _size = (std::size_t)info.st_size;
+
+    std::size_t cursor = sizeof(archiveMagic);
+    std::uint32_t version = 0, count = 0, indexSize = 0;
+    bool valid = memcmp(_data, archiveMagic, sizeof(archiveMagic)) == 0
+        && readValue(_data, _size, cursor, version) && version == archiveVersion
+        && readValue(_data, _size, cursor, count)
+        && readValue(_data, _size, cursor, indexSize) && headerSize + indexSize <= _size
+        // Checked before anything is sized by the count, every entry takes at least its numbers
+        && (std::uint64_t)count * entryHeaderSize <= indexSize;
+
+    _entries.resize(valid ? count : 0);
+    for(std::uint32_t i = 0; i < count && valid; i++)
+    {
+        Entry &entry = _entries[i];
+        std::uint32_t nameLength;
+        valid = readValue(_data, _size, cursor, entry.offset) && readValue(_data, _size, cursor, entry.size)
+            && readValue(_data, _size, cursor, entry.hash) && readValue(_data, _size, cursor, nameLength)
+            && cursor + nameLength <= _size && entry.offset <= _size && entry.size <= _size - entry.offset;
+        if(valid)
+        {
+            entry.name.assign(_data + cursor, nameLength);
+            cursor += nameLength;
+        }
+    }
+
+    if(!valid)
+    {
+        printf("ERROR: %s is not a valid asset archive!!\n", path.c_str());
+        close();
+        return false;
+    }
+
+    std::sort(_entries.begin(), _entries.end(), [](const Entry &lhs, const Entry &rhs)
+    {
+        return lhs.name < rhs.name;
+    });
+    return true;
+}
+
+void AssetArchive::close()
+{
+    if(_data != nullptr)
+    {
+        munmap((void*)_data, _size);
+    }
+    _data = nullptr;
+    _size = 0;
+    _entries.clear();
+}
+
+bool AssetArchive::verify() const
+{
+    for(std::size_t i = 0; i < _entries.size(); i++)
+    {
+        const Entry &entry = _entries[i];
+        if(hash(_data + entry.offset, (std::size_t)entry.size) != entry.hash)
+        {
+            printf("ERROR: %s is corrupt in the asset archive!!\n", entry.name.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+bool AssetArchive::find(const std::string &name, AssetData &asset) const
+{
+    std::vector<Entry>::const_iterator it = std::lower_bound(_entries.begin(), _entries.end(), name,
+            [](const Entry &entry, const std::string &key)
+    {
+        return entry.name < key;
+    });
+    if(it == _entries.end() || it->name != name)
+    {
+        return false;
+    }
+
+    asset.data = _data + it->offset;
+    asset.size = (std::size_t)it->size;
+    return true;
+}
+
+int AssetArchive::size() const
+{
+    return (int)_entries.size();
+}
+
+bool AssetArchive::pack(const std::string &path, const std::vector<std::string> &files)
+{
+    std::vector<std::vector<char> > contents(files.size());
+    std::size_t indexSize = 0;
+    for(std::size_t i = 0; i < files.size(); i++)
+    {
+        std::ifstream file(files[i].c_str(), std::ios::binary);
+        if(!file)
+        {
+            printf("ERROR: %s can not be packed!!\n", files[i].c_str());
+            return false;
+        }
+        contents[i].assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        indexSize += 3 * sizeof(std::uint64_t) + sizeof(std::uint32_t) + files[i].size();
+    }
+
+    // Lay the contents out after the index first, so the index can say where they are
+    std::vector<std::uint64_t> offsets(files.size());
+    std::size_t offset = headerSize + indexSize;
+    for(std::size_t i = 0; i < files.size(); i++)
+    {
+        offset = (offset + contentAlign - 1) & ~(contentAlign - 1);
+        offsets[i] = offset;
+        offset += contents[i].size();
+    }
+
+    std::vector<char> out;
+    out.reserve(offset);
+    out.insert(out.end(), archiveMagic, archiveMagic + sizeof(archiveMagic));
+    appendValue(out, archiveVersion);
+    appendValue(out, (std::uint32_t)files.size());
+    appendValue(out, (std::uint32_t)indexSize);
+    for(std::size_t i = 0; i < files.size(); i++)
+    {
+        appendValue(out, offsets[i]);
+        appendValue(out, (std::uint64_t)contents[i].size());
+        appendValue(out, hash(contents[i].data(), contents[i].size()));
+        appendValue(out, (std::uint32_t)files[i].size());
+        out.insert(out.end(), files[i].begin(), files[i].end());
+    }
+    for(std::size_t i = 0; i < files.size(); i++)
+    {
+        out.resize(offsets[i], 0);
+        out.insert(out.end(), contents[i].begin(), contents[i].end());
+    }
+
+    std::ofstream file(path.c_str(), std::ios::binary | std::ios::trunc);
+    if(!file.write(out.data(), out.size()))
+    {
+        printf("ERROR: asset archive %s can not be written!!\n", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+std::uint64_t AssetArchive::hash(const void *data, std::size_t size)
+{
+    const unsigned char *bytes = (const unsigned char*)data;
+    std::uint64_t result = 14695981039346656037ULL;
+    for(std::size_t i = 0; i < size; i++)
+    {
+        result = (result ^ bytes[i]) * 1099511628211ULL;
+    }
+    return result;
+}
+
+bool AssetArchive::mount(const std::string &path)
+{
+    return mounted.open(path);
+}
+
+const AssetArchive& AssetArchive::getMounted()
+{
+    return mounted;
+}
+
+bool readAsset(const std::string &path, std::string &text)
+{
+    AssetData asset;
+    if(AssetArchive::getMounted().find(path, asset))
+    {
+        text.assign((const char*)asset.data, asset.size);
+        return true;
+    }
+
+    std::ifstream file(path.c_str(), std::ios::binary);
+    if(!file)
+    {
+        return false;
+    }
+    text.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/** Where one file's contents are inside a mapped AssetArchive. */
+struct AssetData
+{
+    const void *data;
+    std::size_t size;
+};
+
+/** Class which reads every asset out of one packed file mapped into memory.
+ *
+ * The archive is a header, an index of every file's name, offset, size and content hash,
+ * then the contents one after another. Opening it maps the whole file and reads the index,
+ * after which finding a file is a binary search and its contents are used in place, with no
+ * more opens or reads. The mapping lives until close(), so fonts loaded from memory (which
+ * read from it for as long as they're used) stay valid.
+ *
+ * Files are named by the relative path they have in the repo, like
+ * "assets/textures/test.png", so the loaders below find them by the same path they'd open
+ * as a loose file. The archive is built by tools/AssetPack.cpp with make pack.
+ */
+class AssetArchive
+{
+    public:
+        AssetArchive();
+        ~AssetArchive();
+
+        /**
+         * @brief Maps an archive and reads its index
+         *
+         * @param path Path of the archive
+         *
+         * @return false if it can't be mapped or isn't a valid archive, it's then left closed
+         */
+        bool open(const std::string &path);
+
+        /**
+         * @brief Unmaps the archive, anything still using its contents mustn't be used after
+         */
+        void close();
+
+        /**
+         * @brief Checks every file's contents against the hash in the index
+         *
+         * @return true if they all match
+         */
+        bool verify() const;
+
+        /**
+         * @brief Finds a file
+         *
+         * @param name Path the file was packed as
+         * @param asset Set to where its contents are
+         *
+         * @return false if the archive doesn't have it
+         */
+        bool find(const std::string &name, AssetData &asset) const;
+
+        /**
+         * @brief Getter for the number of files
+         *
+         * @return Number of files in the index
+         */
+        int size() const;
+
+        /**
+         * @brief Writes an archive of some files
+         *
+         * @param path Where to write the archive
+         * @param files Paths of the files to pack, they're named by these paths
+         *
+         * @return false if a file can't be read or the archive can't be written
+         */
+        static bool pack(const std::string &path, const std::vector<std::string> &files);
+
+        /**
+         * @brief Hashes some bytes the way the index does (64 bit FNV-1a)
+         *
+         * @param data The bytes
+         * @param size How many
+         *
+         * @return The hash
+         */
+        static std::uint64_t hash(const void *data, std::size_t size);
+
+        /**
+         * @brief Opens the archive every loadAsset() and readAsset() call looks in first
+         *
+         * @param path Path of the archive
+         *
+         * @return false if it can't be opened, assets are then loaded as loose files
+         */
+        static bool mount(const std::string &path);
+
+        /**
+         * @brief Getter for the archive opened with mount()
+         *
+         * @return The archive, closed if nothing was mounted
+         */
+        static const AssetArchive& getMounted();
+
+    private:
+        /** One file in the index */
+        struct Entry
+        {
+            std::string name;
+            std::uint64_t offset;
+            std::uint64_t size;
+            std::uint64_t hash;
+        };
+
+        /** The mapping, or nullptr when closed */
+        const char *_data;
+        std::size_t _size;
+
+        /** Sorted by name */
+        std::vector<Entry> _entries;
+
+        AssetArchive(const AssetArchive&);
+        AssetArchive& operator=(const AssetArchive&);
+};
+
+/**
+ * @brief Reads an asset from the mounted archive, or from the loose file if it isn't in it
+ *
+ * @param path Path of the asset
+ * @param text Set to the contents of the file
+ *
+ * @return false if it can't be found either way
+ */
+bool readAsset(const std::string &path, std::string &text);
+
+/**
+ * @brief Loads an SFML resource (texture, image or font) from the mounted archive, or from the
+ *  loose file if it isn't in it
+ *
+ * @param resource What to load into
+ * @param path Path of the asset
+ *
+ * @return false if it can't be loaded either way
+ */
+template<typename T>
+bool loadAsset(T &resource, const std::string &path)
+{
+    AssetData asset;
+    if(AssetArchive::getMounted().find(path, asset))
+    {
+        return resource.loadFromMemory(asset.data, asset.size);
+    }
+    return resource.loadFromFile(path);
+}
@@ -0,0 +1,67 @@
+#include <cmath>
+
+#include "AutoPlayer.h"
+#include "Enemy.h"
+
+// Ticks between attacks, 4 a second at 60 ticks a second
+static const int attackInterval = 15;
+
+AutoPlayer::AutoPlayer() :
+    _cooldown(0),
+    _lastHealth(-1)
+{
+
+}
+
+PlayerInput AutoPlayer::think(GameSimulation &sim)
+{
+    PlayerInput input = {sf::Vector2<float>(0, 0), false, false};
+    Player &player = sim.getPlayer();
+    if(!player.isAlive())
+    {
+        return input;
+    }
+    const sf::Vector2<float> position = player.getPosition();
+
+    // Find the nearest living enemy
+    float nearestDistance = -1;
+    sf::Vector2<float> nearest;
+    sim.getWorld().eachBatch<Transform, Health, EnemyBrain>([&](std::size_t count,
+            const EntityId *ids, Transform *transform, Health *health, EnemyBrain *brain)
+    {
+        for(std::size_t i = 0; i < count; i++)
+        {
+            if(!health[i].alive)
+                continue;
+
+            const sf::Vector2<float> offset = transform[i].position - position;
+            const float distance = offset.x * offset.x + offset.y * offset.y;
+            if(nearestDistance < 0 || distance < nearestDistance)
+            {
+                nearestDistance = distance;
+                nearest = offset;
+            }
+        }
+    });
+
+    if(nearestDistance >= 0)
+    {
+        // Always diagonal, the attack only reaches along both axes at once
+        input.move = sf::Vector2<float>(nearest.x < 0 ? -1 : 1, nearest.y < 0 ? -1 : 1);
+
+        const float range = player.getAttackRange();
+        if(_cooldown <= 0 && std::abs(nearest.x) < range && std::abs(nearest.y) < range)
+        {
+            input.attack = true;
+            _cooldown = attackInterval;
+        }
+    }
+    _cooldown--;
+
+    // Dodge out of whatever just hit us
+    const int health = player.getHealth();
+    input.dodge = _lastHealth >= 0 && health < _lastHealth && !player.isDodging();
+    _lastHealth = health;
+
+    return input;
+}
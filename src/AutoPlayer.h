@@ -0,0 +1,32 @@
+#pragma once
+
+#include "GameSimulation.h"
+
+/** Scripted stand-in for a human player, for running games with nobody at the keyboard.
+ *
+ * It walks diagonally at the nearest living enemy, since that's the direction attacks
+ * reach furthest, swings whenever one is in range, and dodges when it gets hit. It only
+ * swings a few times a second, about as fast as someone can press the key. Nothing it
+ * does is random, so the same seed always plays out the same way.
+ */
+class AutoPlayer
+{
+    public:
+        AutoPlayer();
+
+        /**
+         * @brief Works out what to do this tick
+         *
+         * @param sim The game being played
+         *
+         * @return The input to hand to GameSimulation::applyInput()
+         */
+        PlayerInput think(GameSimulation &sim);
+
+    private:
+        /** Ticks until the next attack is allowed */
+        int _cooldown;
+
+        /** Player health at the last tick, to notice being hit */
+        int _lastHealth;
+};
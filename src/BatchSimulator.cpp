@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <SFML/System.hpp>
+
+#include "BatchSimulator.h"
+#include "GameSimulation.h"
+#include "AutoPlayer.h"
+
+// Game time per tick, the same rate the server runs at
+static const float tickTime = 1.0f / 60.0f;
+
+// A wave that takes longer than this is called off, so a stuck run can't hold up the batch
+static const float waveTimeLimit = 300.0f;
+
+BatchSimulator::BatchSimulator(int runs, int waves, std::uint32_t firstSeed) :
+    _runs(runs),
+    _waves(waves),
+    _firstSeed(firstSeed)
+{
+
+}
+
+void BatchSimulator::run(int threads)
+{
+    if(threads <= 0)
+    {
+        threads = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+
+    WaveResult empty = {0, 0, 0, false, 0, 0, 0};
+    this->_results.assign((std::size_t)_runs * _waves, empty);
+
+    // Workers take the next run off a shared counter, so a long run doesn't leave the others idle
+    std::atomic<int> next(0);
+    std::vector<std::thread> workers;
+    for(int i = 0; i < threads; i++)
+    {
+        workers.push_back(std::thread([this, &next]()
+        {
+            for(int index = next++; index < _runs; index = next++)
+            {
+                playRun(index);
+            }
+        }));
+    }
+    for(std::size_t i = 0; i < workers.size(); i++)
+    {
+        workers[i].join();
+    }
+}
+
+void BatchSimulator::playRun(int index)
+{
+    const std::uint32_t seed = _firstSeed + (std::uint32_t)index;
+    GameSimulation sim(true, seed);
+    AutoPlayer bot;
+    WaveManager &wave = sim.getWave();
+    Player &player = sim.getPlayer();
+
+    sim.start();
+    WaveResult *results = &this->_results[(std::size_t)index * _waves];
+    for(int w = 0; w < _waves && player.isAlive(); w++)
+    {
+        WaveResult &result = results[w];
+        result.seed = seed;
+        result.wave = wave.getWave();
+        result.enemies = wave.getEnemies();
+
+        const int startHealth = player.getHealth();
+        int ticks = 0;
+        sf::Clock clock;
+
+        // The wave manager starts the next wave by itself once this one is cleared
+        while(wave.getWave() == result.wave && player.isAlive() && ticks * tickTime < waveTimeLimit)
+        {
+            sim.applyInput(bot.think(sim));
+            sim.step(tickTime);
+            ticks++;
+        }
+
+        const float elapsed = clock.getElapsedTime().asSeconds();
+        result.survived = wave.getWave() != result.wave;
+        result.seconds = ticks * tickTime;
+        result.damageTaken = startHealth - std::max(0, player.getHealth());
+        result.ticksPerSecond = elapsed > 0 ? ticks / elapsed : 0;
+    }
+}
+
+bool BatchSimulator::writeCsv(const std::string &path) const
+{
+    FILE *file = path == "-" ? stdout : fopen(path.c_str(), "w");
+    if(file == nullptr)
+    {
+        printf("ERROR: %s can not be written!!\n", path.c_str());
+        return false;
+    }
+
+    fprintf(file, "seed,wave,enemies,survived,seconds,damage_taken,ticks_per_second\n");
+    for(std::size_t i = 0; i < this->_results.size(); i++)
+    {
+        const WaveResult &result = this->_results[i];
+        if(result.wave == 0)
+        {
+            continue;
+        }
+        fprintf(file, "%u,%d,%d,%d,%.3f,%d,%.0f\n", result.seed, result.wave, result.enemies,
+                result.survived ? 1 : 0, result.seconds, result.damageTaken, result.ticksPerSecond);
+    }
+
+    if(file != stdout)
+    {
+        fclose(file);
+    }
+    return true;
+}
+
+const std::vector<WaveResult>& BatchSimulator::getResults() const
+{
+    return this->_results;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/** What happened to the player during one wave of one run. */
+struct WaveResult
+{
+    /** Seed the run was played with */
+    std::uint32_t seed;
+
+    /** Wave number, starting at 1 */
+    int wave;
+
+    /** Enemies the wave spawned with */
+    int enemies;
+
+    /** Whether the player cleared the wave */
+    bool survived;
+
+    /** Game time spent in the wave, until it was cleared, the player died or time ran out */
+    float seconds;
+
+    /** Health the player lost during the wave */
+    int damageTaken;
+
+    /** Simulation speed during the wave, in ticks per second of real time */
+    float ticksPerSecond;
+};
+
+/** Plays lots of games with nobody watching, for balancing the waves.
+ *
+ * Every run is its own seeded GameSimulation played by an AutoPlayer, stepped as fast as it
+ * will go at a fixed 60 ticks a second of game time. Runs are shared out between worker
+ * threads; each one only touches its own simulation and its own slots of the results, so
+ * the threads never wait on each other. The results come out in seed order, the same
+ * whatever the number of threads.
+ */
+class BatchSimulator
+{
+    public:
+        /**
+         * @brief Sets up a batch, nothing runs until run() is called
+         *
+         * @param runs How many games to play
+         * @param waves How many waves each game is played for, at most
+         * @param firstSeed Seed of the first run, each one after counts up from it
+         */
+        BatchSimulator(int runs, int waves, std::uint32_t firstSeed);
+
+        /**
+         * @brief Plays every run
+         *
+         * @param threads How many worker threads to use, 0 for one per core
+         */
+        void run(int threads);
+
+        /**
+         * @brief Writes the results as CSV, one row per wave that was reached
+         *
+         * @param path File to write to, or "-" for stdout
+         *
+         * @return false if the file can't be written
+         */
+        bool writeCsv(const std::string &path) const;
+
+        /**
+         * @brief Getter for the results of the last run()
+         *
+         * @return Every wave of every run, runs in seed order
+         */
+        const std::vector<WaveResult>& getResults() const;
+
+    private:
+        int _runs;
+        int _waves;
+        std::uint32_t _firstSeed;
+
+        /** _waves slots per run, waves that were never reached have wave set to 0 */
+        std::vector<WaveResult> _results;
+
+        /**
+         * @brief Plays a single run
+         *
+         * @param index Which run, picks the seed and the slots the results go in
+         */
+        void playRun(int index);
+};
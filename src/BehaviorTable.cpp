@@ -0,0 +1,216 @@
+#include <cstdio>
+#include <sstream>
+
+#include "BehaviorTable.h"
+#include "AssetArchive.h"
+
+// Names used for actions and conditions in the definition file, in enum order
+static const char *actionNames[BehaviorActionCount] = {"chase", "windup", "strike"};
+static const char *conditionNames[BehaviorConditionCount] = {"nexttick", "inrange", "windupdone"};
+
+// A state as it's read, before its targets are turned into indices
+struct StateDef
+{
+    std::string name;
+    int action;
+    std::vector<int> conditions;
+    std::vector<std::string> targets;
+    int lineNumber;
+};
+
+static int findName(const char **names, int count, const std::string &name)
+{
+    for(int i = 0; i < count; i++)
+    {
+        if(name == names[i])
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void BehaviorGroups::reserve(std::size_t enemies, std::size_t states)
+{
+    rows.reserve(enemies);
+    start.reserve(states + 1);
+}
+
+BehaviorTable::BehaviorTable()
+{
+    useFighter();
+}
+
+bool BehaviorTable::load(const std::string &path)
+{
+    _names.clear();
+    _startStates.clear();
+    _actions.clear();
+    _firstTransition.assign(1, 0);
+    _transitions.clear();
+
+    std::string text;
+    readAsset(path, text);
+    std::istringstream file(text);
+    std::string line;
+    int lineNumber = 0;
+
+    // States are collected until the behavior ends, since transitions can name later states
+    std::string behavior;
+    std::vector<StateDef> states;
+    bool valid = true;
+    bool done = false;
+    while(!done)
+    {
+        std::string keyword;
+        std::istringstream fields;
+        done = !std::getline(file, line);
+        if(!done)
+        {
+            lineNumber++;
+
+            // Skip blank lines and comments
+            std::size_t start = line.find_first_not_of(" \t\r");
+            if(start == std::string::npos || line[start] == '#')
+            {
+                continue;
+            }
+            fields.str(line);
+            fields >> keyword;
+        }
+
+        if(keyword == "state")
+        {
+            StateDef state;
+            std::string action, condition, target;
+            state.lineNumber = lineNumber;
+            fields >> state.name >> action;
+            state.action = findName(actionNames, BehaviorActionCount, action);
+            while(fields >> condition >> target)
+            {
+                state.conditions.push_back(findName(conditionNames, BehaviorConditionCount, condition));
+                state.targets.push_back(target);
+            }
+            if(behavior.empty() || state.name.empty() || state.action < 0)
+            {
+                printf("ERROR: %s:%d is not a valid behavior state!!\n", path.c_str(), lineNumber);
+                valid = false;
+            }
+            states.push_back(state);
+            continue;
+        }
+        if(!done && keyword != "behavior")
+        {
+            printf("ERROR: %s:%d is not a behavior or a state!!\n", path.c_str(), lineNumber);
+            continue;
+        }
+
+        // A new behavior or the end of the file, so compile the one before it
+        const std::uint32_t firstState = (std::uint32_t)_actions.size();
+        for(std::size_t i = 0; i < states.size() && valid; i++)
+        {
+            _actions.push_back((std::uint8_t)states[i].action);
+            for(std::size_t j = 0; j < states[i].targets.size(); j++)
+            {
+                int target = -1;
+                for(std::size_t k = 0; k < states.size(); k++)
+                {
+                    target = states[k].name == states[i].targets[j] ? (int)k : target;
+                }
+                if(states[i].conditions[j] < 0 || target < 0)
+                {
+                    printf("ERROR: %s:%d has a transition that goes nowhere!!\n", path.c_str(),
+                            states[i].lineNumber);
+                    valid = false;
+                    break;
+                }
+                const BehaviorTransition transition = {(std::uint16_t)states[i].conditions[j],
+                    (std::uint16_t)(firstState + target)};
+                _transitions.push_back(transition);
+            }
+            _firstTransition.push_back((std::uint32_t)_transitions.size());
+        }
+
+        if(valid && !states.empty())
+        {
+            _names.push_back(behavior);
+            _startStates.push_back((std::uint16_t)firstState);
+        }
+        else
+        {
+            // Throw away whatever of the broken behavior made it in
+            if(!behavior.empty())
+            {
+                printf("ERROR: behavior %s can not be compiled!!\n", behavior.c_str());
+            }
+            _actions.resize(firstState);
+            _firstTransition.resize(firstState + 1);
+            _transitions.resize(_firstTransition.back());
+        }
+
+        behavior.clear();
+        fields >> behavior;
+        states.clear();
+        valid = true;
+    }
+
+    if(!_names.empty())
+    {
+        return true;
+    }
+
+    // Fall back to how enemies behaved before behaviors were data driven
+    printf("ERROR: enemy behaviors can not be loaded from %s!!\n", path.c_str());
+    useFighter();
+    return false;
+}
+
+void BehaviorTable::useFighter()
+{
+    _names.assign(1, "fighter");
+    _startStates.assign(1, 0);
+
+    const std::uint8_t actions[] = {ChaseAction, WindUpAction, StrikeAction};
+    _actions.assign(actions, actions + 3);
+
+    const BehaviorTransition transitions[] = {
+        {InRangeCondition, 1}, {WindUpDoneCondition, 2}, {NextTickCondition, 0}
+    };
+    _transitions.assign(transitions, transitions + 3);
+
+    const std::uint32_t firstTransition[] = {0, 1, 2, 3};
+    _firstTransition.assign(firstTransition, firstTransition + 4);
+}
+
+int BehaviorTable::find(const std::string &name) const
+{
+    for(std::size_t i = 0; i < _names.size(); i++)
+    {
+        if(_names[i] == name)
+        {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+std::uint16_t BehaviorTable::getStartState(int behavior) const
+{
+    return _startStates.at(behavior);
+}
+
+int BehaviorTable::getStateCount() const
+{
+    return (int)_actions.size();
+}
+
+BehaviorAction BehaviorTable::getAction(int state) const
+{
+    return (BehaviorAction)_actions[state];
+}
+
+const BehaviorTransition* BehaviorTable::getTransitions(int state, int &count) const
+{
+    count = (int)(_firstTransition[state + 1] - _firstTransition[state]);
+    return _transitions.data() + _firstTransition[state];
+}
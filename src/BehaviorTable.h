@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/** What an enemy does every tick it spends in a state. */
+enum BehaviorAction
+{
+    /** Head for the player, stopping short of other enemies in the way */
+    ChaseAction,
+    /** Stand still while the attack winds up */
+    WindUpAction,
+    /** Land the attack, a shot if it has ammo left and a hit otherwise */
+    StrikeAction,
+    BehaviorActionCount
+};
+
+/** What has to hold for an enemy to move on from a state. */
+enum BehaviorCondition
+{
+    /** The enemy was already in the state when the tick began, so its action has run once */
+    NextTickCondition,
+    /** The player is within attack range along both axes and not dodging */
+    InRangeCondition,
+    /** The wind-up finishes during this tick */
+    WindUpDoneCondition,
+    BehaviorConditionCount
+};
+
+/** A way out of a state. */
+struct BehaviorTransition
+{
+    std::uint16_t condition;
+
+    /** State to move to, an index into the whole table */
+    std::uint16_t target;
+};
+
+/** Scratch space enemies are sorted into their states with, kept between ticks. */
+struct BehaviorGroups
+{
+    /** Rows of the enemies in each state, state s has rows[start[s]] to rows[start[s + 1]] */
+    std::vector<std::uint32_t> rows;
+    std::vector<std::uint32_t> start;
+
+    /**
+     * @brief Makes room up front, so sorting enemies into groups doesn't allocate
+     *
+     * @param enemies Most enemies that will be sorted at once
+     * @param states Number of states in the BehaviorTable
+     */
+    void reserve(std::size_t enemies, std::size_t states);
+};
+
+/** Class which holds every enemy behavior, compiled into one flat state table.
+ *
+ * A behavior is a little state machine: each state has one action, and a list of
+ * transitions tried in order, the first whose condition holds wins. Behaviors are read once
+ * from a data file and their states all go in the same arrays, so a state is just an index.
+ * Enemies keep the index of the state they're in (see EnemyBrain), and Enemy::updateAll()
+ * runs each state's action over all the enemies in it at once.
+ */
+class BehaviorTable
+{
+    public:
+        BehaviorTable();
+
+        /**
+         * @brief Reads and compiles the behavior definitions from a file
+         *
+         *  A behavior starts with a "behavior name" line, each line after it until the next
+         *  one is a state: "state name action [condition target]...". Its first state is
+         *  where enemies start. If nothing can be read, a single behavior called fighter
+         *  that chases, winds up and strikes is used instead, the way enemies always have.
+         *
+         * @param path Path of the definition file
+         *
+         * @return true if the file was read
+         */
+        bool load(const std::string &path);
+
+        /**
+         * @brief Finds a behavior by name
+         *
+         * @param name Name of the behavior
+         *
+         * @return Index of the behavior, or -1 if there isn't one with that name
+         */
+        int find(const std::string &name) const;
+
+        /**
+         * @brief Getter for the state a behavior starts in
+         *
+         * @param behavior Index of the behavior
+         *
+         * @return Index of its first state
+         */
+        std::uint16_t getStartState(int behavior) const;
+
+        /**
+         * @brief Getter for the number of states of every behavior put together
+         *
+         * @return Number of states
+         */
+        int getStateCount() const;
+
+        /**
+         * @brief Getter for the action of a state
+         *
+         * @param state Index of the state
+         *
+         * @return What enemies in it do
+         */
+        BehaviorAction getAction(int state) const;
+
+        /**
+         * @brief Getter for the transitions of a state
+         *
+         * @param state Index of the state
+         * @param count Set to how many transitions it has
+         *
+         * @return The first of them, in the order they're tried
+         */
+        const BehaviorTransition* getTransitions(int state, int &count) const;
+
+    private:
+        /** Name and first state of each behavior */
+        std::vector<std::string> _names;
+        std::vector<std::uint16_t> _startStates;
+
+        /** Per state, its action and where its transitions start in _transitions */
+        std::vector<std::uint8_t> _actions;
+        std::vector<std::uint32_t> _firstTransition;
+        std::vector<BehaviorTransition> _transitions;
+
+        /**
+         * @brief Replaces the table with the single built in fighter behavior
+         */
+        void useFighter();
+};
@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <cmath>
+
+#include "Collision.h"
+#include "Entity.h"
+
+// How far short of a surface a swept body stops, so the next sweep doesn't start touching it
+static const float contactSkin = 0.01f;
+
+static float dot(const sf::Vector2<float> &lhs, const sf::Vector2<float> &rhs)
+{
+    return lhs.x * rhs.x + lhs.y * rhs.y;
+}
+
+bool sweepSegment(const sf::Vector2<float> &start, const sf::Vector2<float> &delta,
+        const sf::FloatRect &box, SweepHit &hit)
+{
+    float tEnter = 0;
+    float tExit = 1;
+    sf::Vector2<float> normal(0, 0);
+
+    const float starts[2] = {start.x, start.y};
+    const float deltas[2] = {delta.x, delta.y};
+    const float mins[2] = {box.left, box.top};
+    const float maxs[2] = {box.left + box.width, box.top + box.height};
+
+    // Clip the segment against the pair of planes on each axis
+    for(int axis = 0; axis < 2; axis++)
+    {
+        if(deltas[axis] == 0)
+        {
+            // Parallel to this slab, so we either always overlap it or never do
+            if(starts[axis] < mins[axis] || starts[axis] > maxs[axis])
+            {
+                return false;
+            }
+            continue;
+        }
+
+        float tNear = (mins[axis] - starts[axis]) / deltas[axis];
+        float tFar = (maxs[axis] - starts[axis]) / deltas[axis];
+        float side = -1;
+        if(tNear > tFar)
+        {
+            std::swap(tNear, tFar);
+            side = 1;
+        }
+
+        if(tNear > tEnter)
+        {
+            tEnter = tNear;
+            normal = axis == 0 ? sf::Vector2<float>(side, 0) : sf::Vector2<float>(0, side);
+        }
+        tExit = std::min(tExit, tFar);
+
+        if(tEnter > tExit)
+        {
+            return false;
+        }
+    }
+
+    hit.time = tEnter;
+    hit.normal = normal;
+    return true;
+}
+
+bool sweepBox(const sf::FloatRect &box, const sf::Vector2<float> &delta,
+        const sf::FloatRect &obstacle, SweepHit &hit)
+{
+    // Growing the obstacle by the size of the box turns this into sweeping its top left corner
+    const sf::FloatRect grown(obstacle.left - box.width, obstacle.top - box.height,
+            obstacle.width + box.width, obstacle.height + box.height);
+    return sweepSegment(sf::Vector2<float>(box.left, box.top), delta, grown, hit);
+}
+
+bool sweepInside(const sf::FloatRect &box, const sf::Vector2<float> &delta,
+        const sf::FloatRect &area, SweepHit &hit)
+{
+    const float mins[2] = {box.left, box.top};
+    const float maxs[2] = {box.left + box.width, box.top + box.height};
+    const float deltas[2] = {delta.x, delta.y};
+    const float areaMins[2] = {area.left, area.top};
+    const float areaMaxs[2] = {area.left + area.width, area.top + area.height};
+
+    bool found = false;
+    hit.time = 1;
+    for(int axis = 0; axis < 2; axis++)
+    {
+        float time;
+        float side;
+        if(deltas[axis] < 0 && mins[axis] + deltas[axis] < areaMins[axis])
+        {
+            time = (areaMins[axis] - mins[axis]) / deltas[axis];
+            side = 1;
+        }
+        else if(deltas[axis] > 0 && maxs[axis] + deltas[axis] > areaMaxs[axis])
+        {
+            time = (areaMaxs[axis] - maxs[axis]) / deltas[axis];
+            side = -1;
+        }
+        else
+        {
+            continue;
+        }
+
+        // Already past the edge, so no moving any further out
+        time = std::max(0.0f, time);
+        if(!found || time < hit.time)
+        {
+            hit.time = time;
+            hit.normal = axis == 0 ? sf::Vector2<float>(side, 0) : sf::Vector2<float>(0, side);
+            found = true;
+        }
+    }
+    return found;
+}
+
+void sweepBodies(EntityWorld &world, const SpatialGrid &grid, const sf::FloatRect &area, float deltaTime)
+{
+    world.eachBatch<Transform, Bounds, Health>([&grid, &area, deltaTime](std::size_t count,
+            const EntityId *ids, Transform *transform, Bounds *bounds, Health *health)
+    {
+        for(std::size_t i = 0; i < count; i++)
+        {
+            if(!health[i].alive)
+            {
+                continue;
+            }
+
+            sf::Vector2<float> &position = transform[i].position;
+            sf::Vector2<float> &velocity = transform[i].velocity;
+            const sf::Vector2<float> size((float)bounds[i].width, (float)bounds[i].height);
+            sf::FloatRect box(position.x - size.x / 2, position.y - size.y / 2, size.x, size.y);
+            sf::Vector2<float> remaining = velocity * deltaTime;
+
+            // Every hit uses up part of the move and slides the rest along the surface,
+            // going into a corner takes two
+            for(int pass = 0; pass < 3 && (remaining.x != 0 || remaining.y != 0); pass++)
+            {
+                SweepHit first;
+                bool blocked = sweepInside(box, remaining, area, first);
+
+                // Only enemies near the whole path can be in the way
+                const sf::FloatRect path(std::min(box.left, box.left + remaining.x),
+                        std::min(box.top, box.top + remaining.y),
+                        box.width + std::abs(remaining.x), box.height + std::abs(remaining.y));
+                grid.query(path, [&](EntityId id, const sf::FloatRect &other)
+                {
+                    // A hit with no normal means we started inside it, let it go
+                    SweepHit hit;
+                    if(sweepBox(box, remaining, other, hit) && (hit.normal.x != 0 || hit.normal.y != 0)
+                            && (!blocked || hit.time < first.time))
+                    {
+                        first = hit;
+                        blocked = true;
+                    }
+                });
+
+                if(!blocked)
+                {
+                    box.left += remaining.x;
+                    box.top += remaining.y;
+                    break;
+                }
+
+                // Move up to just short of the surface
+                const float length = std::sqrt(dot(remaining, remaining));
+                const float time = std::max(0.0f, first.time - contactSkin / length);
+                box.left += remaining.x * time;
+                box.top += remaining.y * time;
+
+                // Then drop the part of the move, and of the velocity, that goes into it
+                remaining *= 1 - first.time;
+                remaining -= first.normal * dot(remaining, first.normal);
+                const float into = dot(velocity, first.normal);
+                if(into < 0)
+                {
+                    velocity -= first.normal * into;
+                }
+            }
+
+            position = sf::Vector2<float>(box.left + size.x / 2, box.top + size.y / 2);
+        }
+    });
+}
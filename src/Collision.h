@@ -0,0 +1,75 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include "EntityWorld.h"
+#include "SpatialGrid.h"
+
+/** Result of sweeping something through a box. */
+struct SweepHit
+{
+    /** Fraction of the sweep (0 to 1) at which the box was first touched */
+    float time;
+
+    /** Normal of the face that was hit, <0, 0> if the sweep started inside the box */
+    sf::Vector2<float> normal;
+};
+
+/**
+ * @brief Sweeps a segment through an axis aligned box
+ *
+ *  Uses the slab method, so fast moving things can't skip over the box between frames
+ *  the way a test at just the end point would.
+ *
+ * @param start Where the segment starts
+ * @param delta How far the segment travels
+ * @param box The box to test against
+ * @param hit Filled in with the time and normal of the hit, if there is one
+ *
+ * @return true if the segment touches the box
+ */
+bool sweepSegment(const sf::Vector2<float> &start, const sf::Vector2<float> &delta,
+        const sf::FloatRect &box, SweepHit &hit);
+
+/**
+ * @brief Sweeps a moving box through a box that stays still
+ *
+ * @param box The moving box, where it starts
+ * @param delta How far the box travels
+ * @param obstacle The box to test against
+ * @param hit Filled in with the time and normal of the hit, if there is one
+ *
+ * @return true if the boxes touch at some point, including if they already overlap
+ */
+bool sweepBox(const sf::FloatRect &box, const sf::Vector2<float> &delta,
+        const sf::FloatRect &obstacle, SweepHit &hit);
+
+/**
+ * @brief Sweeps a box that has to stay inside an area, like the map
+ *
+ * @param box The moving box, where it starts
+ * @param delta How far the box travels
+ * @param area The area the box has to stay in
+ * @param hit Filled in with the time and normal of the first edge reached, if one is
+ *
+ * @return true if the box would leave the area. A box that's already partly outside is
+ *  hit at time 0, so it can only move back in.
+ */
+bool sweepInside(const sf::FloatRect &box, const sf::Vector2<float> &delta,
+        const sf::FloatRect &area, SweepHit &hit);
+
+/**
+ * @brief Called from GameSimulation, moves every living entity that has Bounds
+ *
+ *  Instead of jumping to where its velocity takes it, like integrateMotion() does, each one
+ *  is swept from where it is to where it's going. It stops where it first touches an enemy
+ *  or the edge of the area, then slides along that surface for the rest of the move. So
+ *  however fast it goes or however long the frame is, it can't pass through anything.
+ *  Enemies it already overlaps are ignored, so it can always get away from them.
+ *
+ * @param world The world to update
+ * @param grid Where every enemy is, after they've moved this tick
+ * @param area The area entities have to stay in
+ * @param deltaTime The time between this update and the previous update
+ */
+void sweepBodies(EntityWorld &world, const SpatialGrid &grid, const sf::FloatRect &area, float deltaTime);
@@ -0,0 +1,96 @@
+#include <cstdio>
+
+#include "DamageNumbers.h"
+
+DamageNumbers::DamageNumbers(int capacity) :
+    _capacity(capacity),
+    _count(0),
+    _posX(capacity),
+    _posY(capacity),
+    _life(capacity),
+    _amount(capacity),
+    _color(capacity)
+{
+    _vertices.setPrimitiveType(sf::Quads);
+}
+
+void DamageNumbers::spawn(sf::Vector2<float> position, int amount, sf::Color color)
+{
+    if(_count >= _capacity)
+    {
+        return;
+    }
+
+    const int i = _count++;
+    _posX[i] = position.x;
+    _posY[i] = position.y;
+    _life[i] = _lifetime;
+    _amount[i] = amount;
+    _color[i] = color;
+}
+
+void DamageNumbers::update(float deltaTime)
+{
+    const float rise = _riseSpeed * deltaTime;
+    for(int i = 0; i < _count; i++)
+    {
+        _posY[i] -= rise;
+        _life[i] -= deltaTime;
+    }
+
+    // Pack the live ones back to the front, order doesn't matter
+    int i = 0;
+    while(i < _count)
+    {
+        if(_life[i] > 0)
+        {
+            i++;
+            continue;
+        }
+
+        const int last = --_count;
+        _posX[i] = _posX[last];
+        _posY[i] = _posY[last];
+        _life[i] = _life[last];
+        _amount[i] = _amount[last];
+        _color[i] = _color[last];
+    }
+}
+
+void DamageNumbers::draw(RenderCounter &target, const GlyphAtlas &glyphs)
+{
+    if(_count == 0 || glyphs.getCharacterSize() == 0)
+    {
+        return;
+    }
+
+    // clear() keeps the storage, so after the first busy frame this doesn't allocate
+    _vertices.clear();
+    const float scale = _textSize / glyphs.getCharacterSize();
+    for(int i = 0; i < _count; i++)
+    {
+        char label[16];
+        snprintf(label, sizeof(label), "%d", _amount[i]);
+
+        // Fade out over the last half of the number's life
+        const float fade = _life[i] * 2 / _lifetime;
+        const sf::Uint8 alpha = (sf::Uint8)(255 * (fade < 1 ? fade : 1));
+        sf::Color fill = _color[i];
+        fill.a = alpha;
+
+        const sf::Vector2<float> position(_posX[i] - glyphs.measure(label, scale) / 2, _posY[i]);
+        glyphs.append(_vertices, label, position, fill, sf::Color(0, 0, 0, alpha), scale);
+    }
+
+    target.draw(_vertices, sf::RenderStates(&glyphs.getTexture()));
+}
+
+void DamageNumbers::clear()
+{
+    _count = 0;
+}
+
+int DamageNumbers::getCount() const
+{
+    return _count;
+}
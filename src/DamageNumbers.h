@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vector>
+#include <SFML/Graphics.hpp>
+
+#include "GlyphAtlas.h"
+#include "RenderCounter.h"
+
+/** Class which owns every damage number floating up off whatever got hit.
+ *
+ * Numbers live in a fixed capacity pool of parallel arrays like ParticleSystem, so showing
+ * one never allocates. draw() writes all of them into one vertex array textured with a
+ * GlyphAtlas, so hundreds of numbers on screen still cost a single draw call. When the pool
+ * is full new numbers are dropped until old ones fade out.
+ */
+class DamageNumbers
+{
+    public:
+        /**
+         * @brief Creates an empty pool
+         *
+         * @param capacity The most numbers on screen at once
+         */
+        explicit DamageNumbers(int capacity);
+
+        /**
+         * @brief Starts a number floating up
+         *
+         * @param position Where it starts, it's centered on this
+         * @param amount The number to show
+         * @param color Color to show it in
+         */
+        void spawn(sf::Vector2<float> position, int amount, sf::Color color);
+
+        /**
+         * @brief Floats, ages and fades every number
+         *
+         * @param deltaTime Time between last update and this one
+         */
+        void update(float deltaTime);
+
+        /**
+         * @brief Draws every number in one draw call
+         *
+         * @param target Where to draw to
+         * @param glyphs The atlas holding the digits
+         */
+        void draw(RenderCounter &target, const GlyphAtlas &glyphs);
+
+        /**
+         * @brief Removes every number
+         */
+        void clear();
+
+        /**
+         * @brief Getter for how many numbers are showing
+         *
+         * @return Numbers alive
+         */
+        int getCount() const;
+
+    private:
+        /** Seconds a number stays on screen */
+        static constexpr float _lifetime = 0.8;
+
+        /** How fast numbers float up, in pixels a second */
+        static constexpr float _riseSpeed = 40;
+
+        /** Size numbers are drawn at, in pixels */
+        static constexpr float _textSize = 12;
+
+        int _capacity;
+        int _count;
+
+        // One array per field, live numbers are [0, _count)
+        std::vector<float> _posX;
+        std::vector<float> _posY;
+        std::vector<float> _life;
+        std::vector<int> _amount;
+        std::vector<sf::Color> _color;
+
+        /** Every number's quads, rebuilt each draw */
+        sf::VertexArray _vertices;
+};
@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#include "DynamicResolution.h"
+
+// How much of each new render time goes into the average
+static const float smoothing = 0.1f;
+
+// Frames to wait after changing the scale, so the average catches up before it's acted on again
+static const int settleFrames = 15;
+
+// Dropping aims for this much of the budget, raising only starts below the second
+static const float dropTarget = 0.9f;
+static const float raiseBelow = 0.75f;
+static const float raiseStep = 0.05f;
+
+// Longest a frame counts as, in budgets. A one off hitch like a driver stall isn't drawing
+// being slow, and shouldn't send the scale to the bottom on its own.
+static const float longestFrame = 4;
+
+DynamicResolution::DynamicResolution(float budget, float minScale) :
+    _budget(budget),
+    _minScale(minScale),
+    _scale(1),
+    _enabled(false),
+    _averageTime(0),
+    _settleFrames(0)
+{
+
+}
+
+bool DynamicResolution::create(unsigned width, unsigned height)
+{
+    if(!_texture.create(width, height))
+    {
+        printf("ERROR: dynamic resolution texture can not be created!!\n");
+        return false;
+    }
+
+    // Bilinear filtering when it's stretched over the window
+    _texture.setSmooth(true);
+    _region = sf::IntRect(0, 0, width, height);
+    return true;
+}
+
+void DynamicResolution::setEnabled(bool enabled)
+{
+    // Without a texture there's nowhere to draw to
+    _enabled = enabled && _texture.getSize().x > 0;
+}
+
+bool DynamicResolution::isEnabled() const
+{
+    return _enabled;
+}
+
+void DynamicResolution::addFrame(float renderTime)
+{
+    renderTime = std::min(renderTime, _budget * longestFrame);
+    _averageTime = _averageTime > 0 ? _averageTime + (renderTime - _averageTime) * smoothing : renderTime;
+    if(_settleFrames > 0)
+    {
+        _settleFrames--;
+        return;
+    }
+
+    float scale = _scale;
+    if(_averageTime > _budget)
+    {
+        // The pixels filled go with the square of the scale
+        scale = _scale * std::sqrt(_budget * dropTarget / _averageTime);
+    }
+    else if(_averageTime < _budget * raiseBelow)
+    {
+        scale = _scale + raiseStep;
+    }
+    scale = std::max(_minScale, std::min(scale, 1.0f));
+
+    if(scale != _scale)
+    {
+        _scale = scale;
+        _settleFrames = settleFrames;
+    }
+}
+
+float DynamicResolution::getScale() const
+{
+    return _scale;
+}
+
+sf::RenderTarget& DynamicResolution::begin(const sf::View &view)
+{
+    // Whole pixels, so the viewport SFML works out is exactly the region stretched afterwards
+    const sf::Vector2u size = _texture.getSize();
+    _region.width = std::max(1, (int)(size.x * _scale + 0.5f));
+    _region.height = std::max(1, (int)(size.y * _scale + 0.5f));
+
+    sf::View scaled(view);
+    scaled.setViewport(sf::FloatRect(0, 0, (float)_region.width / size.x, (float)_region.height / size.y));
+
+    _texture.clear();
+    _texture.setView(scaled);
+    return _texture;
+}
+
+void DynamicResolution::present(RenderCounter &target)
+{
+    _texture.display();
+
+    sf::RenderTarget &window = target.getTarget();
+    window.setView(window.getDefaultView());
+    const sf::Vector2<float> windowSize = window.getDefaultView().getSize();
+
+    sf::Sprite sprite(_texture.getTexture(), _region);
+    sprite.setScale(windowSize.x / _region.width, windowSize.y / _region.height);
+    target.draw(sprite);
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include "RenderCounter.h"
+
+/** Class which renders the world at a lower resolution when frames run over budget.
+ *
+ * The world is drawn into an offscreen texture the size of the window, but only into its
+ * top left corner, scaled by how much the render time allows. That corner is then stretched
+ * over the window with bilinear filtering, and the HUD goes on top at full resolution.
+ * The texture is never resized, so changing the scale costs nothing.
+ *
+ * The scale follows a smoothed render time, only what drawing takes, since stepping the game
+ * and waiting for the display don't get cheaper with fewer pixels. Going over budget drops
+ * it straight to what should fit, since the pixels to fill go with the square of the scale. Staying well under
+ * budget raises it back a little at a time, so it doesn't bounce between the two.
+ */
+class DynamicResolution
+{
+    public:
+        /**
+         * @brief Sets up the controller, call create() before drawing
+         *
+         * @param budget Time drawing a frame should take (in seconds), well under the refresh
+         *  period so the game and the driver still fit in the frame
+         * @param minScale Lowest the scale goes, the world is never drawn smaller than this
+         */
+        DynamicResolution(float budget, float minScale);
+
+        /**
+         * @brief Creates the offscreen texture the world is drawn into, dynamic resolution
+         *  stays off until setEnabled()
+         *
+         * @param width Width of the window in pixels
+         * @param height Height of the window in pixels
+         *
+         * @return false if the texture can't be created, it then can't be turned on
+         */
+        bool create(unsigned width, unsigned height);
+
+        /**
+         * @brief Turns dynamic resolution on or off, off the world is drawn straight to the window
+         *
+         * @param enabled Whether to use it
+         */
+        void setEnabled(bool enabled);
+
+        /**
+         * @brief Getter for whether the world is drawn through the offscreen texture
+         *
+         * @return true if it's on
+         */
+        bool isEnabled() const;
+
+        /**
+         * @brief Records how long drawing the last frame took, and picks the scale for the next one
+         *
+         * @param renderTime Time from begin() until the HUD was drawn, not counting display() (in seconds)
+         */
+        void addFrame(float renderTime);
+
+        /**
+         * @brief Getter for how much of the window's resolution the world is drawn at
+         *
+         * @return Between the minimum scale and 1, along each axis
+         */
+        float getScale() const;
+
+        /**
+         * @brief Clears the offscreen texture and sets it up to draw the world into
+         *
+         * @param view The view the world is seen through
+         *
+         * @return Where to draw the world to
+         */
+        sf::RenderTarget& begin(const sf::View &view);
+
+        /**
+         * @brief Stretches what was drawn since begin() over the whole target
+         *
+         * @param target Where to draw to, its view is left at the default
+         */
+        void present(RenderCounter &target);
+
+    private:
+        float _budget;
+        float _minScale;
+        float _scale;
+        bool _enabled;
+
+        /** Render time smoothed over the last few frames, and frames left before it's acted on */
+        float _averageTime;
+        int _settleFrames;
+
+        sf::RenderTexture _texture;
+
+        /** The part of the texture drawn into at the current scale */
+        sf::IntRect _region;
+};
@@ -1,87 +1,264 @@
+#include <algorithm>
+
 #include "Enemy.h"
 
-Enemy::Enemy()
+// Enemies out of ammo have to get this close before they can attack
+static const float meleeRange = 30;
+
+// How long enemy projectiles fly for, in seconds
+static const float projectileLifetime = 4;
+
+// Most transitions an enemy takes in one tick. A state is never entered twice in a tick
+// either, so a loop of conditions that all hold stops short of where it began.
+static const int maxTransitions = 4;
+
+// The columns of one batch of enemies
+struct EnemyColumns
 {
-    ammo = 0;
-    _position = sf::Vector2<float> (0,0);
-    _velocity = sf::Vector2<float>(0, 0);
-    _atkTime = 0;
-    _attacking = false;
-}
+    const EntityId *ids;
+    Transform *transform;
+    Health *health;
+    EnemyBrain *brain;
+};
 
-int Enemy::getAmmo()
+// How close the player has to be, out of ammo enemies have to close in for melee
+static float rangeOf(const EnemyArchetype &stats, const EnemyBrain &brain)
 {
-    return ammo;
+    const bool ranged = stats.projectileSpeed > 0 && brain.ammo > 0;
+    return ranged ? stats.attackRange : std::min(stats.attackRange, meleeRange);
 }
 
-void Enemy::spawn(sf::Vector2<float> pos)
+static bool conditionHolds(int condition, bool enteredThisTick, const EnemyArchetype &stats,
+        const EnemyBrain &brain, const sf::Vector2<float> &position, const sf::Vector2<float> &playerPos,
+        bool playerDodging, float deltaTime)
 {
-    _position = pos;
+    switch(condition)
+    {
+        case NextTickCondition:
+        {
+            return !enteredThisTick;
+        }
+        case InRangeCondition:
+        {
+            const float range = rangeOf(stats, brain);
+            return position.x-playerPos.x<range&&position.x-playerPos.x>-range
+                    &&position.y-playerPos.y<range&&position.y-playerPos.y>-range
+                    &&!playerDodging;
+        }
+        case WindUpDoneCondition:
+        {
+            return brain.atkTime + deltaTime >= stats.cooldown;
+        }
+        default:
+        {
+            return false;
+        }
+    }
 }
 
-void Enemy::setPlayer(Player* playerRef)
+static void chase(EntityWorld &world, const EnemyArchetypes &archetypes, const EnemyColumns &enemies,
+        const std::uint32_t *rows, std::size_t count, const sf::Vector2<float> &playerPos, float deltaTime)
 {
-    _player = playerRef;
+    for(std::size_t r = 0; r < count; r++)
+    {
+        const std::uint32_t i = rows[r];
+        const sf::Vector2<float> &position = enemies.transform[i].position;
+        sf::Vector2<float> &velocity = enemies.transform[i].velocity;
+        velocity = sf::Vector2<float>(playerPos.x-position.x, playerPos.y-position.y);
+
+        // Stop moving towards any of our friends that we're already touching
+        world.eachBatch<Transform, Health, EnemyBrain>([&](std::size_t friendCount,
+                const EntityId *friendIds, Transform *friendTransform, Health *friendHealth,
+                EnemyBrain *friendBrain)
+        {
+            for(std::size_t j = 0; j < friendCount; j++)
+            {
+                const sf::Vector2<float> &friendPos = friendTransform[j].position;
+                if((position.x-friendPos.x<35&&position.x-friendPos.x>-35
+                        &&position.y-friendPos.y<35&&position.y-friendPos.y>-35)
+                        &&friendIds[j]!=enemies.ids[i]&&friendHealth[j].alive)
+                {
+                    if(position.x-friendPos.x<30&&velocity.x>0)
+                    {
+                        velocity.x = 0;
+                    }
+                    if(position.x-friendPos.x>-30&&velocity.x<0)
+                    {
+                        velocity.x = 0;
+                    }
+                    if(position.y-friendPos.y<30&&velocity.y>0)
+                    {
+                        velocity.y = 0;
+                    }
+                    if(position.y-friendPos.y>-30&&velocity.y<0)
+                    {
+                        velocity.y = 0;
+                    }
+                }
+            }
+        });
+
+        if(velocity!=sf::Vector2<float> (0,0))
+        {
+            velocity = velocity / (std::sqrt(velocity.x*velocity.x + velocity.y*velocity.y));
+            velocity *= deltaTime * archetypes.get(enemies.brain[i].archetype).speed;
+        }
+    }
 }
 
-void Enemy::setFriends(std::vector<Enemy*>& friendRef)
+static void windUp(const EnemyColumns &enemies, const std::uint32_t *rows, std::size_t count, float deltaTime)
 {
-    friends = &friendRef;
+    for(std::size_t r = 0; r < count; r++)
+    {
+        const std::uint32_t i = rows[r];
+        enemies.transform[i].velocity = sf::Vector2<float>(0, 0);
+        enemies.brain[i].atkTime += deltaTime;
+    }
 }
 
-void Enemy::onUpdate(float deltaTime)
+static void strike(const EnemyArchetypes &archetypes, const EnemyColumns &enemies, const std::uint32_t *rows,
+        std::size_t count, Player &player, ProjectileSystem &projectiles, const sf::Vector2<float> &playerPos,
+        EventBuffer *events)
 {
-    if(((_position.x-_player->getPosition().x<30&&_position.x-_player->getPosition().x>-30
-            &&_position.y-_player->getPosition().y<30&&_position.y-_player->getPosition().y>-30)
-            &&!_player->isDodging())||_attacking)
+    for(std::size_t r = 0; r < count; r++)
     {
-        _attacking = true;
-        _velocity = sf::Vector2<float> (0,0);
-        _atkTime += deltaTime;
-        if(_atkTime >= 1)
+        const std::uint32_t i = rows[r];
+        const EnemyArchetype &stats = archetypes.get(enemies.brain[i].archetype);
+        const sf::Vector2<float> &position = enemies.transform[i].position;
+        enemies.transform[i].velocity = sf::Vector2<float>(0, 0);
+        enemies.brain[i].atkTime = 0;
+
+        if(stats.projectileSpeed > 0 && enemies.brain[i].ammo > 0)
+        {
+            // Shoot where the player is now, they can still dodge out of the way
+            sf::Vector2<float> aim = playerPos - position;
+            float length = std::sqrt(aim.x*aim.x + aim.y*aim.y);
+            if(length > 0 && projectiles.fire(position, aim / length * stats.projectileSpeed,
+                    stats.attackDamage, EnemyTeam, projectileLifetime))
+            {
+                enemies.brain[i].ammo--;
+            }
+        }
+        else
         {
-            _attacking = false;
-            _atkTime = 0;
-            _player->doDamage(10);
+            player.doDamage(stats.attackDamage, events);
         }
     }
-    else
+}
+
+EntityId Enemy::spawn(EntityWorld &world, const EnemyArchetypes &archetypes, int archetype,
+        sf::Vector2<float> pos)
+{
+    const EnemyArchetype &stats = archetypes.get(archetype);
+
+    Transform transform = {pos, sf::Vector2<float>(0, 0)};
+    Health health = {stats.health, true};
+    SpriteRef sprite = {(std::uint16_t)stats.sprite};
+    EnemyBrain brain = {0, (std::uint16_t)archetype, (std::uint16_t)stats.ammo,
+        archetypes.getBehaviors().getStartState(stats.behavior)};
+
+    return world.create(transform, health, sprite, brain);
+}
+
+void Enemy::updateAll(EntityWorld &world, const EnemyArchetypes &archetypes, Player &player,
+        ProjectileSystem &projectiles, BehaviorGroups &groups, float deltaTime, EventBuffer *events)
+{
+    const BehaviorTable &behaviors = archetypes.getBehaviors();
+    const int stateCount = behaviors.getStateCount();
+    const sf::Vector2<float> playerPos = player.getPosition();
+    const bool playerDodging = player.isDodging();
+
+    world.eachBatch<Transform, Health, EnemyBrain>([&](std::size_t count, const EntityId *ids,
+            Transform *transform, Health *health, EnemyBrain *brain)
     {
-        this->_velocity = sf::Vector2<float>(this->_player->getPosition().x-this->_position.x,
-                this->_player->getPosition().y-this->_position.y);
-        for(int i=0; i<friends->size(); i++)
+        // First every living enemy leaves its state if it can, and is counted into the one it ends up in
+        groups.start.assign(stateCount + 1, 0);
+        for(std::size_t i = 0; i < count; i++)
         {
-            if((_position.x-friends->at(i)->getPosition().x<35&&_position.x-friends->at(i)->getPosition().x>-35
-                    &&_position.y-friends->at(i)->getPosition().y<35&&_position.y-friends->at(i)->getPosition().y>-35)
-                    &&friends->at(i)!=this&&friends->at(i)->isAlive())
+            if(!health[i].alive)
             {
-                if(_position.x-friends->at(i)->getPosition().x<30&&_velocity.x>0)
-                {
-                    _velocity.x = 0;
-                }
-                if(_position.x-friends->at(i)->getPosition().x>-30&&_velocity.x<0)
-                {
-                    _velocity.x = 0;
-                }
-                if(_position.y-friends->at(i)->getPosition().y<30&&_velocity.y>0)
+                continue;
+            }
+
+            const EnemyArchetype &stats = archetypes.get(brain[i].archetype);
+            int visited[maxTransitions + 1];
+            int state = visited[0] = brain[i].state;
+            for(int hop = 0; hop < maxTransitions; hop++)
+            {
+                int transitionCount;
+                const BehaviorTransition *transitions = behaviors.getTransitions(state, transitionCount);
+                int next = -1;
+                for(int t = 0; t < transitionCount && next < 0; t++)
                 {
-                    _velocity.y = 0;
+                    if(conditionHolds(transitions[t].condition, hop > 0, stats, brain[i],
+                            transform[i].position, playerPos, playerDodging, deltaTime))
+                    {
+                        next = transitions[t].target;
+                    }
                 }
-                if(_position.y-friends->at(i)->getPosition().y>-30&&_velocity.y<0)
+                if(next < 0 || std::find(visited, visited + hop + 1, next) != visited + hop + 1)
                 {
-                    _velocity.y = 0;
+                    break;
                 }
+                state = visited[hop + 1] = next;
             }
+            brain[i].state = (std::uint16_t)state;
+            groups.start[state + 1]++;
         }
-        if(_velocity!=sf::Vector2<float> (0,0))
+
+        // Counting sort the rows into their states. Scattering moves each start on to the
+        // next state's, so they're shifted back down afterwards.
+        for(int s = 1; s <= stateCount; s++)
         {
-            this->_velocity = this->_velocity / (std::sqrt(this->_velocity.x*this->_velocity.x + this->_velocity.y*this->_velocity.y));
-            this->_velocity *= deltaTime * 5000;
+            groups.start[s] += groups.start[s - 1];
         }
-    }
-}
+        groups.rows.resize(groups.start[stateCount]);
+        for(std::size_t i = 0; i < count; i++)
+        {
+            if(health[i].alive)
+            {
+                groups.rows[groups.start[brain[i].state]++] = (std::uint32_t)i;
+            }
+        }
+        for(int s = stateCount; s > 0; s--)
+        {
+            groups.start[s] = groups.start[s - 1];
+        }
+        groups.start[0] = 0;
 
-Enemy::~Enemy()
-{
+        // Then each state's action runs over just the enemies in it
+        const EnemyColumns enemies = {ids, transform, health, brain};
+        for(int s = 0; s < stateCount; s++)
+        {
+            const std::uint32_t *rows = groups.rows.data() + groups.start[s];
+            const std::size_t groupSize = groups.start[s + 1] - groups.start[s];
+            if(groupSize == 0)
+            {
+                continue;
+            }
 
+            switch(behaviors.getAction(s))
+            {
+                case ChaseAction:
+                {
+                    chase(world, archetypes, enemies, rows, groupSize, playerPos, deltaTime);
+                    break;
+                }
+                case WindUpAction:
+                {
+                    windUp(enemies, rows, groupSize, deltaTime);
+                    break;
+                }
+                case StrikeAction:
+                {
+                    strike(archetypes, enemies, rows, groupSize, player, projectiles, playerPos, events);
+                    break;
+                }
+                default:
+                {
+                    break;
+                }
+            }
+        }
+    });
 }
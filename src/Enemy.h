@@ -5,75 +5,62 @@
 
 #include "Entity.h"
 #include "Player.h"
+#include "EnemyArchetypes.h"
+#include "ProjectileSystem.h"
 
-/** Enemy class */
-class Enemy : public Entity
+/** Component holding an enemy's kind and attack state.
+ *
+ * Everything that is the same for every enemy of a kind lives in its EnemyArchetype,
+ * this only holds what differs between instances.
+ */
+struct EnemyBrain
 {
-    private:
-        int ammo;
-        float _atkTime;
-        bool _attacking;
-        Player* _player;
-        std::vector<Enemy*>* friends;
-        
-    public:
-        Enemy();
+    /** How far the current attack has wound up, in seconds */
+    float atkTime;
+    std::uint16_t archetype;
+    std::uint16_t ammo;
 
-        /**
-         * @brief changes enemy health amount
-         * 
-         * @param damage amount to remove from health
-         */
-        void takeDamage(int damage);
+    /** The state of its behavior it's in, an index into the BehaviorTable */
+    std::uint16_t state;
+};
 
-        /**
-         * @brief get current ammo
-         *  note: ammo not currently in use
-         * 
-         * @return ammo
-         */
-        int getAmmo();
-        
-        /**
-         * @brief get if the enemy is alive
-         * 
-         * @return true if alive
-         */
-        bool getIsAlive();
+template<> struct ComponentInfo<EnemyBrain> { enum { id = EnemyBrainComponent }; };
 
+/** Enemy class
+ *
+ * An enemy is an entity bundle of Transform, Health, SpriteRef and EnemyBrain. Its stats
+ * come from the EnemyArchetype its brain points at. Its AI is a behavior from the
+ * BehaviorTable: every tick the enemies are sorted by the state they're in, then each
+ * state's action runs as one loop over its group.
+ */
+class Enemy
+{
+    public:
         /**
-         * @brief sets position to chosen location
-         * 
+         * @brief creates an enemy at the chosen location
+         *
+         * @param world the world to spawn into
+         * @param archetypes the enemy definitions
+         * @param archetype which kind of enemy to spawn
          * @param pos the position chosen to spawn at
+         *
+         * @return the new enemy
          */
-        void spawn(sf::Vector2<float> pos);
+        static EntityId spawn(EntityWorld &world, const EnemyArchetypes &archetypes, int archetype,
+                sf::Vector2<float> pos);
 
         /**
-         * @brief establishes player pointer
-         * 
-         * @param playerRef a pointer to the player, as to be sent from WaveManager
-         */
-        void setPlayer(Player* playerRef);
-
-        /**
-         * @brief establishes pointer to other enemies
-         * 
-         * @param friendRef reference to enemy vector
-         */
-        void setFriends(std::vector<Enemy*>& friendRef);
-
-
-        /**
-         * @brief basic AI structure, determines movement/attacks
-         * 
+         * @brief basic AI structure, determines movement/attacks of every enemy
+         *
+         * @param world the world the enemies live in
+         * @param archetypes the enemy definitions
+         * @param player the player the enemies are chasing
+         * @param projectiles where ranged enemies fire their shots into
+         * @param groups where the enemies get sorted by state, reserved for every enemy
          * @param deltaTime time since last frame
+         * @param events if given, the events of melee hits on the player go in it
          */
-        void onUpdate(float deltaTime);
-
-        /**
-         * @brief does nothing, exists for pure virtual override
-         */
-        void onCollision(Entity &hitEntity) {}
-
-        ~Enemy();
+        static void updateAll(EntityWorld &world, const EnemyArchetypes &archetypes, Player &player,
+                ProjectileSystem &projectiles, BehaviorGroups &groups, float deltaTime,
+                EventBuffer *events = nullptr);
 };
@@ -0,0 +1,129 @@
+#include <cstdio>
+#include <sstream>
+
+#include "EnemyArchetypes.h"
+#include "AssetArchive.h"
+
+EnemyArchetypes::EnemyArchetypes()
+{
+
+}
+
+bool EnemyArchetypes::load(const std::string &path, TextureCache &textures)
+{
+    _archetypes.clear();
+
+    std::string text;
+    readAsset(path, text);
+    std::istringstream file(text);
+    std::string line;
+    int lineNumber = 0;
+
+    while(std::getline(file, line))
+    {
+        lineNumber++;
+
+        // Skip blank lines and comments
+        std::size_t start = line.find_first_not_of(" \t\r");
+        if(start == std::string::npos || line[start] == '#')
+        {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        EnemyArchetype archetype;
+        std::string texturePath;
+        sf::IntRect rect;
+
+        if(!(fields >> archetype.name >> archetype.speed >> archetype.health >> archetype.attackRange
+                >> archetype.attackDamage >> archetype.cooldown >> texturePath
+                >> rect.left >> rect.top >> rect.width >> rect.height))
+        {
+            printf("ERROR: %s:%d is not a valid enemy archetype!!\n", path.c_str(), lineNumber);
+            continue;
+        }
+
+        // Ranged stats are optional, enemies without them only attack in melee
+        if(!(fields >> archetype.projectileSpeed >> archetype.ammo))
+        {
+            archetype.projectileSpeed = 0;
+            archetype.ammo = 0;
+        }
+
+        // So is the behavior, enemies without one get the first
+        std::string behavior;
+        archetype.behavior = 0;
+        if(fields >> behavior)
+        {
+            archetype.behavior = _behaviors.find(behavior);
+            if(archetype.behavior < 0)
+            {
+                printf("ERROR: %s:%d has no behavior called %s!!\n", path.c_str(), lineNumber, behavior.c_str());
+                archetype.behavior = 0;
+            }
+        }
+
+        archetype.sprite = textures.addSprite(textures.load(texturePath), rect);
+        _archetypes.push_back(archetype);
+    }
+
+    if(!_archetypes.empty())
+    {
+        return true;
+    }
+
+    // Fall back to the stats enemies had before they were data driven
+    printf("ERROR: enemy archetypes can not be loaded from %s!!\n", path.c_str());
+    EnemyArchetype grunt;
+    grunt.name = "grunt";
+    grunt.speed = 5000;
+    grunt.health = 100;
+    grunt.attackRange = 30;
+    grunt.attackDamage = 10;
+    grunt.cooldown = 1;
+    grunt.projectileSpeed = 0;
+    grunt.ammo = 0;
+    grunt.behavior = 0;
+    grunt.sprite = textures.addSprite(textures.load("assets/textures/test.png"), sf::IntRect());
+    _archetypes.push_back(grunt);
+
+    return false;
+}
+
+bool EnemyArchetypes::loadBehaviors(const std::string &path)
+{
+    return _behaviors.load(path);
+}
+
+const BehaviorTable& EnemyArchetypes::getBehaviors() const
+{
+    return _behaviors;
+}
+
+int EnemyArchetypes::add(const EnemyArchetype &archetype)
+{
+    _archetypes.push_back(archetype);
+    return (int)_archetypes.size() - 1;
+}
+
+const EnemyArchetype& EnemyArchetypes::get(int index) const
+{
+    return _archetypes.at(index);
+}
+
+int EnemyArchetypes::find(const std::string &name) const
+{
+    for(std::size_t i = 0; i < _archetypes.size(); i++)
+    {
+        if(_archetypes[i].name == name)
+        {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+int EnemyArchetypes::size() const
+{
+    return (int)_archetypes.size();
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <SFML/Graphics.hpp>
+
+#include "TextureCache.h"
+#include "BehaviorTable.h"
+
+/** Stats shared by every enemy of one kind. */
+struct EnemyArchetype
+{
+    std::string name;
+
+    /** How hard the enemy chases the player, scaled by the frame time */
+    float speed;
+
+    /** Health the enemy spawns with */
+    int health;
+
+    /** How close (along each axis) the player has to be before the enemy attacks */
+    float attackRange;
+
+    /** Damage done when an attack lands */
+    int attackDamage;
+
+    /** How long an attack winds up before it lands, in seconds */
+    float cooldown;
+
+    /** Index of the enemy's sprite in the TextureCache */
+    int sprite;
+
+    /** Speed of the projectiles the enemy fires, 0 for enemies that only attack in melee */
+    float projectileSpeed;
+
+    /** Number of projectiles the enemy spawns with */
+    int ammo;
+
+    /** Index of the enemy's behavior in the BehaviorTable */
+    int behavior;
+};
+
+/** Class which holds the definition of every kind of enemy, and the behaviors they act out.
+ *
+ * The definitions are read once from a data file, so new enemy variants don't need a
+ * recompile. Enemies themselves only store the index of their archetype (see EnemyBrain)
+ * next to the little state that actually differs between them.
+ */
+class EnemyArchetypes
+{
+    public:
+        EnemyArchetypes();
+
+        /**
+         * @brief Reads the archetype definitions from a file
+         *
+         *  Each non-comment line is:
+         *  name speed health range damage cooldown texture x y w h [projectileSpeed ammo [behavior]]
+         *  If the file can't be read, a single archetype with the original hard-coded
+         *  enemy stats is used instead. Behaviors are looked up by name, so load those first.
+         *
+         * @param path Path of the definition file
+         * @param textures Where the archetype textures get loaded into
+         *
+         * @return true if the file was read
+         */
+        bool load(const std::string &path, TextureCache &textures);
+
+        /**
+         * @brief Reads the behaviors archetypes can use, see BehaviorTable::load()
+         *
+         * @param path Path of the behavior file
+         *
+         * @return true if the file was read
+         */
+        bool loadBehaviors(const std::string &path);
+
+        /**
+         * @brief Getter for the behaviors
+         *
+         * @return The compiled state table
+         */
+        const BehaviorTable& getBehaviors() const;
+
+        /**
+         * @brief Adds an archetype that isn't in the definition file
+         *
+         * @param archetype The definition, its sprite must already be in the TextureCache
+         *
+         * @return Index of the new archetype
+         */
+        int add(const EnemyArchetype &archetype);
+
+        /**
+         * @brief Getter for an archetype
+         *
+         * @param index Index of the archetype
+         *
+         * @return The archetype
+         */
+        const EnemyArchetype& get(int index) const;
+
+        /**
+         * @brief Finds an archetype by name
+         *
+         * @param name Name of the archetype
+         *
+         * @return Index of the archetype, or -1 if there isn't one with that name
+         */
+        int find(const std::string &name) const;
+
+        /**
+         * @brief Getter for the number of archetypes
+         *
+         * @return Number of archetypes
+         */
+        int size() const;
+
+    private:
+        std::vector<EnemyArchetype> _archetypes;
+        BehaviorTable _behaviors;
+};
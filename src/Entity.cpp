@@ -1,104 +1,87 @@
 #include "Entity.h"
-#include "GameManager.h"
 
-Entity::Entity()
+void updateHealth(EntityWorld &world)
 {
-    // Initialize position and velocity to have a position of <0, 0>
-    _position = sf::Vector2<float>(0, 0);
-    _velocity = sf::Vector2<float>(0, 0);
-
-    // Load texture in from file
-    // TODO: Does this need to by dynamic?
-    _texture.loadFromFile("assets/textures/test.png");
-    _sprite.setTexture(_texture);
-    _sprite.setOrigin((int)(_texture.getSize().x / 2), (int)(_texture.getSize().y / 2));
-
-    // Initialize entity with 0 size, and default health of 100
-    _width = 0;
-    _height = 0;
-    _health = 100;
-
-    // Entity starts as alive
-    this->_isAlive = true;
-}
-
-const sf::Vector2<float>& Entity::getPosition() const
-{
-    return _position;
-}
-
-const sf::Vector2<float>& Entity::getVelocity() const
-{
-    return _velocity;
-}
-
-const int& Entity::getWidth() const
-{
-    return _width;
+    // Anything that has run out of health this frame is now dead
+    world.eachBatch<Health>([](std::size_t count, const EntityId *ids, Health *health)
+    {
+        for(std::size_t i = 0; i < count; i++)
+        {
+            if(health[i].health <= 0)
+            {
+                health[i].alive = false;
+            }
+        }
+    });
 }
 
-const int& Entity::getHeight() const
+// Where an entity died, for its DeathEvent
+static DeathEvent deathOf(EntityWorld &world, EntityId id)
 {
-    return _height;
+    const Transform *transform = world.get<Transform>(id);
+    return DeathEvent {id, transform != nullptr ? transform->position : sf::Vector2<float>(0, 0)};
 }
 
-const int& Entity::getHealth() const
+void integrateMotion(EntityWorld &world, float deltaTime)
 {
-    return _health;
+    // Update every living entity's position based off of it's velocity
+    world.eachBatch<Transform, Health>([deltaTime](std::size_t count, const EntityId *ids,
+            Transform *transform, Health *health)
+    {
+        for(std::size_t i = 0; i < count; i++)
+        {
+            if(health[i].alive)
+            {
+                transform[i].position += transform[i].velocity * deltaTime;
+            }
+        }
+    }, EntityWorld::maskOf<Bounds>());
 }
 
-void Entity::update(float deltaTime)
+void doDamage(EntityWorld &world, EntityId id, int damage, EventBuffer *events)
 {
-    // When we update a frame we want to do a few things
-    // First we want to check for the health to see if this entity is dead
-    if(_health <= 0)
+    Health *health = world.get<Health>(id);
+    if(health != nullptr)
     {
-        this->kill();
+        const bool wasAlive = health->alive && health->health > 0;
+        health->health -= damage;
+        if(events != nullptr)
+        {
+            events->damage.push_back(DamageEvent {id, damage});
+
+            // It stays alive until updateHealth() next tick, but it's dead as of now
+            if(wasAlive && health->health <= 0)
+            {
+                events->deaths.push_back(deathOf(world, id));
+            }
+        }
     }
-
-    // Then we want to update the entity
-    this->onUpdate(deltaTime);
-
-    // After the update, we want to update the entity's position based off of it's velocity
-    this->_position += this->_velocity * deltaTime;
-
-    // The below '/' was added by Diesel, he's a good boy
-    // Finally, we draw the entity  /
-    this->onDraw();
 }
 
-void Entity::doDamage(int damage)
+void kill(EntityWorld &world, EntityId id, EventBuffer *events)
 {
-    this->_health -= damage;
-}
-
-bool Entity::isAlive()
-{
-    return this->_isAlive;
-}
-
-void Entity::kill()
-{
-    _isAlive = false;
-}
-
-void Entity::spawn(sf::Vector2<float> spawnLocation)
-{
-
-}
-
-const sf::Sprite& Entity::getSprite() const
-{
-    return _sprite;
+    Health *health = world.get<Health>(id);
+    if(health != nullptr)
+    {
+        // A killing blow already raised its death, even though it's alive until updateHealth()
+        if(health->alive && health->health > 0 && events != nullptr)
+        {
+            events->deaths.push_back(deathOf(world, id));
+        }
+        health->alive = false;
+    }
 }
 
-void Entity::onDraw()
+bool isAlive(EntityWorld &world, EntityId id)
 {
-    // Default behavior is to just set the sprite's position I guess
-    _sprite.setPosition(_position);
+    Health *health = world.get<Health>(id);
+    return health != nullptr && health->alive;
 }
 
-void Entity::onCollision(Entity &hitEntity)
+sf::FloatRect getSpriteBox(EntityWorld &world, const TextureCache &textures, EntityId id)
 {
-
+    const SpriteDef &def = textures.getSprite(world.get<SpriteRef>(id)->sprite);
+    const sf::Vector2<float> &position = world.get<Transform>(id)->position;
+    return sf::FloatRect(position.x - def.origin.x, position.y - def.origin.y,
+            (float)def.rect.width, (float)def.rect.height);
 }
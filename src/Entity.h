@@ -2,194 +2,124 @@
 
 #include "SFML/System/Vector2.hpp"
 #include "SFML/Graphics.hpp"
-
-/** Abstract base class which entities are based off of.
- * 
- * Entities are generally anything that can have a sprite and/or a position.
- * 
- * To make your subclass of Entity visible on the screen, you need to do the following:
- * 
- * 1. set _texture
- * 2. set _sprite
- * 3. Somewhere in the main game loop where drawing happens, call your subclass's onDraw()
- * method and draw() the entity's sprite to the screen.
- * 
- * Updating position is handled by update(). Position is set based on the value of _velocity. You can
- * set _position or _velocity in onUpdate() to define the movement behavior of your Entity.
+#include "EntityWorld.h"
+#include "TextureCache.h"
+#include "GameEvents.h"
+
+/** Components that every entity bundle is built from.
+ *
+ * Entities are generally anything that can have a sprite and/or a position. They no longer
+ * have a class of their own: an entity is an EntityId in the EntityWorld plus a bundle of the
+ * plain-data components below, and any extra components for its kind (see Player and Enemy).
+ *
+ * To make a new kind of entity visible on the screen, give it a Transform and a SpriteRef
+ * pointing at a sprite defined in the TextureCache. SpriteBatch draws everything with a SpriteRef
+ * in one pass, there is no per-entity drawing code.
+ *
+ * Updating position is handled by integrateMotion(). Position is set based on the value of
+ * Transform::velocity, so systems set the position or velocity to define how an entity moves.
  */
 
-class Entity
+/** Position and velocity of an entity in world coordinates. */
+struct Transform
 {
-    public:
-        Entity();
-
-        /// Getters and Setters
-        /**
-         * @brief Getter for entity position
-         *
-         * @return Entity's position 
-         */
-        const sf::Vector2<float>& getPosition() const;
-
-        
-        /**
-         * @brief Getter for entity velocity
-         *
-         * @return Entity's velocity 
-         */
-        const sf::Vector2<float>& getVelocity() const;
-
-
-        /**
-         * @brief Getter for entity active sprite
-         *
-         * @return Sprite to render to window for this entity 
-         */
-        const sf::Sprite& getSprite() const;
-
-
-        /**
-         * @brief Getter for entity width
-         *
-         * @return Width of entity 
-         */
-        const int& getWidth() const;
-
-
-        /**
-         * @brief Getter for entity height
-         *
-         * @return Height of entity 
-         */
-        const int& getHeight() const;
-
-
-        /**
-         * @brief Getter for entity health
-         *
-         * @return Health of entity 
-         */
-        const int& getHealth() const;
-
-        /// Main function to update an entity 
-
-        /**
-         * @brief Called from GameManager, will update the entity based off user input
-         *
-         * @param deltaTime the time between this update and the previous update
-         */
-        void update(float deltaTime);
-
-        /**
-         * @brief Will tell this entity to lower it's health
-         *
-         * @param damage The amount of damage to do
-         */
-        void doDamage(int damage);
-
-        /**
-         * @brief Getter for is entity is alive
-         *
-         * @return If entity is alive 
-         */
-        bool isAlive();
-
-        /// Interface methods with a default implementation, can be overridden
-
-        /**
-         * @brief Spawns the entity in at a given location
-         *
-         * @param spawnLocation The location to spawn the entity at
-         */
-        virtual void spawn(sf::Vector2<float> spawnLocation);
-
-        /**
-         * @brief Kills the entity, stops it from being rendered on the scene
-         *  and affecting collisions
-         */
-        virtual void kill();
-
-        /**
-         * @brief Called from update, change the active sprite to draw to the scene, and 
-         *  set up current sprite for rendering 
-         */
-        virtual void onDraw();
-
-        /// Interface methods that must be overridden 
-        
-        /**
-         * @brief Called from update, the overridable function for specific entities
-         *  to change their members based off user input
-         *
-         * @param deltaTime The time between this update and the last one
-         */
-        virtual void onUpdate(float deltaTime) = 0;
-        
-        /**
-         * @brief Called from the game manager after a collision with another entity
-         *
-         * @param hitEntity The other entity this one collider with
-         */
-        virtual void onCollision(Entity &hitEntity) = 0;  
+    /** Modify this to reposition the entity in the world. */
+    sf::Vector2<float> position;
 
-        /** Vector for position in world coordinates.
-         * 
-         * Modify this to reposition the entity in the world.
-         */
-        
-        sf::Vector2<float> _position;
-
-    protected:
-
-        /** Vector for velocity. 
-         * 
-         * Modify this to give the entity a new velocity.
-         */
-        // Vectors for position and velocity
-        sf::Vector2<float> _velocity;
-
-        /** Width of this entity */
-        int _width;
+    /** Modify this to give the entity a new velocity. */
+    sf::Vector2<float> velocity;
+};
 
-        /** Height of this entity */
-        int _height;
+/** Size of an entity's collision box, centered on its position.
+ *
+ * Entities with Bounds are solid: sweepBodies() moves them instead of integrateMotion(),
+ * so they can't pass through enemies or off the map.
+ */
+struct Bounds
+{
+    int width;
+    int height;
+};
 
-        /** Health of this entity */
-        int _health;
+/** Health of an entity, and whether it is still alive. */
+struct Health
+{
+    int health;
+    bool alive;
+};
 
-        /* If the entity is alive or not */
-        bool _isAlive;
+/** Which sprite to draw an entity with.
+ *
+ * The sprite itself (texture, region and origin) is defined once in the TextureCache.
+ * A texture can be a spritesheet with multiple frames of an animation, so an entity
+ * changes frame by pointing at a different sprite. Entities with an Animation have this
+ * kept pointing at the current frame of their clip by updateAnimations().
+ */
+struct SpriteRef
+{
+    /** Index of the sprite in the TextureCache */
+    std::uint16_t sprite;
+};
 
-        /** The texture that this entity uses.
-         * 
-         * To give your subclass an image, set this in the constructor like so:
-         * 
-         *     _texture.loadFromFile("path/to/image.png");
-         *     // set the sprite, see _sprite
-         * 
-         * The texture could potentially be a spritesheet with multiple frames of an animation, 
-         * or could be just one drawing.
-         */
-        sf::Texture _texture;
+template<> struct ComponentInfo<Transform> { enum { id = TransformComponent }; };
+template<> struct ComponentInfo<Bounds> { enum { id = BoundsComponent }; };
+template<> struct ComponentInfo<Health> { enum { id = HealthComponent }; };
+template<> struct ComponentInfo<SpriteRef> { enum { id = SpriteComponent }; };
 
-        /** The sprite that this entity uses.
-         * 
-         * The active sprite adds a rectangle around a texture, defining the region
-         * of the texture that we actually want to display.
-         * 
-         * To give your subclass a sprite, do something like the following in the constructor
-         * after giving your subclass a texture:
-         * 
-         *     // You've already set _texture, now set _sprite
-         *     _sprite.setTexture(_texture);
-         *     // set your rectangle, origin, etc. See docs on sf::Sprite.
-         *     // Here's an example:
-         *     _sprite.setOrigin((int)(_texture.getSize().x / 2), (int)(_texture.getSize().y / 2));
-         * 
-         * One use case of this is animation; you could use one texture to store all the frames
-         * of an animation and update the sprite to change which part of the texture it renders
-         * when you want to show a different animation frame.
-         */
-        // TODO: Sprite array?
-        sf::Sprite _sprite;
-};
+/**
+ * @brief Called from GameManager, kills every entity whose health has run out
+ *  Their DeathEvents were already raised by the doDamage() that did it
+ *
+ * @param world The world to update
+ */
+void updateHealth(EntityWorld &world);
+
+/**
+ * @brief Called from GameManager, moves every living entity based off of its velocity
+ *  Entities with Bounds are left for sweepBodies()
+ *
+ * @param world The world to update
+ * @param deltaTime The time between this update and the previous update
+ */
+void integrateMotion(EntityWorld &world, float deltaTime);
+
+/**
+ * @brief Will tell an entity to lower it's health
+ *
+ * @param world The world the entity lives in
+ * @param id The entity to damage
+ * @param damage The amount of damage to do
+ * @param events If given, a DamageEvent goes in it, and a DeathEvent too if this was the killing blow
+ */
+void doDamage(EntityWorld &world, EntityId id, int damage, EventBuffer *events = nullptr);
+
+/**
+ * @brief Kills an entity, stops it from being rendered on the scene and affecting collisions
+ *
+ * @param world The world the entity lives in
+ * @param id The entity to kill
+ * @param events If given, a DeathEvent goes in it unless the entity was already dead,
+ *  or already took a killing blow this tick
+ */
+void kill(EntityWorld &world, EntityId id, EventBuffer *events = nullptr);
+
+/**
+ * @brief Checks if an entity is alive
+ *
+ * @param world The world the entity lives in
+ * @param id The entity to check
+ *
+ * @return true if the entity exists and hasn't been killed
+ */
+bool isAlive(EntityWorld &world, EntityId id);
+
+/**
+ * @brief Gets the box an entity's sprite covers in the world
+ *
+ * @param world The world the entity lives in
+ * @param textures Where the entity's sprite is defined
+ * @param id The entity
+ *
+ * @return The sprite rect placed at the entity's position
+ */
+sf::FloatRect getSpriteBox(EntityWorld &world, const TextureCache &textures, EntityId id);
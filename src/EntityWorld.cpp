@@ -0,0 +1,345 @@
+#include "EntityWorld.h"
+
+Archetype::Archetype(ComponentMask mask, const std::size_t *componentSizes)
+{
+    _mask = mask;
+
+    for(int i = 0; i < ComponentTypeCount; i++)
+    {
+        // Only keep the sizes of components we actually store, the rest stay 0
+        _sizes[i] = (mask & (ComponentMask(1) << i)) ? componentSizes[i] : 0;
+    }
+}
+
+ComponentMask Archetype::getMask() const
+{
+    return _mask;
+}
+
+std::size_t Archetype::size() const
+{
+    return _entities.size();
+}
+
+const std::vector<EntityId>& Archetype::getEntities() const
+{
+    return _entities;
+}
+
+std::uint32_t Archetype::pushRow(EntityId id)
+{
+    const std::uint32_t row = (std::uint32_t)_entities.size();
+    _entities.push_back(id);
+
+    // Grow every column by one zeroed element
+    for(int i = 0; i < ComponentTypeCount; i++)
+    {
+        if(_sizes[i] != 0)
+        {
+            _columns[i].resize(_columns[i].size() + _sizes[i], 0);
+        }
+    }
+
+    return row;
+}
+
+EntityId Archetype::swapRemoveRow(std::uint32_t row)
+{
+    const std::uint32_t last = (std::uint32_t)_entities.size() - 1;
+
+    for(int i = 0; i < ComponentTypeCount; i++)
+    {
+        if(_sizes[i] == 0)
+        {
+            continue;
+        }
+
+        // Components are plain data, so moving the last row over the removed one is just a copy
+        if(row != last)
+        {
+            std::memcpy(&_columns[i][row * _sizes[i]], &_columns[i][last * _sizes[i]], _sizes[i]);
+        }
+        _columns[i].resize(last * _sizes[i]);
+    }
+
+    if(row == last)
+    {
+        _entities.pop_back();
+        return EntityId();
+    }
+
+    _entities[row] = _entities[last];
+    _entities.pop_back();
+    return _entities[row];
+}
+
+void Archetype::reorder(const std::vector<std::uint32_t> &order, std::vector<unsigned char> &scratch)
+{
+    for(int i = 0; i < ComponentTypeCount; i++)
+    {
+        if(_sizes[i] == 0)
+        {
+            continue;
+        }
+
+        scratch.resize(_columns[i].size());
+        for(std::size_t row = 0; row < order.size(); row++)
+        {
+            std::memcpy(&scratch[row * _sizes[i]], &_columns[i][order[row] * _sizes[i]], _sizes[i]);
+        }
+        _columns[i].swap(scratch);
+    }
+
+    // The ids go through the same scratch, as bytes
+    scratch.resize(_entities.size() * sizeof(EntityId));
+    for(std::size_t row = 0; row < order.size(); row++)
+    {
+        std::memcpy(&scratch[row * sizeof(EntityId)], &_entities[order[row]], sizeof(EntityId));
+    }
+    std::memcpy(_entities.data(), scratch.data(), scratch.size());
+}
+
+void Archetype::clear()
+{
+    for(int i = 0; i < ComponentTypeCount; i++)
+    {
+        _columns[i].clear();
+    }
+    _entities.clear();
+}
+
+void Archetype::saveTo(Snapshot &snapshot) const
+{
+    snapshot.write(_mask);
+    snapshot.writeVector(_entities);
+    for(int i = 0; i < ComponentTypeCount; i++)
+    {
+        if(_sizes[i] != 0)
+        {
+            snapshot.writeVector(_columns[i]);
+        }
+    }
+}
+
+bool Archetype::loadFrom(Snapshot &snapshot)
+{
+    if(!snapshot.readVector(_entities))
+    {
+        return false;
+    }
+
+    for(int i = 0; i < ComponentTypeCount; i++)
+    {
+        if(_sizes[i] == 0)
+        {
+            continue;
+        }
+        if(!snapshot.readVector(_columns[i]) || _columns[i].size() != _entities.size() * _sizes[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+EntityWorld::EntityWorld()
+{
+    _entityCount = 0;
+
+    for(int i = 0; i < ComponentTypeCount; i++)
+    {
+        _componentSizes[i] = 0;
+    }
+}
+
+void EntityWorld::destroy(EntityId id)
+{
+    if(!isAlive(id))
+    {
+        return;
+    }
+
+    EntityRecord &record = _records[id.index];
+    EntityId moved = _archetypes[record.archetype].swapRemoveRow(record.row);
+
+    // Whoever got moved into the hole now lives at the removed row
+    if(moved.isValid())
+    {
+        _records[moved.index].row = record.row;
+    }
+
+    // Bumping the generation invalidates every copy of the old id
+    record.generation++;
+    record.archetype = -1;
+    _freeIndices.push_back(id.index);
+    _entityCount--;
+}
+
+void EntityWorld::clear()
+{
+    for(std::size_t i = 0; i < _archetypes.size(); i++)
+    {
+        const std::vector<EntityId> &ids = _archetypes[i].getEntities();
+        for(std::size_t j = 0; j < ids.size(); j++)
+        {
+            _records[ids[j].index].generation++;
+            _records[ids[j].index].archetype = -1;
+            _freeIndices.push_back(ids[j].index);
+        }
+        _archetypes[i].clear();
+    }
+
+    _entityCount = 0;
+}
+
+bool EntityWorld::isAlive(EntityId id) const
+{
+    return id.index < _records.size()
+        && _records[id.index].generation == id.generation
+        && _records[id.index].archetype >= 0;
+}
+
+std::size_t EntityWorld::getEntityCount() const
+{
+    return _entityCount;
+}
+
+EntityId EntityWorld::allocateId()
+{
+    _entityCount++;
+
+    // Reuse the most recently freed slot if there is one
+    if(!_freeIndices.empty())
+    {
+        std::uint32_t index = _freeIndices.back();
+        _freeIndices.pop_back();
+        return EntityId(index, _records[index].generation);
+    }
+
+    EntityRecord record;
+    record.generation = 0;
+    record.archetype = -1;
+    record.row = 0;
+    _records.push_back(record);
+
+    return EntityId((std::uint32_t)_records.size() - 1, 0);
+}
+
+int EntityWorld::findOrCreateArchetype(ComponentMask mask)
+{
+    // There are only ever a handful of archetypes, so a linear search is plenty
+    for(std::size_t i = 0; i < _archetypes.size(); i++)
+    {
+        if(_archetypes[i].getMask() == mask)
+        {
+            return (int)i;
+        }
+    }
+
+    _archetypes.push_back(Archetype(mask, _componentSizes));
+    return (int)_archetypes.size() - 1;
+}
+
+void EntityWorld::saveTo(Snapshot &snapshot) const
+{
+    snapshot.write(_componentSizes);
+    snapshot.write((std::uint64_t)_entityCount);
+    snapshot.writeVector(_records);
+    snapshot.writeVector(_freeIndices);
+
+    snapshot.write((std::uint32_t)_archetypes.size());
+    for(std::size_t i = 0; i < _archetypes.size(); i++)
+    {
+        _archetypes[i].saveTo(snapshot);
+    }
+}
+
+bool EntityWorld::loadFrom(Snapshot &snapshot)
+{
+    std::size_t sizes[ComponentTypeCount];
+    std::uint64_t entityCount;
+    if(!snapshot.read(sizes) || !snapshot.read(entityCount))
+    {
+        return false;
+    }
+
+    // A component that changed size since the snapshot was taken can't be copied back in,
+    // and one this world has never registered has no size to check against
+    for(int i = 0; i < ComponentTypeCount; i++)
+    {
+        if(sizes[i] != 0 && sizes[i] != _componentSizes[i])
+        {
+            return false;
+        }
+    }
+
+    std::uint32_t archetypeCount;
+    if(!snapshot.readVector(_records) || !snapshot.readVector(_freeIndices)
+            || !snapshot.read(archetypeCount))
+    {
+        return false;
+    }
+
+    // Archetypes are matched up by index, since that's what the records point at.
+    // Ones that already exist with the same components keep their column storage.
+    for(std::uint32_t i = 0; i < archetypeCount; i++)
+    {
+        ComponentMask mask;
+        if(!snapshot.read(mask) || (mask >> ComponentTypeCount) != 0)
+        {
+            return false;
+        }
+        if(i >= _archetypes.size())
+        {
+            _archetypes.push_back(Archetype(mask, _componentSizes));
+        }
+        else if(_archetypes[i].getMask() != mask)
+        {
+            _archetypes[i] = Archetype(mask, _componentSizes);
+        }
+        if(!_archetypes[i].loadFrom(snapshot))
+        {
+            return false;
+        }
+    }
+    _archetypes.resize(archetypeCount, Archetype(0, _componentSizes));
+
+    // Every row has to point back at a slot that points at it, and every other slot has to
+    // be free exactly once, or destroy() and get() would index out of bounds later on
+    std::size_t rows = 0;
+    for(std::uint32_t i = 0; i < archetypeCount; i++)
+    {
+        const std::vector<EntityId> &ids = _archetypes[i].getEntities();
+        for(std::size_t row = 0; row < ids.size(); row++)
+        {
+            if(ids[row].index >= _records.size())
+            {
+                return false;
+            }
+            const EntityRecord &record = _records[ids[row].index];
+            if(record.archetype != (std::int32_t)i || record.row != row || record.generation != ids[row].generation)
+            {
+                return false;
+            }
+        }
+        rows += ids.size();
+    }
+
+    std::vector<bool> freed(_records.size(), false);
+    for(std::size_t i = 0; i < _freeIndices.size(); i++)
+    {
+        const std::uint32_t index = _freeIndices[i];
+        if(index >= _records.size() || _records[index].archetype >= 0 || freed[index])
+        {
+            return false;
+        }
+        freed[index] = true;
+    }
+    if(entityCount != rows || rows + _freeIndices.size() != _records.size())
+    {
+        return false;
+    }
+
+    _entityCount = (std::size_t)entityCount;
+    return true;
+}
@@ -0,0 +1,466 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "Snapshot.h"
+
+/** Every component type that can be stored in an EntityWorld.
+ *
+ * A component struct is tied to one of these values with a ComponentInfo
+ * specialization next to its definition. The values are bit positions in an
+ * archetype's ComponentMask, so new component types go at the end.
+ */
+enum ComponentType
+{
+    TransformComponent,
+    BoundsComponent,
+    HealthComponent,
+    SpriteComponent,
+    PlayerControlComponent,
+    EnemyBrainComponent,
+    AnimationComponent,
+    ComponentTypeCount
+};
+
+/** Bitset of ComponentType values, one bit per component an archetype holds. */
+typedef std::uint32_t ComponentMask;
+
+/** Maps a component struct onto its ComponentType.
+ *
+ * Specialize this for every component, like so:
+ *
+ *     template<> struct ComponentInfo<Transform> { enum { id = TransformComponent }; };
+ */
+template<typename T>
+struct ComponentInfo;
+
+/** Generational id of an entity in an EntityWorld.
+ *
+ * The index names a slot in the world, the generation is bumped every time that
+ * slot is recycled, so an id that outlives its entity is simply no longer alive
+ * instead of pointing at whatever was spawned into the slot afterwards.
+ */
+struct EntityId
+{
+    EntityId() : index(invalidIndex), generation(0) {}
+    EntityId(std::uint32_t idx, std::uint32_t gen) : index(idx), generation(gen) {}
+
+    /**
+     * @brief Checks if this id was ever handed out by a world
+     *
+     * @return false for a default constructed id
+     */
+    bool isValid() const { return index != invalidIndex; }
+
+    std::uint32_t index;
+    std::uint32_t generation;
+
+    static const std::uint32_t invalidIndex = 0xFFFFFFFF;
+};
+
+inline bool operator==(const EntityId &lhs, const EntityId &rhs)
+{
+    return lhs.index == rhs.index && lhs.generation == rhs.generation;
+}
+
+inline bool operator!=(const EntityId &lhs, const EntityId &rhs)
+{
+    return !(lhs == rhs);
+}
+
+/** Storage for every entity that has exactly the same set of components.
+ *
+ * Components are packed per type into their own column, so row i of every column
+ * belongs to the entity in getEntities()[i]. Systems walk these columns front to
+ * back instead of hopping between separately allocated objects.
+ */
+class Archetype
+{
+    public:
+        /**
+         * @brief Creates an empty archetype
+         *
+         * @param mask The components every entity in this archetype has
+         * @param componentSizes sizeof() of each component type, indexed by ComponentType
+         */
+        Archetype(ComponentMask mask, const std::size_t *componentSizes);
+
+        /**
+         * @brief Getter for the component mask
+         *
+         * @return The set of components this archetype stores
+         */
+        ComponentMask getMask() const;
+
+        /**
+         * @brief Getter for the number of entities stored
+         *
+         * @return Number of rows in every column
+         */
+        std::size_t size() const;
+
+        /**
+         * @brief Getter for the entity ids, one per row
+         *
+         * @return The ids in row order
+         */
+        const std::vector<EntityId>& getEntities() const;
+
+        /**
+         * @brief Gets the packed column of a component
+         *
+         * @return Pointer to the first row, or nullptr if this archetype lacks T
+         */
+        template<typename T>
+        T* column()
+        {
+            if(!(_mask & (ComponentMask(1) << ComponentInfo<T>::id)))
+            {
+                return nullptr;
+            }
+            return reinterpret_cast<T*>(_columns[ComponentInfo<T>::id].data());
+        }
+
+        /**
+         * @brief Appends a zeroed row for a new entity
+         *
+         * @param id The entity that will own the row
+         *
+         * @return The index of the new row
+         */
+        std::uint32_t pushRow(EntityId id);
+
+        /**
+         * @brief Removes a row by moving the last row into its place
+         *
+         * @param row The row to remove
+         *
+         * @return The entity that now lives in row, or an invalid id if row was the last one
+         */
+        EntityId swapRemoveRow(std::uint32_t row);
+
+        /**
+         * @brief Puts the rows in a new order
+         *
+         * @param order For each new row, the row that moves into it
+         * @param scratch Spare storage, swapped with the columns so repeat calls don't allocate
+         */
+        void reorder(const std::vector<std::uint32_t> &order, std::vector<unsigned char> &scratch);
+
+        /**
+         * @brief Removes every row
+         */
+        void clear();
+
+        /**
+         * @brief Writes every row into a snapshot, one memcpy per column
+         *
+         * @param snapshot Where to write to
+         */
+        void saveTo(Snapshot &snapshot) const;
+
+        /**
+         * @brief Replaces every row with the ones in a snapshot
+         *
+         * @param snapshot Where to read from
+         *
+         * @return false if the snapshot is cut short
+         */
+        bool loadFrom(Snapshot &snapshot);
+
+    private:
+        ComponentMask _mask;
+        std::size_t _sizes[ComponentTypeCount];
+        std::vector<unsigned char> _columns[ComponentTypeCount];
+        std::vector<EntityId> _entities;
+};
+
+/** Archetype based entity-component storage.
+ *
+ * An entity is nothing more than an EntityId and a bundle of plain-data components.
+ * Entities with the same set of components share an Archetype, and systems run over
+ * the world with each() or eachBatch(), which visit every archetype matching the
+ * requested components in linear batches.
+ *
+ * Creating and destroying entities moves rows around, and so does sortRows(), so don't
+ * do any of them from inside each() or eachBatch(), and don't hold on to component pointers
+ * across those calls. Hold on to the EntityId instead, it stays valid however rows move.
+ */
+class EntityWorld
+{
+    public:
+        EntityWorld();
+
+        /**
+         * @brief Creates an entity from a bundle of components
+         *
+         * @param components The initial value of every component the entity has
+         *
+         * @return The id of the new entity
+         */
+        template<typename... Cs>
+        EntityId create(const Cs&... components)
+        {
+            const ComponentMask mask = maskOf<Cs...>();
+            int registered[] = {0, (registerComponent<Cs>(), 0)...};
+            (void)registered;
+
+            EntityId id = allocateId();
+            const int archetypeIndex = findOrCreateArchetype(mask);
+            Archetype &archetype = _archetypes.at(archetypeIndex);
+            const std::uint32_t row = archetype.pushRow(id);
+
+            _records.at(id.index).archetype = archetypeIndex;
+            _records.at(id.index).row = row;
+
+            int written[] = {0, (archetype.column<Cs>()[row] = components, 0)...};
+            (void)written;
+
+            return id;
+        }
+
+        /**
+         * @brief Records the size of component types before any entity has them, so a
+         *  snapshot holding them can be checked by loadFrom()
+         */
+        template<typename... Cs>
+        void registerComponents()
+        {
+            int registered[] = {0, (registerComponent<Cs>(), 0)...};
+            (void)registered;
+        }
+
+        /**
+         * @brief Destroys an entity and recycles its slot
+         *
+         * @param id The entity to destroy, ignored if it is no longer alive
+         */
+        void destroy(EntityId id);
+
+        /**
+         * @brief Destroys every entity
+         */
+        void clear();
+
+        /**
+         * @brief Checks if an id still refers to a live entity
+         *
+         * @param id The id to check
+         *
+         * @return true if the entity hasn't been destroyed
+         */
+        bool isAlive(EntityId id) const;
+
+        /**
+         * @brief Gets a component of an entity
+         *
+         * @param id The entity to look up
+         *
+         * @return Pointer to the component, or nullptr if the entity is gone or lacks T
+         */
+        template<typename T>
+        T* get(EntityId id)
+        {
+            if(!isAlive(id))
+            {
+                return nullptr;
+            }
+            const EntityRecord &record = _records[id.index];
+            T *column = _archetypes[record.archetype].column<T>();
+            return column == nullptr ? nullptr : column + record.row;
+        }
+
+        /**
+         * @brief Runs a function over whole columns of every matching archetype
+         *
+         * The function is called as fn(count, ids, Cs*... columns) once per archetype that
+         * has all of Cs, which lets the system write its inner loop over plain arrays.
+         *
+         * @param fn The batch function
+         * @param excluded Archetypes with any of these components are skipped, see maskOf()
+         */
+        template<typename... Cs, typename F>
+        void eachBatch(F fn, ComponentMask excluded = 0)
+        {
+            const ComponentMask mask = maskOf<Cs...>();
+            for(std::size_t i = 0; i < _archetypes.size(); i++)
+            {
+                Archetype &archetype = _archetypes[i];
+                if((archetype.getMask() & mask) != mask || (archetype.getMask() & excluded) != 0
+                        || archetype.size() == 0)
+                {
+                    continue;
+                }
+                fn(archetype.size(), archetype.getEntities().data(), archetype.column<Cs>()...);
+            }
+        }
+
+        /**
+         * @brief Runs a function on every entity that has all of Cs
+         *
+         * @param fn Called as fn(id, Cs&... components)
+         */
+        template<typename... Cs, typename F>
+        void each(F fn)
+        {
+            eachBatch<Cs...>([&fn](std::size_t count, const EntityId *ids, Cs*... columns)
+            {
+                for(std::size_t row = 0; row < count; row++)
+                {
+                    fn(ids[row], columns[row]...);
+                }
+            });
+        }
+
+        /**
+         * @brief Reorders the rows of every archetype that has all of Cs, by a key per entity
+         *
+         * Lets the entities be laid out in the order systems visit them, like by where they
+         * are on the map. Rows with equal keys keep their order, so the result only depends
+         * on the keys and the order before. Ids don't change.
+         *
+         * @param key Called as key(id, Cs&... components), returns the row's std::uint32_t key
+         */
+        template<typename... Cs, typename F>
+        void sortRows(F key)
+        {
+            const ComponentMask mask = maskOf<Cs...>();
+            for(std::size_t i = 0; i < _archetypes.size(); i++)
+            {
+                Archetype &archetype = _archetypes[i];
+                if((archetype.getMask() & mask) != mask || archetype.size() < 2)
+                {
+                    continue;
+                }
+
+                // The row goes in the low bits, which keeps the sort stable
+                const std::size_t count = archetype.size();
+                const EntityId *ids = archetype.getEntities().data();
+                gatherSortKeys(key, count, ids, archetype.column<Cs>()...);
+                if(std::is_sorted(_sortKeys.begin(), _sortKeys.end()))
+                {
+                    continue;
+                }
+                std::sort(_sortKeys.begin(), _sortKeys.end());
+
+                _rowOrder.resize(count);
+                for(std::size_t row = 0; row < count; row++)
+                {
+                    _rowOrder[row] = (std::uint32_t)_sortKeys[row];
+                }
+                archetype.reorder(_rowOrder, _sortScratch);
+
+                ids = archetype.getEntities().data();
+                for(std::size_t row = 0; row < count; row++)
+                {
+                    _records[ids[row].index].row = (std::uint32_t)row;
+                }
+            }
+        }
+
+        /**
+         * @brief Getter for the number of live entities
+         *
+         * @return Number of live entities
+         */
+        std::size_t getEntityCount() const;
+
+        /**
+         * @brief Writes every entity into a snapshot
+         *
+         *  Ids are kept as they are, so ids held elsewhere stay valid after a restore.
+         *
+         * @param snapshot Where to write to
+         */
+        void saveTo(Snapshot &snapshot) const;
+
+        /**
+         * @brief Replaces every entity with the ones in a snapshot
+         *
+         * @param snapshot Where to read from
+         *
+         * @return false if the snapshot is cut short, was written with components of a
+         *  different size or of a type this world hasn't registered, or its entity slots
+         *  don't line up with the rows they point at
+         */
+        bool loadFrom(Snapshot &snapshot);
+
+        /**
+         * @brief Builds the mask for a set of components
+         *
+         * @return Mask with the bit of every Cs set
+         */
+        template<typename... Cs>
+        static ComponentMask maskOf()
+        {
+            ComponentMask mask = 0;
+            int bits[] = {0, (mask |= ComponentMask(1) << ComponentInfo<Cs>::id, 0)...};
+            (void)bits;
+            return mask;
+        }
+
+    private:
+        /** Where an entity slot's components currently live */
+        struct EntityRecord
+        {
+            std::uint32_t generation;
+            std::int32_t archetype;
+            std::uint32_t row;
+        };
+
+        std::vector<EntityRecord> _records;
+        std::vector<std::uint32_t> _freeIndices;
+        std::vector<Archetype> _archetypes;
+        std::size_t _componentSizes[ComponentTypeCount];
+        std::size_t _entityCount;
+
+        /** Kept between sortRows() calls so sorting doesn't allocate once they're big enough */
+        std::vector<std::uint64_t> _sortKeys;
+        std::vector<std::uint32_t> _rowOrder;
+        std::vector<unsigned char> _sortScratch;
+
+        /**
+         * @brief Fills _sortKeys with key << 32 | row for every row of an archetype
+         */
+        template<typename F, typename... Cs>
+        void gatherSortKeys(F &key, std::size_t count, const EntityId *ids, Cs*... columns)
+        {
+            _sortKeys.resize(count);
+            for(std::size_t row = 0; row < count; row++)
+            {
+                _sortKeys[row] = (std::uint64_t)key(ids[row], columns[row]...) << 32 | row;
+            }
+        }
+
+        /**
+         * @brief Records the size of a component type the first time it is used
+         */
+        template<typename T>
+        void registerComponent()
+        {
+            static_assert(std::is_trivially_copyable<T>::value,
+                    "Components are moved around with memcpy and must be plain data");
+            _componentSizes[ComponentInfo<T>::id] = sizeof(T);
+        }
+
+        /**
+         * @brief Takes a free slot, or a new one if none are free
+         *
+         * @return The id for the slot
+         */
+        EntityId allocateId();
+
+        /**
+         * @brief Finds the archetype for a mask, creating it if this is the first time it's seen
+         *
+         * @param mask The components of the archetype
+         *
+         * @return Index into _archetypes
+         */
+        int findOrCreateArchetype(ComponentMask mask);
+};
@@ -0,0 +1,86 @@
+#include <cstdio>
+#include <cstdint>
+
+#include "FrameArena.h"
+
+FrameArena::FrameArena(std::size_t capacity) :
+    _block(new char[capacity]),
+    _capacity(capacity),
+    _used(0),
+    _highWater(0),
+    _spilled(0),
+    _maxSpilled(0),
+    _spilledFrames(0)
+{
+
+}
+
+FrameArena::~FrameArena()
+{
+    delete[] _block;
+}
+
+void* FrameArena::allocate(std::size_t size, std::size_t align)
+{
+    // Round the offset up to the alignment, the block itself comes from new so is aligned enough
+    const std::size_t start = (_used + align - 1) & ~(align - 1);
+    if(start + size <= _capacity)
+    {
+        _used = start + size;
+        _highWater = _used > _highWater ? _used : _highWater;
+        return _block + start;
+    }
+
+    // Out of room, keep going on the heap until the next frame
+    _spilled += size;
+    return ::operator new(size);
+}
+
+void FrameArena::deallocate(void *data)
+{
+    // Memory in the block is only given back by reset()
+    const std::uintptr_t address = (std::uintptr_t)data;
+    if(address < (std::uintptr_t)_block || address >= (std::uintptr_t)(_block + _capacity))
+    {
+        ::operator delete(data);
+    }
+}
+
+void FrameArena::reset()
+{
+    if(_spilled > 0)
+    {
+        _spilledFrames++;
+
+        // Only warn about new worst cases, a frame that always spills would flood the log
+        if(_spilled > _maxSpilled)
+        {
+            printf("ERROR: frame arena is full, a frame spilled %u bytes onto the heap on top of its %u!!\n",
+                    (unsigned)_spilled, (unsigned)_capacity);
+            _maxSpilled = _spilled;
+        }
+    }
+
+    _used = 0;
+    _spilled = 0;
+}
+
+std::size_t FrameArena::getUsed() const
+{
+    return _used;
+}
+
+std::size_t FrameArena::getHighWater() const
+{
+    return _highWater;
+}
+
+std::size_t FrameArena::getCapacity() const
+{
+    return _capacity;
+}
+
+int FrameArena::getSpilledFrames() const
+{
+    return _spilledFrames;
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+/** Linear allocator for data that only lives for one frame.
+ *
+ * Allocating is bumping an offset into one block that is allocated up front, and freeing
+ * does nothing; reset() at the top of every frame hands the whole block back at once. When a
+ * frame asks for more than the block holds, the rest spills over onto the regular heap so
+ * nothing breaks, and reset() warns about it so the block can be made bigger.
+ *
+ * Use it through FrameAllocator, e.g. FrameVector<sf::Vertex>. Nothing allocated from an
+ * arena may be kept past the next reset().
+ */
+class FrameArena
+{
+    public:
+        /**
+         * @brief Allocates the block
+         *
+         * @param capacity Size of the block in bytes
+         */
+        explicit FrameArena(std::size_t capacity);
+
+        ~FrameArena();
+
+        /**
+         * @brief Takes memory from the block, or from the heap once the block is full
+         *
+         * @param size How many bytes
+         * @param align Alignment needed, a power of two
+         *
+         * @return The memory, never nullptr
+         */
+        void* allocate(std::size_t size, std::size_t align);
+
+        /**
+         * @brief Gives memory back, only does anything for memory that spilled onto the heap
+         *
+         * @param data Memory from allocate()
+         */
+        void deallocate(void *data);
+
+        /**
+         * @brief Starts a new frame, everything allocated before is gone
+         *  Warns if this frame spilled onto the heap more than any frame before it
+         */
+        void reset();
+
+        /**
+         * @brief Getter for how much of the block the current frame has used
+         *
+         * @return Bytes used
+         */
+        std::size_t getUsed() const;
+
+        /**
+         * @brief Getter for the most of the block any frame has used
+         *
+         * @return Bytes used by the busiest frame
+         */
+        std::size_t getHighWater() const;
+
+        /**
+         * @brief Getter for the size of the block
+         *
+         * @return Bytes in the block
+         */
+        std::size_t getCapacity() const;
+
+        /**
+         * @brief Getter for how many frames spilled onto the heap
+         *
+         * @return Number of frames
+         */
+        int getSpilledFrames() const;
+
+    private:
+        char *_block;
+        std::size_t _capacity;
+        std::size_t _used;
+        std::size_t _highWater;
+
+        /** Bytes the current frame spilled onto the heap, and the most any frame has */
+        std::size_t _spilled;
+        std::size_t _maxSpilled;
+        int _spilledFrames;
+
+        FrameArena(const FrameArena&);
+        FrameArena& operator=(const FrameArena&);
+};
+
+/** STL allocator that takes its memory from a FrameArena. */
+template<typename T>
+class FrameAllocator
+{
+    public:
+        typedef T value_type;
+
+        explicit FrameAllocator(FrameArena &arena) :
+            _arena(&arena)
+        {
+
+        }
+
+        template<typename U>
+        FrameAllocator(const FrameAllocator<U> &other) :
+            _arena(other.getArena())
+        {
+
+        }
+
+        T* allocate(std::size_t count)
+        {
+            return static_cast<T*>(_arena->allocate(count * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T *data, std::size_t)
+        {
+            _arena->deallocate(data);
+        }
+
+        FrameArena* getArena() const
+        {
+            return _arena;
+        }
+
+    private:
+        FrameArena *_arena;
+};
+
+template<typename T, typename U>
+bool operator==(const FrameAllocator<T> &lhs, const FrameAllocator<U> &rhs)
+{
+    return lhs.getArena() == rhs.getArena();
+}
+
+template<typename T, typename U>
+bool operator!=(const FrameAllocator<T> &lhs, const FrameAllocator<U> &rhs)
+{
+    return lhs.getArena() != rhs.getArena();
+}
+
+/** A vector that lives in a FrameArena, for building up data that's thrown away each frame. */
+template<typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
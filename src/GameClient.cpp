@@ -0,0 +1,284 @@
+#include <cstdio>
+#include <utility>
+
+#include "GameClient.h"
+
+// How many snapshots are buffered, about 1.5 seconds worth at 20Hz
+static const int frameHistory = 32;
+
+// How many snapshot intervals behind the newest one frames are drawn. Two means one
+// snapshot can go missing without running out of things to blend between.
+static const int interpolationIntervals = 2;
+
+GameClient::GameClient() :
+    _port(0),
+    _connected(false),
+    _tickRate(60),
+    _snapshotInterval(3),
+    _frames(frameHistory),
+    _newest(-1),
+    _inputSequence(0),
+    _logging(true),
+    _bytes(0),
+    _snapshots(0),
+    _dropped(0)
+{
+    for(std::size_t i = 0; i < this->_frames.size(); i++)
+    {
+        this->_frames[i].tick = netNoTick;
+    }
+    _empty.tick = netNoTick;
+    _empty.controlling = false;
+    _empty.wave = 0;
+    _empty.enemies = 0;
+    _empty.alive = 0;
+
+    _stats.bytesPerSecond = 0;
+    _stats.snapshots = 0;
+    _stats.dropped = 0;
+    _stats.delay = 0;
+}
+
+GameClient::~GameClient()
+{
+    disconnect();
+}
+
+bool GameClient::connect(const sf::IpAddress &address, unsigned short port)
+{
+    if(this->_socket.bind(sf::Socket::AnyPort) != sf::Socket::Done)
+    {
+        printf("ERROR: client socket can not be opened!!\n");
+        return false;
+    }
+    this->_socket.setBlocking(false);
+
+    _server = address;
+    _port = port;
+
+    sf::Packet hello;
+    hello << (sf::Uint8)HelloPacket << (sf::Uint16)netProtocolVersion;
+    this->_socket.send(hello, _server, _port);
+    this->_sinceHello.restart();
+    return true;
+}
+
+void GameClient::disconnect()
+{
+    if(!_connected)
+    {
+        return;
+    }
+
+    sf::Packet bye;
+    bye << (sf::Uint8)ByePacket;
+    this->_socket.send(bye, _server, _port);
+    _connected = false;
+}
+
+bool GameClient::isConnected() const
+{
+    return _connected;
+}
+
+void GameClient::sendInput(const PlayerInput &input)
+{
+    if(!_connected)
+    {
+        return;
+    }
+
+    const std::uint32_t ack = _newest >= 0 ? this->_frames[_newest].tick : netNoTick;
+    const sf::Int8 moveX = input.move.x > 0 ? 1 : (input.move.x < 0 ? -1 : 0);
+    const sf::Int8 moveY = input.move.y > 0 ? 1 : (input.move.y < 0 ? -1 : 0);
+    const sf::Uint8 buttons = (input.dodge ? 1 : 0) | (input.attack ? 2 : 0);
+
+    this->_packet.clear();
+    this->_packet << (sf::Uint8)InputPacket << (sf::Uint32)++_inputSequence << (sf::Uint32)ack
+        << moveX << moveY << buttons;
+    this->_socket.send(this->_packet, _server, _port);
+}
+
+void GameClient::update()
+{
+    // Keep saying hello until the server hears us
+    if(!_connected && _port != 0 && this->_sinceHello.getElapsedTime() > sf::seconds(0.5f))
+    {
+        sf::Packet hello;
+        hello << (sf::Uint8)HelloPacket << (sf::Uint16)netProtocolVersion;
+        this->_socket.send(hello, _server, _port);
+        this->_sinceHello.restart();
+    }
+
+    sf::IpAddress address;
+    unsigned short port;
+    while(this->_socket.receive(this->_packet, address, port) == sf::Socket::Done)
+    {
+        sf::Uint8 type;
+        if(address != _server || port != _port || !(this->_packet >> type))
+        {
+            continue;
+        }
+        _bytes += this->_packet.getDataSize();
+
+        if(type == WelcomePacket)
+        {
+            sf::Uint16 tickRate, snapshotInterval;
+            if(this->_packet >> tickRate >> snapshotInterval && !_connected)
+            {
+                _tickRate = tickRate;
+                _snapshotInterval = snapshotInterval;
+                _connected = true;
+                printf("Connected to %s:%d\n", _server.toString().c_str(), (int)_port);
+            }
+        }
+        else if(type == SnapshotPacket && _connected)
+        {
+            if(receiveSnapshot())
+            {
+                _snapshots++;
+            }
+            else
+            {
+                _dropped++;
+            }
+        }
+    }
+
+    if(this->_statsClock.getElapsedTime() >= sf::seconds(1))
+    {
+        const float seconds = this->_statsClock.restart().asSeconds();
+        _stats.bytesPerSecond = _bytes / seconds;
+        _stats.snapshots = _snapshots;
+        _stats.dropped = _dropped;
+        _bytes = 0;
+        _snapshots = 0;
+        _dropped = 0;
+
+        if(_logging && _connected)
+        {
+            printf("Client: %.2f KB/s, %d snapshots, %d dropped, drawing %.1f ticks behind\n",
+                    _stats.bytesPerSecond / 1024, _stats.snapshots, _stats.dropped, _stats.delay);
+        }
+    }
+}
+
+bool GameClient::receiveSnapshot()
+{
+    sf::Uint32 tick, baseTick;
+    if(!(this->_packet >> tick >> baseTick))
+    {
+        return false;
+    }
+
+    // Anything older than what we have has already been drawn past
+    if(_newest >= 0 && tick <= this->_frames[_newest].tick)
+    {
+        return true;
+    }
+
+    const NetFrame *base = nullptr;
+    if(baseTick != netNoTick)
+    {
+        base = findFrame(baseTick);
+        if(base == nullptr)
+        {
+            return false;
+        }
+    }
+
+    // The base may be the oldest frame, which is the one about to be replaced
+    if(!readNetFrame(this->_packet, base, this->_incoming))
+    {
+        return false;
+    }
+    this->_incoming.tick = tick;
+
+    _newest = (_newest + 1) % (int)this->_frames.size();
+    std::swap(this->_frames[_newest], this->_incoming);
+    this->_sinceNewest.restart();
+    return true;
+}
+
+bool GameClient::interpolate(NetFrame &frame)
+{
+    if(_newest < 0)
+    {
+        return false;
+    }
+
+    // Guess where the server is now, then draw a couple of snapshots behind that
+    const NetFrame &newest = this->_frames[_newest];
+    const float serverTick = newest.tick + this->_sinceNewest.getElapsedTime().asSeconds() * _tickRate;
+    const float drawTick = serverTick - interpolationIntervals * _snapshotInterval;
+    _stats.delay = newest.tick - drawTick;
+
+    // The snapshots either side of the tick being drawn
+    const NetFrame *from = nullptr;
+    const NetFrame *to = nullptr;
+    const NetFrame *oldest = nullptr;
+    for(std::size_t i = 0; i < this->_frames.size(); i++)
+    {
+        const NetFrame &buffered = this->_frames[i];
+        if(buffered.tick == netNoTick)
+        {
+            continue;
+        }
+        if(buffered.tick <= drawTick && (from == nullptr || buffered.tick > from->tick))
+        {
+            from = &buffered;
+        }
+        if(buffered.tick > drawTick && (to == nullptr || buffered.tick < to->tick))
+        {
+            to = &buffered;
+        }
+        if(oldest == nullptr || buffered.tick < oldest->tick)
+        {
+            oldest = &buffered;
+        }
+    }
+
+    if(from == nullptr)
+    {
+        // Just joined, nothing is old enough yet
+        frame = *oldest;
+    }
+    else if(to == nullptr)
+    {
+        // Snapshots stopped coming, hold the last one instead of guessing
+        frame = *from;
+    }
+    else
+    {
+        interpolateNetFrame(*from, *to, (drawTick - from->tick) / (to->tick - from->tick), frame);
+    }
+    frame.controlling = newest.controlling;
+    return true;
+}
+
+const NetFrame& GameClient::getNewestFrame() const
+{
+    return _newest >= 0 ? this->_frames[_newest] : _empty;
+}
+
+void GameClient::setLogging(bool logging)
+{
+    _logging = logging;
+}
+
+const ClientStats& GameClient::getStats() const
+{
+    return _stats;
+}
+
+const NetFrame* GameClient::findFrame(std::uint32_t tick) const
+{
+    for(std::size_t i = 0; i < this->_frames.size(); i++)
+    {
+        if(this->_frames[i].tick == tick)
+        {
+            return &this->_frames[i];
+        }
+    }
+    return nullptr;
+}
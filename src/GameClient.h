@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <SFML/Network.hpp>
+
+#include "GameSimulation.h"
+#include "NetProtocol.h"
+
+/** Bandwidth and buffering of the client, measured over the last second. */
+struct ClientStats
+{
+    /** Bytes and snapshots received in the last second */
+    float bytesPerSecond;
+    int snapshots;
+
+    /** Snapshots that couldn't be read, because they were cut short or their base was gone */
+    int dropped;
+
+    /** How far behind the newest snapshot the frame being drawn is, in ticks */
+    float delay;
+};
+
+/** Client side of GameServer.
+ *
+ * Sends the player's input every frame and keeps a short buffer of the snapshots the server
+ * sends back. Every frame is drawn a little in the past, blended between the two snapshots
+ * either side of it, so entities move smoothly even though snapshots only arrive at 20Hz.
+ * There's no prediction, so the player's own movement lags by that delay plus the ping.
+ */
+class GameClient
+{
+    public:
+        GameClient();
+
+        ~GameClient();
+
+        /**
+         * @brief Starts joining a server, isConnected() turns true once it answers
+         *
+         * @param address Address of the server
+         * @param port Port of the server
+         *
+         * @return false if no local socket could be opened
+         */
+        bool connect(const sf::IpAddress &address, unsigned short port);
+
+        /**
+         * @brief Tells the server we're leaving
+         */
+        void disconnect();
+
+        /**
+         * @brief Checks if the server has accepted us
+         *
+         * @return true once a welcome has come back
+         */
+        bool isConnected() const;
+
+        /**
+         * @brief Sends this frame's input along with the newest snapshot we have
+         *
+         * @param input What the player wants to do
+         */
+        void sendInput(const PlayerInput &input);
+
+        /**
+         * @brief Takes in every waiting packet, and resends the hello if we're still joining
+         */
+        void update();
+
+        /**
+         * @brief Works out what the world looks like now, a little behind the server
+         *
+         * @param frame Where to put it, its storage gets reused
+         *
+         * @return false if nothing has been received yet
+         */
+        bool interpolate(NetFrame &frame);
+
+        /**
+         * @brief Getter for the newest snapshot received
+         *
+         * @return The frame, empty until one arrives
+         */
+        const NetFrame& getNewestFrame() const;
+
+        /**
+         * @brief Turns printing the stats every second on or off
+         *
+         * @param logging true to print
+         */
+        void setLogging(bool logging);
+
+        /**
+         * @brief Getter for the stats of the last full second
+         *
+         * @return The stats
+         */
+        const ClientStats& getStats() const;
+
+    private:
+        sf::UdpSocket _socket;
+        sf::IpAddress _server;
+        unsigned short _port;
+        bool _connected;
+
+        /** Server rates, from the welcome */
+        int _tickRate;
+        int _snapshotInterval;
+
+        /** Snapshots received, in the order they arrived */
+        std::vector<NetFrame> _frames;
+        int _newest;
+        std::uint32_t _inputSequence;
+
+        /** Time since the newest snapshot arrived, to estimate the server tick between them */
+        sf::Clock _sinceNewest;
+
+        /** Time since the last hello went out */
+        sf::Clock _sinceHello;
+
+        /** Where a snapshot is read into, before it replaces the oldest one buffered */
+        NetFrame _incoming;
+
+        sf::Packet _packet;
+        NetFrame _empty;
+        bool _logging;
+
+        ClientStats _stats;
+        sf::Clock _statsClock;
+        std::size_t _bytes;
+        int _snapshots;
+        int _dropped;
+
+        /**
+         * @brief Reads a snapshot packet into the buffer
+         *
+         * @return false if it couldn't be read
+         */
+        bool receiveSnapshot();
+
+        /**
+         * @brief Finds a buffered snapshot by tick
+         *
+         * @return The frame, or nullptr if it isn't buffered
+         */
+        const NetFrame* findFrame(std::uint32_t tick) const;
+};
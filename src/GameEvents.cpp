@@ -0,0 +1,58 @@
+#include "GameEvents.h"
+
+void EventBuffer::clear()
+{
+    damage.clear();
+    deaths.clear();
+    spawns.clear();
+    waves.clear();
+}
+
+void EventBuffer::reserve(std::size_t capacity)
+{
+    damage.reserve(capacity);
+    deaths.reserve(capacity);
+    spawns.reserve(capacity);
+    waves.reserve(capacity);
+}
+
+void EventBuffer::append(const EventBuffer &other)
+{
+    damage.insert(damage.end(), other.damage.begin(), other.damage.end());
+    deaths.insert(deaths.end(), other.deaths.begin(), other.deaths.end());
+    spawns.insert(spawns.end(), other.spawns.begin(), other.spawns.end());
+    waves.insert(waves.end(), other.waves.begin(), other.waves.end());
+}
+
+EventQueue::EventQueue(std::size_t capacity)
+{
+    for(int i = 0; i < EventProducerCount; i++)
+    {
+        _producers[i].reserve(capacity);
+    }
+    _events.reserve(capacity * EventProducerCount);
+}
+
+EventBuffer& EventQueue::getBuffer(EventProducer producer)
+{
+    return _producers[producer];
+}
+
+void EventQueue::merge()
+{
+    for(int i = 0; i < EventProducerCount; i++)
+    {
+        _events.append(_producers[i]);
+        _producers[i].clear();
+    }
+}
+
+void EventQueue::clear()
+{
+    _events.clear();
+}
+
+const EventBuffer& EventQueue::getEvents() const
+{
+    return _events;
+}
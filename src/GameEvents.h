@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <SFML/System/Vector2.hpp>
+
+#include "EntityWorld.h"
+
+/** Damage done to an entity, for effects like damage numbers. */
+struct DamageEvent
+{
+    /** Who took the damage */
+    EntityId target;
+
+    /** How much health they lost */
+    int amount;
+};
+
+/** An entity was killed, either by the blow that took its health to 0 or outright. */
+struct DeathEvent
+{
+    EntityId target;
+
+    /** Where it was when it died */
+    sf::Vector2<float> position;
+};
+
+/** An enemy entered the game. */
+struct SpawnEvent
+{
+    EntityId id;
+
+    /** Index of its kind in the EnemyArchetypes */
+    int archetype;
+
+    sf::Vector2<float> position;
+};
+
+/** A wave started or ended. */
+struct WaveEvent
+{
+    int wave;
+    bool started;
+};
+
+/** Every system that raises events, in the order their events come out of EventQueue::merge(). */
+enum EventProducer
+{
+    /** The player's attacks */
+    PlayerProducer,
+    /** Enemies hitting the player */
+    EnemyProducer,
+    /** Projectiles hitting anything */
+    ProjectileProducer,
+    /** Spawns and the start and end of waves */
+    WaveProducer,
+    EventProducerCount
+};
+
+/** Events of every kind, each kind in its own array so consumers go through one at a time. */
+struct EventBuffer
+{
+    std::vector<DamageEvent> damage;
+    std::vector<DeathEvent> deaths;
+    std::vector<SpawnEvent> spawns;
+    std::vector<WaveEvent> waves;
+
+    /**
+     * @brief Empties every array, keeping their storage
+     */
+    void clear();
+
+    /**
+     * @brief Makes room in every array up front
+     *
+     * @param capacity Events of each kind that fit without allocating
+     */
+    void reserve(std::size_t capacity);
+
+    /**
+     * @brief Appends every event of another buffer, kind by kind
+     *
+     * @param other The events to append
+     */
+    void append(const EventBuffer &other);
+};
+
+/** Collects the events of one tick and hands them out in a batch once it's over.
+ *
+ * Each producer writes only into its own EventBuffer, so systems never share one and could
+ * run on different threads. merge() then appends the buffers one after the other in
+ * EventProducer order. The events of a tick therefore come out in the same order however
+ * the systems were scheduled, and a replay sees exactly what the original did.
+ */
+class EventQueue
+{
+    public:
+        /**
+         * @brief Creates the queue
+         *
+         * @param capacity Events of each kind each producer can raise before allocating, some
+         *  are raised inside NoAllocZones
+         */
+        explicit EventQueue(std::size_t capacity);
+
+        /**
+         * @brief Gets the buffer a producer writes into
+         *
+         * @param producer Which producer
+         *
+         * @return Its buffer, only that producer should touch it
+         */
+        EventBuffer& getBuffer(EventProducer producer);
+
+        /**
+         * @brief Publishes everything raised since the last merge, in producer order,
+         *  and empties the producers' buffers
+         */
+        void merge();
+
+        /**
+         * @brief Throws away the published events, ready for a new tick
+         */
+        void clear();
+
+        /**
+         * @brief Getter for the published events
+         *
+         * @return Everything merged since the last clear()
+         */
+        const EventBuffer& getEvents() const;
+
+    private:
+        EventBuffer _producers[EventProducerCount];
+        EventBuffer _events;
+};
@@ -1,17 +1,41 @@
 #include "GameManager.h"
+#include "AllocTracker.h"
+#include <algorithm>
 #include <cmath>
-#include <stdexcept>
+#include <cstdio>
+#include <ctime>
 
 GameManager::GameManager() : 
     // First thing we want to do is create a window
     // TODO: Name and size subject to change
     _gameWindow {sf::VideoMode(1280, 720), "Hallowed Soul"}, 
     // Initialize the view (camera) 
-    _view {sf::FloatRect(0.0, 0.0, 1280.0 / 2.0, 720.0 / 2.0)}
+    _view {sf::FloatRect(0.0, 0.0, 1280.0 / 2.0, 720.0 / 2.0)},
+    // A different game every time it's played
+    _sim {false, (std::uint32_t)time(nullptr)},
+    // Shows the same area of the world the view does
+    _renderer {_view.getSize()},
+    _renderCounter {_gameWindow},
+    // Drawing gets 10ms of a 60fps frame, the rest is left for the game and the driver.
+    // The world is never drawn at less than half the window's resolution each way.
+    _dynamicResolution {0.010f, 0.5f},
+    // 4MB holds a minute of ticks at 60fps for waves of around 50 enemies, keyframe every second
+    _history {4 * 1024 * 1024, 3600, 60},
+    // 256KB covers the HUD bars of around a thousand enemies
+    _frameArena {256 * 1024}
 {
     // Set default game state
     // TODO: If we have a main menu, change the default state to that
     _currentState = GameState::playing;
+    _rewinding = false;
+    _rewindFrame = 0;
+    _online = false;
+    _input.move = sf::Vector2<float>(0, 0);
+    _input.dodge = false;
+    _input.attack = false;
+    _netFrame.wave = 0;
+    _netFrame.enemies = 0;
+    _netFrame.alive = 0;
 
     // This defines where our viewport is set to start
     // TODO: We will probably be spawning the player in the start of the map
@@ -21,7 +45,17 @@ GameManager::GameManager() :
     // but will take up the full size of the RenderWindow. Therefore,
     // this should zoom in on the gameWindow.
     _gameWindow.setView(_view);
-    this->_wave.setPlayer(this->_player);
+    this->_focus = this->_sim.getPlayer().getId();
+
+    // Off until turned on with F7, the world is then drawn offscreen at the window's size,
+    // or smaller when drawing runs long
+    this->_dynamicResolution.create(this->_gameWindow.getSize().x, this->_gameWindow.getSize().y);
+}
+
+bool GameManager::connect(const sf::IpAddress &address, unsigned short port)
+{
+    this->_online = this->_client.connect(address, port);
+    return this->_online;
 }
 
 void GameManager::runGame()
@@ -29,7 +63,14 @@ void GameManager::runGame()
     // Game clock for tracking time
     sf::Clock gameClock;
 
-    this->_wave.beginWave();
+    // When allocations are being tracked, they're reported once a second
+    sf::Clock allocClock;
+
+    // Online, the server runs the waves
+    if(!this->_online)
+    {
+        this->_sim.start();
+    }
 
     // Keep going while the window is open
     while(this->_gameWindow.isOpen())
@@ -37,35 +78,65 @@ void GameManager::runGame()
         // Update the game clock and get the frame time
         sf::Time frameTime = gameClock.restart();
 
+        // Whatever the last frame left in the arena is finished with
+        this->_frameArena.reset();
+
+        AllocTracker::beginFrame();
+        if(AllocTracker::isEnabled() && allocClock.getElapsedTime() >= sf::seconds(1))
+        {
+            AllocTracker::printReport();
+            allocClock.restart();
+        }
+
         // This is the main game loop, there's a specific order we want to execute our loop in
         // First we need to consider that the only thing that will change our objects is
         // input from the user, so that's the first thing we want to do
+        AllocTracker::setPhase(InputPhase);
         handleInput();
 
-        // Once input is handled, we now want to update all of our objects
-        updateEntities(frameTime);
-
-        if(!this->_player.isAlive())
+        AllocTracker::setPhase(UpdatePhase);
+        if(this->_online)
         {
-            printf("YOU DIED!!!!!\n");
-            this->_currentState = GameState::exiting;
+            updateOnline(frameTime);
         }
+        // Time stands still while rewinding, the frame shown comes from the history instead
+        else if(!this->_rewinding)
+        {
+            // Once input is handled, we now want to update all of our objects,
+            // which checks the collisions on all of our entities as well
+            updateEntities(frameTime);
 
-        // Next step is to check the collisions on all of our entities
-        checkCollisions();
+            if(!this->_sim.getPlayer().isAlive())
+            {
+                printf("YOU DIED!!!!!\n");
+                this->_currentState = GameState::exiting;
+            }
+
+            // Remember how this tick ended up, so it can be rewound to later
+            this->saveSnapshot(this->_historyFrame);
+            this->_history.record(this->_historyFrame);
+        }
 
         // Finally we want to draw the frame
-        drawFrame();
+        AllocTracker::setPhase(DrawPhase);
+        this->_renderer.updateMinimap(frameTime.asSeconds(), this->_sim, this->_focus,
+                this->_online || this->_rewinding);
+        drawFrame(frameTime);
 
         // We also want to check if the game state is exit, if it is then we break
         if(_currentState == GameState::exiting)
         {
             // Clear enemy objects
-            this->_wave.endWave();
+            this->_sim.getWave().endWave();
+            this->_client.disconnect();
             _gameWindow.close();
             break;
         }
     }
+
+    printf("Frame arena: busiest frame used %u of %u bytes, %d frames spilled onto the heap\n",
+            (unsigned)this->_frameArena.getHighWater(), (unsigned)this->_frameArena.getCapacity(),
+            this->_frameArena.getSpilledFrames());
 }
 
 void GameManager::handleInput()
@@ -97,34 +168,49 @@ void GameManager::handleInput()
         }
     }       
 
+    // While rewinding the arrow keys scrub through time instead of moving the player
+    if(this->_rewinding)
+    {
+        if(sf::Keyboard::isKeyPressed(sf::Keyboard::Left))
+        {
+            this->scrubHistory(-1);
+        }
+        if(sf::Keyboard::isKeyPressed(sf::Keyboard::Right))
+        {
+            this->scrubHistory(1);
+        }
+        return;
+    }
+
     // The following four if statements will tell the player it needs to be moving
     // in the direction based off of the directional keys pressed.
     // We are using all ifs here because we want diagonal movement to be possible
     // Additionally, we're not using the above loop to check because we don't just want to
     // move up when the up key is pressed, we want to continue moving up while whenever the
     // up key is held, this solves that issue
+    this->_input.move = sf::Vector2<float>(0, 0);
     if(sf::Keyboard::isKeyPressed(sf::Keyboard::Up))
     {
         // Up is negative y direction
-        this->_player.moveInDirection(sf::Vector2<float>(0, -1));
+        this->_input.move.y -= 1;
     }
 
     if(sf::Keyboard::isKeyPressed(sf::Keyboard::Down))
     {
         // Down is positive y direction
-        this->_player.moveInDirection(sf::Vector2<float>(0, 1));
+        this->_input.move.y += 1;
     }
     
     if(sf::Keyboard::isKeyPressed(sf::Keyboard::Left))
     {
         // Left is negative x direction
-        this->_player.moveInDirection(sf::Vector2<float>(-1, 0));
+        this->_input.move.x -= 1;
     }
 
     if(sf::Keyboard::isKeyPressed(sf::Keyboard::Right))
     {
         // Right is positive x direction
-        this->_player.moveInDirection(sf::Vector2<float>(1, 0));
+        this->_input.move.x += 1;
     }
 
 }
@@ -133,39 +219,69 @@ void GameManager::handleKeyboardEvent(sf::Event &kdbEvent)
 {
     switch(kdbEvent.key.code)
     {
+        case sf::Keyboard::F5:
+        {
+            // Quick save to the checkpoint file
+            this->saveSnapshot(this->_checkpoint);
+            this->_checkpoint.saveToFile("checkpoint.hss");
+            break;
+        }
+        case sf::Keyboard::F9:
+        {
+            // Quick load from the checkpoint file
+            if(this->_checkpoint.loadFromFile("checkpoint.hss") && !this->restoreSnapshot(this->_checkpoint))
+            {
+                printf("ERROR: checkpoint is corrupt or from another version!!\n");
+                this->_currentState = GameState::exiting;
+            }
+            break;
+        }
+        case sf::Keyboard::F3:
+        {
+            this->_statsOverlay.toggle();
+            break;
+        }
+        case sf::Keyboard::F7:
+        {
+            this->_dynamicResolution.setEnabled(!this->_dynamicResolution.isEnabled());
+            break;
+        }
+        case sf::Keyboard::F6:
+        {
+            // Dump the recent history for debugging
+            this->_history.dumpToFile("history.hsh");
+            break;
+        }
+        case sf::Keyboard::R:
+        {
+            this->toggleRewind();
+            break;
+        }
         case sf::Keyboard::Space:
         {
-            this->_player.dodgeInDirection(sf::Vector2<float>(0, 0));
+            this->_input.dodge = true;
             break;
         }
         case sf::Keyboard::Backspace:
         {
-            // THE KILL BUTTON
-            for(int i=0; i<this->_wave.getEnemies(); i++)
+            // THE KILL BUTTON, only for local games
+            WaveManager &wave = this->_sim.getWave();
+            EntityWorld &world = this->_sim.getWorld();
+            for(int i=0; i<wave.getEnemies() && !this->_online; i++)
             {
-                try
-                {
-                    if(this->_wave.getEnemy(i)->isAlive())
-                    {
-                        this->_wave.getEnemy(i)->kill();
-                        break;
-                    }
-                }
-                catch(const std::exception& e)
+                // Enemies still to come in have no id yet, and never count as alive
+                const EntityId enemy = wave.getEnemy(i);
+                // Its death bursts with the rest of the next tick's
+                if(isAlive(world, enemy))
                 {
+                    this->_sim.kill(enemy);
                     break;
                 }
             }
         }
         case sf::Keyboard::LShift:
         {
-            Entity* hitEnemy = this->rayCast(this->_player,
-                    this->_player.getLastMoveDirection() * this->_player.getAttackRange());
-
-            if(hitEnemy != nullptr)
-            {
-                this->_player.attack(hitEnemy);
-            }
+            this->_input.attack = true;
         }
         default:
             // Do nothing
@@ -173,225 +289,191 @@ void GameManager::handleKeyboardEvent(sf::Event &kdbEvent)
     }
 }
 
-void GameManager::handleMouseEvent(sf::Event &mouseEvent)
+void GameManager::saveSnapshot(Snapshot &snapshot)
 {
-    // TODO: Do we need this?
-    // If we implement menus we will, but consider remove otherwise
+    snapshot.beginWrite();
+    snapshot.write((std::int32_t)this->_currentState);
+    this->_sim.saveTo(snapshot);
 }
 
-void GameManager::checkCollisions()
+bool GameManager::restoreSnapshot(Snapshot &snapshot)
 {
-    // TODO: Check for collision between dynamic entities and other entities
-}
-
-void GameManager::updateEntities(sf::Time frameTime)
-{
-    // TODO: Update other entities
+    std::int32_t state;
+    if(!snapshot.beginRead() || !snapshot.read(state) || state < playing || state > exiting)
+    {
+        return false;
+    }
 
-    // Update player
-    this->_player.update(frameTime.asSeconds());
+    if(!this->_sim.loadFrom(snapshot))
+    {
+        return false;
+    }
 
-    // Update the enemy wave manager 
-    this->_wave.update(frameTime.asSeconds());
+    // Effects aren't part of the game state, they just get dropped
+    this->_currentState = (GameState)state;
+    this->_renderer.clearEffects();
+    return true;
 }
 
-void GameManager::drawFrame()
+void GameManager::toggleRewind()
 {
-    // Clear current buffer
-    _gameWindow.clear();
-
-    // Now update the position of the view as nessisary.
-    updateViewLocked();
-
-    // Draw the temporary background before anything else
-    drawMap();
-
-    // Drawing an entity has two steps: calling the onDraw method to update the entity's sprite
-    // and calling the game window draw function
-    this->_player.onDraw();
-    this->_wave.waveDraw();
-    this->_gameWindow.draw(this->_player.getSprite());
-    for(int i=0; i<this->_wave.getEnemies(); i++)
+    if(!this->_rewinding)
     {
-        if(this->_wave.getEnemy(i)->isAlive())
+        if(this->_history.size() == 0)
         {
-            this->_gameWindow.draw(this->_wave.getEnemy(i)->getSprite());
+            return;
         }
+        this->_rewinding = true;
+        this->_rewindFrame = this->_history.size() - 1;
+        return;
     }
-    // TODO: Add other entities
-
-    // Draw the HUD over most things
-    drawHealthHUD();
-    drawEnemyHealth();
-    drawRoundProgressHUD();
 
-    // Finally, display the window
-    _gameWindow.display();    
+    // Whatever came after the tick we rewound to never happened now
+    this->_rewinding = false;
+    this->_history.truncate(this->_rewindFrame + 1);
 }
 
-void GameManager::updateViewLocked()
+void GameManager::scrubHistory(int ticks)
 {
-    sf::View view = _gameWindow.getView();
-    const sf::Vector2f &playerLocation = this->_player.getPosition();
-    const sf::Vector2f &viewSize = _view.getSize();
-    sf::Vector2f mapSize{1500.0, 1125.0}; // this can probably be moved to a member variable later when the map is made.
-
-    view.setCenter(this->_player.getPosition());
-
-    if (playerLocation.x < viewSize.x / 2) // If camera view is extends past left side of the map.
-    {
-        view.setCenter(sf::Vector2f{viewSize.x / 2, view.getCenter().y});
-    }
-    else if (playerLocation.x + viewSize.x / 2 > mapSize.x) // If camera view is extends past right side of the map.
-    {
-        view.setCenter(sf::Vector2f{mapSize.x - (viewSize.x / 2), view.getCenter().y});
-    }
-
-    if (playerLocation.y < viewSize.y / 2) // If camera view is extends past top side of the map.
-    {
-        view.setCenter(sf::Vector2f{view.getCenter().x, viewSize.y / 2});
-    }
-    else if (playerLocation.y + viewSize.y / 2 > mapSize.y) // If camera view is extends past bottom side of the map.
+    this->_rewindFrame = std::max(0, std::min(this->_history.size() - 1, this->_rewindFrame + ticks));
+    if(!this->_history.getFrame(this->_rewindFrame, this->_historyFrame)
+            || !this->restoreSnapshot(this->_historyFrame))
     {
-        view.setCenter(sf::Vector2f{view.getCenter().x, mapSize.y - (viewSize.y / 2)});
+        printf("ERROR: history tick %d can not be restored!!\n", this->_rewindFrame);
     }
-
-    _gameWindow.setView(view);
 }
 
-void GameManager::drawMap()
+void GameManager::handleMouseEvent(sf::Event &mouseEvent)
 {
-    sf::Texture texture;
-    texture.loadFromFile("assets/textures/temp_floor_128.png");
-    texture.setRepeated(true);
-
-    sf::IntRect rectSourceSprite(0, 0, 1500, 1125);
-    sf::Sprite sprite(texture, rectSourceSprite);
-
-    this->_gameWindow.draw(sprite);
+    // TODO: Do we need this?
+    // If we implement menus we will, but consider remove otherwise
 }
 
-void GameManager::drawHealthHUD()
+void GameManager::updateEntities(sf::Time frameTime)
 {
-    const int lineSize = 2;
-    const sf::Vector2<float> viewCenter = _gameWindow.getView().getCenter();
-    const sf::Vector2<float> &viewSize = _view.getSize();
-    const sf::Vector2<float> barOutterSize{100.f, 10.f};
-    const sf::Vector2<float> barInnerSize{barOutterSize.x * ((float)_player.getHealth() / 100), barOutterSize.y};
-    const sf::Vector2<int> padding{5 + lineSize, 5 + lineSize};
-    const sf::Vector2<float> barPosition{viewCenter.x + padding.x - (viewSize.x / 2), viewCenter.y - padding.y - barOutterSize.y + viewSize.y / 2};
-
-    // This is the outside grey/black rectangle.
-    sf::RectangleShape outsideRect(barOutterSize);
-    outsideRect.setPosition(barPosition);
-    outsideRect.setFillColor(sf::Color(45, 45, 45, 255));
-    outsideRect.setOutlineColor(sf::Color::Black);
-    outsideRect.setOutlineThickness(lineSize);
-    _gameWindow.draw(outsideRect);
-
-    // This is the inside red rectangle.
-    sf::RectangleShape insideRect(barInnerSize);
-    insideRect.setPosition(barPosition);
-    insideRect.setFillColor(sf::Color(255, 0, 0, 255));
-    _gameWindow.draw(insideRect);
-}
+    // The player acts on this frame's input, then everything moves and collides
+    EntityId hitEnemy = this->_sim.applyInput(this->_input);
+    this->_input.dodge = false;
+    this->_input.attack = false;
+    this->_sim.step(frameTime.asSeconds());
+
+    EntityWorld &world = this->_sim.getWorld();
+    if(hitEnemy.isValid())
+    {
+        this->_renderer.getParticles().burst(ParticleSystem::hitEffect, world.get<Transform>(hitEnemy)->position);
+    }
 
-void GameManager::drawEnemyHealth()
-{
-    for(int i=0; i<this->_wave.getEnemies(); i++)
+    // Everything that just died goes out with a burst
+    const EventBuffer &events = this->_sim.getEvents();
+    for(std::size_t i = 0; i < events.deaths.size(); i++)
     {
-        if(this->_wave.getEnemy(i)->isAlive())
+        this->_renderer.getParticles().burst(ParticleSystem::deathEffect, events.deaths[i].position);
+    }
+
+    // Everything that took damage gets a number over it, red when it's the player
+    const std::vector<DamageEvent> &damaged = events.damage;
+    for(std::size_t i = 0; i < damaged.size(); i++)
+    {
+        const Transform *transform = world.get<Transform>(damaged[i].target);
+        if(transform != nullptr)
         {
-            _gameWindow.draw(this->_wave.getHealthBarBorder(this->_wave.getEnemy(i)));
-            _gameWindow.draw(this->_wave.getHealthBar(this->_wave.getEnemy(i)));
+            const bool player = damaged[i].target == this->_focus;
+            this->_renderer.getDamageNumbers().spawn(transform->position - sf::Vector2<float>(0, 20), damaged[i].amount,
+                    player ? sf::Color(255, 60, 60) : sf::Color(255, 230, 140));
         }
     }
+
+    // Effects move on their own
+    this->_renderer.updateEffects(frameTime.asSeconds());
 }
 
-void GameManager::drawRoundProgressHUD()
+void GameManager::updateOnline(sf::Time frameTime)
 {
-    float enemiesAlive = (float)this->_wave.getEnemiesAlive();
-    float totalEnemies = (float)this->_wave.getEnemies();
-    int currWave = this->_wave.getWave();
-
-    const int lineSize = 2;
-    const sf::Vector2<float> viewCenter = _gameWindow.getView().getCenter();
-    const sf::Vector2<float> &viewSize = _view.getSize();
-    const sf::Vector2<float> barOutterSize{100.f, 5.f};
-    const sf::Vector2<float> barInnerSize{barOutterSize.x * (enemiesAlive / totalEnemies), barOutterSize.y};
-    const sf::Vector2<int> padding{2 + lineSize, 2 + lineSize};
-    const sf::Vector2<float> barPosition{viewCenter.x - padding.x - barOutterSize.x / 2, viewCenter.y + padding.y + barOutterSize.y - viewSize.y / 2};
-
-    // This is the outside grey/black rectangle.
-    sf::RectangleShape outsideRect(barOutterSize);
-    outsideRect.setPosition(barPosition);
-    outsideRect.setFillColor(sf::Color(45, 45, 45, 255));
-    outsideRect.setOutlineColor(sf::Color::Black);
-    outsideRect.setOutlineThickness(lineSize);
-    _gameWindow.draw(outsideRect);
-
-    // This is the inside purple rectangle.
-    sf::RectangleShape insideRect(barInnerSize);
-    insideRect.setPosition(barPosition);
-    insideRect.setFillColor(sf::Color(128, 0, 187, 255));
-    _gameWindow.draw(insideRect);
-
-    sf::Text text;
-    sf::Font font;
-
-    if (!font.loadFromFile("fonts/Helvetica.ttf"))
+    this->_client.sendInput(this->_input);
+    this->_input.dodge = false;
+    this->_input.attack = false;
+    this->_client.update();
+
+    if(!this->_client.interpolate(this->_netFrame))
     {
-        printf("ERROR: font can not be loaded!!");
+        return;
     }
 
-    // Current wave number text
-    text.setFont(font);
-    text.setString(std::to_string(currWave));
-    text.setCharacterSize(lineSize * 2 + barOutterSize.y);
-    text.setFillColor(sf::Color::White);
-    text.setOutlineColor(sf::Color::Black);
-    text.setOutlineThickness(1);
+    // Rebuild the world from the server's entities, so everything is drawn the same way as offline.
+    // Enemies get a brain only so their health bars know which archetype they are.
+    EntityWorld &world = this->_sim.getWorld();
+    world.clear();
+    for(std::size_t i = 0; i < this->_netFrame.entities.size(); i++)
+    {
+        const NetEntity &entity = this->_netFrame.entities[i];
+        Transform transform = {getNetPosition(entity), sf::Vector2<float>(0, 0)};
+        Health health = {entity.health, (entity.flags & NetAlive) != 0};
+        SpriteRef sprite = {entity.sprite};
 
-    text.setPosition(sf::Vector2f{barPosition.x - padding.x - (text.getGlobalBounds().left + text.getGlobalBounds().width), barPosition.y + lineSize - (text.getGlobalBounds().top + text.getGlobalBounds().height) / 2});
-    _gameWindow.draw(text);
+        if(entity.flags & NetEnemy)
+        {
+            EnemyBrain brain = {0, entity.archetype, 0, 0};
+            world.create(transform, health, sprite, brain);
+        }
+        else
+        {
+            EntityId id = world.create(transform, health, sprite);
+            if((entity.flags & NetPlayer) != 0)
+            {
+                this->_focus = id;
+            }
+        }
+    }
+
+    this->_renderer.updateEffects(frameTime.asSeconds());
 }
 
-Entity* GameManager::rayCast(Entity &source, const sf::Vector2<float> &ray)
+void GameManager::drawFrame(sf::Time frameTime)
 {
-    // TODO: Add other entities
-    std::vector<Enemy*> enemies = this->_wave.getEnemiesVec();  
-    
-    // Let's get the center point for the source
-    sf::Vector2<float> sourceCenter(source.getPosition().x + source.getWidth() / 2.0,
-        source.getPosition().y + source.getHeight() / 2.0);
-
-    for(int i = 0; i < enemies.size(); i++)
-    {
-        Enemy* currentEnemy = enemies.at(i);
-
-        // Skip this loop is enemy is dead
-        if(!currentEnemy->isAlive())
-            continue;
+    // Clear current buffer
+    _gameWindow.clear();
 
-        // First thing we want to do is get the closest point on the entity we're checking to our current point
-        float dx = std::min(currentEnemy->getPosition().x + currentEnemy->getWidth(), currentEnemy->getPosition().x);
-        float dy = std::min(currentEnemy->getPosition().y + currentEnemy->getHealth(), currentEnemy->getPosition().y);
+    // Online the HUD shows the server's wave
+    WaveManager &wave = this->_sim.getWave();
+    RoundInfo round;
+    round.wave = this->_online ? this->_netFrame.wave : wave.getWave();
+    round.enemies = this->_online ? this->_netFrame.enemies : wave.getEnemies();
+    round.alive = this->_online ? this->_netFrame.alive : wave.getEnemiesAlive();
 
-        // Now we can get get the closest point
-        sf::Vector2<float> enemyPoint(dx, dy);
+    this->_renderCounter.reset();
+    const sf::View view = this->_renderer.getView(this->_sim, this->_focus);
 
-        // Now we get the end point
-        sf::Vector2<float> endRayPoint = source.getPosition() + ray;
+    // Only drawing is timed for dynamic resolution, stepping the game and waiting in
+    // display() don't get any cheaper with fewer pixels
+    sf::Clock renderClock;
+    if(this->_dynamicResolution.isEnabled())
+    {
+        // The world goes offscreen at whatever resolution the render time allows, then gets
+        // stretched over the window
+        this->_renderCounter.setTarget(this->_dynamicResolution.begin(view));
+        this->_renderer.drawWorld(this->_renderCounter, this->_sim);
+        this->_renderCounter.setTarget(this->_gameWindow);
+        this->_dynamicResolution.present(this->_renderCounter);
+    }
+    else
+    {
+        _gameWindow.setView(view);
+        this->_renderer.drawWorld(this->_renderCounter, this->_sim);
+    }
 
-        // TODO: This is wrong, it doesn't entirely get the idea together
-        // Now we check to see if it's hit this object
-        if(abs(endRayPoint.x - source.getPosition().x) > abs(source.getPosition().x - enemyPoint.x) && 
-                (abs(endRayPoint.y - source.getPosition().y) > abs(source.getPosition().y - enemyPoint.y)))
-        {
-            // Here it has intersected the box of the other entity, so we do the thing now
-            return currentEnemy; 
-        }
+    // The HUD always goes straight into the window, at its full resolution
+    _gameWindow.setView(view);
+    this->_renderer.drawHud(this->_renderCounter, this->_sim, this->_focus, round, this->_frameArena);
+    if(this->_dynamicResolution.isEnabled())
+    {
+        this->_dynamicResolution.addFrame(renderClock.getElapsedTime().asSeconds());
     }
 
-    return nullptr;
+    // The overlay shows what the game drew, so it's recorded before the overlay draws itself
+    this->_statsOverlay.addFrame(frameTime, this->_renderCounter.getCounts(),
+            this->_renderer.getParticles().getStats(), this->_dynamicResolution.isEnabled() ? this->_dynamicResolution.getScale() : 1);
+    this->_statsOverlay.draw(this->_renderCounter);
+
+    // Finally, display the window
+    _gameWindow.display();
 }
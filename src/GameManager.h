@@ -1,9 +1,14 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
-#include "Player.h"
-#include "GameManager.h"
-#include "WaveManager.h"
+#include "GameSimulation.h"
+#include "GameClient.h"
+#include "GameRenderer.h"
+#include "RenderStatsOverlay.h"
+#include "DynamicResolution.h"
+#include "Snapshot.h"
+#include "StateHistory.h"
+#include "FrameArena.h"
 
 /** Enum representing the game state. */
 enum GameState
@@ -21,11 +26,11 @@ enum GameState
     exiting
 };
 
-/** Class which handles the main loop, timing, and game logic. 
+/** Class which handles the main loop, timing, input and drawing.
  * 
- * Calls drawing and updating functions explicitly on the Player and non-enemy Entities.
- * Enemies are fully handled and owned by WaveManager; GameManager calls WaveManager's
- * drawing and updating functions to control Enemies.
+ * The game itself lives in a GameSimulation. Played locally, GameManager steps it every
+ * frame. Connected to a GameServer, the simulation is never stepped; its world is rebuilt
+ * every frame from the snapshots the server sends, and only used to draw from.
  */
 class GameManager
 {
@@ -40,7 +45,31 @@ class GameManager
          */
         void runGame();
 
-        Entity* rayCast(Entity &source, const sf::Vector2<float> &rayDir);
+        /**
+         * @brief Plays on a server instead of locally, call before runGame()
+         *
+         * @param address Address of the server
+         * @param port Port of the server
+         *
+         * @return false if the connection couldn't be started
+         */
+        bool connect(const sf::IpAddress &address, unsigned short port);
+
+        /**
+         * @brief Captures the whole game state (entities, wave, projectiles and game state)
+         *
+         * @param snapshot Where to write the state, its storage gets reused
+         */
+        void saveSnapshot(Snapshot &snapshot);
+
+        /**
+         * @brief Puts the game back into the state captured in a snapshot
+         *
+         * @param snapshot A snapshot from saveSnapshot()
+         *
+         * @return false if the snapshot can't be read, the game state is then undefined
+         */
+        bool restoreSnapshot(Snapshot &snapshot);
 
     private:
         /** The window we are displaying in */
@@ -52,11 +81,53 @@ class GameManager
         /** The current game state. */
         GameState _currentState;
 
-        /** The player. */
-        Player _player;
+        /** The world, the player and the enemy waves. */
+        GameSimulation _sim;
+
+        /** Draws the simulation, the effects and the HUD. */
+        GameRenderer _renderer;
+
+        /** Everything drawn into the window goes through this, to count it. */
+        RenderCounter _renderCounter;
+
+        /** Draw counts and frame times, toggled with F3. */
+        RenderStatsOverlay _statsOverlay;
+
+        /** Draws the world at a lower resolution when drawing runs long, off until F7 turns it on. */
+        DynamicResolution _dynamicResolution;
+
+        /** Reused buffer for checkpoint saves and loads. */
+        Snapshot _checkpoint;
+
+        /** The last minute of game state, one tick per frame. */
+        StateHistory _history;
+
+        /** Reused buffer for recording into and rewinding from the history. */
+        Snapshot _historyFrame;
+
+        /** Whether the game is paused and scrubbing through the history. */
+        bool _rewinding;
+
+        /** The tick of the history being shown while rewinding. */
+        int _rewindFrame;
 
-        /** The WaveManager, which owns all Enemies. */
-        WaveManager _wave;
+        /** Input gathered this frame, presses stay set until the frame is over. */
+        PlayerInput _input;
+
+        /** Connection to the server, when playing online. */
+        GameClient _client;
+
+        /** Whether we're playing on a server. */
+        bool _online;
+
+        /** What the server looks like this frame, when playing online. */
+        NetFrame _netFrame;
+
+        /** The entity the camera and health HUD follow. */
+        EntityId _focus;
+
+        /** Scratch memory for the current frame, emptied at the top of every loop. */
+        FrameArena _frameArena;
 
         /**
          * @brief Called from main loop, turns all the user inputs into game instructions
@@ -89,40 +160,31 @@ class GameManager
         void updateEntities(sf::Time frameTime);
 
         /**
-         * @brief Called from main loop,
-         *  will check for collisions between entities and objects
+         * @brief Called from handleKeyboardEvent(), pauses the game and starts scrubbing
+         *  through the history, or carries on playing from the tick that was rewound to
          */
-        void checkCollisions();
-        
-        /**
-         * @brief Called from main game loop,
-         *  will render all of our objects and entities to the view
-         */
-        void drawFrame();
+        void toggleRewind();
 
         /**
-         * @brief Called from drawFrame(),
-         *  will move the current view based off of the player's location
+         * @brief Called from handleInput() while rewinding, moves through the history
+         *
+         * @param ticks How many ticks to move, negative goes back in time
          */
-        void updateViewLocked();
+        void scrubHistory(int ticks);
 
         /**
-         * @brief Called from drawFrame(),
-         *  Temporary function to draw a basic background of our map
-         */
-        void drawMap();
-    
-        /**
-         * @brief Called from drawFrame(),
-         *  Draw the players health heads up display
+         * @brief Called from the main game loop when playing online,
+         *  sends the inputs and rebuilds the world from what the server sent back
+         *
+         * @param frameTime The time between the last frame and this one
          */
-        void drawHealthHUD();
-
-        void drawEnemyHealth();
-
+        void updateOnline(sf::Time frameTime);
+        
         /**
-         * @brief Called from drawFrame(),
-         *  Draw a heads up display on the current round information
+         * @brief Called from main game loop,
+         *  will render all of our objects and entities to the view
+         *
+         * @param frameTime The time between the last frame and this one, for the stats overlay
          */
-        void drawRoundProgressHUD();
+        void drawFrame(sf::Time frameTime);
 };
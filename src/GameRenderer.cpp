@@ -0,0 +1,255 @@
+#include <cstdio>
+
+#include "GameRenderer.h"
+#include "AssetArchive.h"
+
+GameRenderer::GameRenderer(sf::Vector2<float> viewSize) :
+    _viewSize(viewSize),
+    // Up to 16k particles alive, no more than 2k new ones a frame
+    _particles {16384, 2048},
+    // A few hundred numbers is a busy wave, the rest just don't show
+    _damageNumbers {1024},
+    // Redrawn 5 times a second, 4 enemies to a cell is as crowded as it shows
+    _minimap {5, 4},
+    _waveTextWave(-1)
+{
+    // Load what the HUD and map are drawn with once, instead of every frame
+    if(!loadAsset(this->_floorTexture, "assets/textures/temp_floor_128.png"))
+    {
+        printf("ERROR: floor texture can not be loaded!!\n");
+    }
+    this->_floorTexture.setRepeated(true);
+
+    if(!loadAsset(this->_font, "fonts/Helvetica.ttf"))
+    {
+        printf("ERROR: font can not be loaded!!\n");
+    }
+    this->_waveText.setFont(this->_font);
+    this->_waveText.setFillColor(sf::Color::White);
+    this->_waveText.setOutlineColor(sf::Color::Black);
+    this->_waveText.setOutlineThickness(1);
+
+    // Damage numbers only ever need digits, rasterized big enough to stay sharp when zoomed in
+    this->_glyphs.load("fonts/Helvetica.ttf", "0123456789", 24, 2);
+
+    // Same shape as the map, at a pixel per view unit of where draw() puts it
+    this->_minimap.create(120, 90);
+}
+
+void GameRenderer::updateEffects(float deltaTime)
+{
+    this->_particles.update(deltaTime);
+    this->_damageNumbers.update(deltaTime);
+}
+
+void GameRenderer::updateMinimap(float deltaTime, GameSimulation &sim, EntityId focus, bool rebuildGrid)
+{
+    if(!this->_minimap.advance(deltaTime))
+    {
+        return;
+    }
+
+    // The grid is only built when the simulation steps, so a world rebuilt from the server
+    // or restored from the history needs indexing first
+    SpatialGrid &grid = sim.getGrid();
+    if(rebuildGrid)
+    {
+        grid.build(sim.getWorld(), sim.getTextures());
+    }
+
+    const Transform *transform = sim.getWorld().get<Transform>(focus);
+    this->_minimap.render(grid, transform != nullptr ? transform->position : sf::Vector2<float>(0, 0));
+}
+
+void GameRenderer::draw(RenderCounter &target, GameSimulation &sim, EntityId focus, const RoundInfo &round,
+        FrameArena &arena)
+{
+    // Now update the position of the view as nessisary.
+    target.getTarget().setView(getView(sim, focus));
+    drawWorld(target, sim);
+    drawHud(target, sim, focus, round, arena);
+}
+
+void GameRenderer::drawWorld(RenderCounter &target, GameSimulation &sim)
+{
+    // Draw the temporary background before anything else
+    drawMap(target);
+
+    // Every entity with a sprite, player and enemies alike, gets batched and drawn together
+    this->_sprites.build(sim.getWorld(), sim.getTextures());
+    this->_sprites.draw(target, sim.getTextures());
+    sim.getProjectiles().draw(target);
+    this->_particles.draw(target);
+}
+
+void GameRenderer::drawHud(RenderCounter &target, GameSimulation &sim, EntityId focus, const RoundInfo &round,
+        FrameArena &arena)
+{
+    const sf::View &view = target.getTarget().getView();
+
+    // Damage numbers are text, so they go with the HUD and stay sharp
+    this->_damageNumbers.draw(target, this->_glyphs);
+
+    // Draw the HUD over most things. Every bar is a few quads in one list that only lives
+    // for this frame, so they all go out in one draw call without touching the heap.
+    FrameVector<sf::Vertex> hud {FrameAllocator<sf::Vertex>(arena)};
+    hud.reserve((sim.getWorld().getEntityCount() + 2) * 12);
+    drawHealthHUD(hud, view, sim.getWorld().get<Health>(focus));
+    drawEnemyHealth(hud, sim);
+    drawRoundProgressHUD(hud, view, round);
+    target.draw(hud.data(), hud.size(), sf::Quads);
+    target.draw(this->_waveText);
+
+    // The minimap sits in the top right corner of the view
+    const sf::Vector2<float> viewCenter = view.getCenter();
+    const sf::Vector2<float> minimapSize(120, 90);
+    this->_minimap.draw(target, sf::FloatRect(viewCenter.x + this->_viewSize.x / 2 - minimapSize.x - 5,
+            viewCenter.y - this->_viewSize.y / 2 + 5, minimapSize.x, minimapSize.y));
+}
+
+void GameRenderer::clearEffects()
+{
+    this->_particles.clear();
+    this->_damageNumbers.clear();
+}
+
+ParticleSystem& GameRenderer::getParticles()
+{
+    return this->_particles;
+}
+
+DamageNumbers& GameRenderer::getDamageNumbers()
+{
+    return this->_damageNumbers;
+}
+
+sf::View GameRenderer::getView(GameSimulation &sim, EntityId focusId) const
+{
+    // Nothing to follow until the server has told us where the player is, so show the corner
+    sf::View view(sf::FloatRect(0, 0, this->_viewSize.x, this->_viewSize.y));
+    const Transform *focus = sim.getWorld().get<Transform>(focusId);
+    if(focus == nullptr)
+    {
+        return view;
+    }
+
+    const sf::Vector2f &playerLocation = focus->position;
+    const sf::Vector2f &viewSize = this->_viewSize;
+    sf::Vector2f mapSize{GameSimulation::mapBounds.width, GameSimulation::mapBounds.height};
+
+    view.setCenter(playerLocation);
+
+    if (playerLocation.x < viewSize.x / 2) // If camera view is extends past left side of the map.
+    {
+        view.setCenter(sf::Vector2f{viewSize.x / 2, view.getCenter().y});
+    }
+    else if (playerLocation.x + viewSize.x / 2 > mapSize.x) // If camera view is extends past right side of the map.
+    {
+        view.setCenter(sf::Vector2f{mapSize.x - (viewSize.x / 2), view.getCenter().y});
+    }
+
+    if (playerLocation.y < viewSize.y / 2) // If camera view is extends past top side of the map.
+    {
+        view.setCenter(sf::Vector2f{view.getCenter().x, viewSize.y / 2});
+    }
+    else if (playerLocation.y + viewSize.y / 2 > mapSize.y) // If camera view is extends past bottom side of the map.
+    {
+        view.setCenter(sf::Vector2f{view.getCenter().x, mapSize.y - (viewSize.y / 2)});
+    }
+
+    return view;
+}
+
+void GameRenderer::drawMap(RenderCounter &target)
+{
+    sf::IntRect rectSourceSprite(0, 0, 1500, 1125);
+    sf::Sprite sprite(this->_floorTexture, rectSourceSprite);
+
+    target.draw(sprite);
+}
+
+// Adds a rectangle as a quad, with an optional outline around the outside like sf::RectangleShape
+static void appendRect(FrameVector<sf::Vertex> &vertices, sf::Vector2<float> position,
+        sf::Vector2<float> size, sf::Color color, float outline = 0, sf::Color outlineColor = sf::Color::Black)
+{
+    if(outline > 0)
+    {
+        appendRect(vertices, position - sf::Vector2<float>(outline, outline),
+                size + sf::Vector2<float>(outline * 2, outline * 2), outlineColor);
+    }
+    vertices.push_back(sf::Vertex(position, color));
+    vertices.push_back(sf::Vertex(sf::Vector2<float>(position.x + size.x, position.y), color));
+    vertices.push_back(sf::Vertex(position + size, color));
+    vertices.push_back(sf::Vertex(sf::Vector2<float>(position.x, position.y + size.y), color));
+}
+
+void GameRenderer::drawHealthHUD(FrameVector<sf::Vertex> &hud, const sf::View &view, const Health *health)
+{
+    const int lineSize = 2;
+    const sf::Vector2<float> viewCenter = view.getCenter();
+    const sf::Vector2<float> &viewSize = this->_viewSize;
+    const sf::Vector2<float> barOutterSize{100.f, 10.f};
+    const sf::Vector2<float> barInnerSize{barOutterSize.x * ((health != nullptr ? health->health : 0) / 100.f), barOutterSize.y};
+    const sf::Vector2<int> padding{5 + lineSize, 5 + lineSize};
+    const sf::Vector2<float> barPosition{viewCenter.x + padding.x - (viewSize.x / 2), viewCenter.y - padding.y - barOutterSize.y + viewSize.y / 2};
+
+    // This is the outside grey/black rectangle.
+    appendRect(hud, barPosition, barOutterSize, sf::Color(45, 45, 45, 255), lineSize);
+
+    // This is the inside red rectangle.
+    appendRect(hud, barPosition, barInnerSize, sf::Color(255, 0, 0, 255));
+}
+
+void GameRenderer::drawEnemyHealth(FrameVector<sf::Vertex> &hud, GameSimulation &sim)
+{
+    // Goes by the world rather than the wave, so enemies sent by a server get bars too
+    const EnemyArchetypes &archetypes = sim.getWave().getArchetypes();
+    const sf::Vector2<float> barOutterSize{50.f, 5.f};
+    sim.getWorld().each<Transform, Health, EnemyBrain>([&](EntityId id, Transform &transform,
+            Health &health, EnemyBrain &brain)
+    {
+        if(health.alive)
+        {
+            const float maxHealth = (float)archetypes.get(brain.archetype).health;
+            const sf::Vector2<float> barInnerSize{barOutterSize.x * (health.health / maxHealth), barOutterSize.y};
+            const sf::Vector2<float> barPosition{transform.position.x - 23, transform.position.y - 30};
+            appendRect(hud, barPosition, barOutterSize, sf::Color(45, 45, 45, 255), 2);
+            appendRect(hud, barPosition, barInnerSize, sf::Color(255, 0, 0, 255));
+        }
+    });
+}
+
+void GameRenderer::drawRoundProgressHUD(FrameVector<sf::Vertex> &hud, const sf::View &view, const RoundInfo &round)
+{
+    float enemiesAlive = (float)round.alive;
+    float totalEnemies = (float)round.enemies;
+    int currWave = round.wave;
+
+    const int lineSize = 2;
+    const sf::Vector2<float> viewCenter = view.getCenter();
+    const sf::Vector2<float> &viewSize = this->_viewSize;
+    const sf::Vector2<float> barOutterSize{100.f, 5.f};
+    const sf::Vector2<float> barInnerSize{barOutterSize.x * (enemiesAlive / totalEnemies), barOutterSize.y};
+    const sf::Vector2<int> padding{2 + lineSize, 2 + lineSize};
+    const sf::Vector2<float> barPosition{viewCenter.x - padding.x - barOutterSize.x / 2, viewCenter.y + padding.y + barOutterSize.y - viewSize.y / 2};
+
+    // This is the outside grey/black rectangle.
+    appendRect(hud, barPosition, barOutterSize, sf::Color(45, 45, 45, 255), lineSize);
+
+    // This is the inside purple rectangle.
+    appendRect(hud, barPosition, barInnerSize, sf::Color(128, 0, 187, 255));
+
+    // Current wave number text, only rebuilt when the wave changes.
+    // drawHud() draws it once the bars are down.
+    if(currWave != this->_waveTextWave)
+    {
+        char label[16];
+        snprintf(label, sizeof(label), "%d", currWave);
+        this->_waveText.setString(label);
+        this->_waveText.setCharacterSize(lineSize * 2 + barOutterSize.y);
+        this->_waveTextWave = currWave;
+    }
+
+    const sf::FloatRect bounds = this->_waveText.getLocalBounds();
+    this->_waveText.setPosition(sf::Vector2f{barPosition.x - padding.x - (bounds.left + bounds.width), barPosition.y + lineSize - (bounds.top + bounds.height) / 2});
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include "GameSimulation.h"
+#include "SpriteBatch.h"
+#include "ParticleSystem.h"
+#include "GlyphAtlas.h"
+#include "DamageNumbers.h"
+#include "Minimap.h"
+#include "RenderCounter.h"
+#include "FrameArena.h"
+
+/** What the HUD shows about the round, from the local wave or from the server. */
+struct RoundInfo
+{
+    int wave;
+    int enemies;
+    int alive;
+};
+
+/** Class which draws a frame of the game into any render target.
+ *
+ * It owns everything that only exists to be looked at: the sprite batch, the effects, the
+ * minimap and what the HUD is drawn with. GameManager draws it into the window each frame,
+ * and the render benchmark draws it into an sf::RenderTexture, so both measure the same
+ * draw path. Every draw goes through a RenderCounter.
+ *
+ * A frame is the world and then the HUD over it, which can also be drawn one at a time
+ * into different targets, so the world can be drawn at a lower resolution than the HUD.
+ */
+class GameRenderer
+{
+    public:
+        /**
+         * @brief Loads what the map, HUD and damage numbers are drawn with
+         *
+         * @param viewSize Size of the part of the world shown at once
+         */
+        explicit GameRenderer(sf::Vector2<float> viewSize);
+
+        /**
+         * @brief Moves the effects on
+         *
+         * @param deltaTime The time between the last frame and this one
+         */
+        void updateEffects(float deltaTime);
+
+        /**
+         * @brief Redraws the minimap when it's due
+         *
+         * @param deltaTime The time between the last frame and this one
+         * @param sim The game to show
+         * @param focus The entity the player is
+         * @param rebuildGrid true when the simulation wasn't stepped, so its grid is out of date
+         */
+        void updateMinimap(float deltaTime, GameSimulation &sim, EntityId focus, bool rebuildGrid);
+
+        /**
+         * @brief Draws the map, every entity, the effects and the HUD, centered on the focus
+         *
+         * @param target Where to draw to, its view gets moved to follow the focus
+         * @param sim The game to draw
+         * @param focus The entity the camera and health HUD follow
+         * @param round What the round progress HUD shows
+         * @param arena Scratch memory for this frame
+         */
+        void draw(RenderCounter &target, GameSimulation &sim, EntityId focus, const RoundInfo &round,
+                FrameArena &arena);
+
+        /**
+         * @brief Works out where the camera is, following the focus but staying on the map
+         *
+         * @param sim The game being drawn
+         * @param focus The entity the camera follows
+         *
+         * @return The view to draw both the world and the HUD through
+         */
+        sf::View getView(GameSimulation &sim, EntityId focus) const;
+
+        /**
+         * @brief Draws the map, every entity and the effects, through the target's view
+         *
+         * @param target Where to draw to
+         * @param sim The game to draw
+         */
+        void drawWorld(RenderCounter &target, GameSimulation &sim);
+
+        /**
+         * @brief Draws the damage numbers, health bars, round progress and minimap, through
+         *  the target's view, which should be the one the world was drawn through
+         *
+         * @param target Where to draw to
+         * @param sim The game to draw
+         * @param focus The entity the health HUD follows
+         * @param round What the round progress HUD shows
+         * @param arena Scratch memory for this frame
+         */
+        void drawHud(RenderCounter &target, GameSimulation &sim, EntityId focus, const RoundInfo &round,
+                FrameArena &arena);
+
+        /**
+         * @brief Removes every effect, for when the game jumps to another point in time
+         */
+        void clearEffects();
+
+        ParticleSystem& getParticles();
+        DamageNumbers& getDamageNumbers();
+
+    private:
+        /** Size of the part of the world shown at once. */
+        sf::Vector2<float> _viewSize;
+
+        /** Draws the sprites of every entity in the simulation's world. */
+        SpriteBatch _sprites;
+
+        /** Hit and death effects. */
+        ParticleSystem _particles;
+
+        /** The digits damage numbers are drawn with. */
+        GlyphAtlas _glyphs;
+
+        /** Numbers floating up off everything that takes damage. */
+        DamageNumbers _damageNumbers;
+
+        /** Overview of where the enemies are, in the corner of the screen. */
+        Minimap _minimap;
+
+        /** Repeating floor texture drawn under everything. */
+        sf::Texture _floorTexture;
+
+        /** Font for the HUD. */
+        sf::Font _font;
+
+        /** The wave number next to the round progress bar, and the wave it was last set to. */
+        sf::Text _waveText;
+        int _waveTextWave;
+
+        /**
+         * @brief Called from drawWorld(),
+         *  Temporary function to draw a basic background of our map
+         */
+        void drawMap(RenderCounter &target);
+
+        /**
+         * @brief Called from drawHud(),
+         *  Draw the players health heads up display
+         *
+         * @param hud Where to add the bars, drawHud() draws them all at once
+         */
+        void drawHealthHUD(FrameVector<sf::Vertex> &hud, const sf::View &view, const Health *health);
+
+        /**
+         * @brief Called from drawHud(),
+         *  Draw a health bar over every living enemy
+         *
+         * @param hud Where to add the bars, drawHud() draws them all at once
+         */
+        void drawEnemyHealth(FrameVector<sf::Vertex> &hud, GameSimulation &sim);
+
+        /**
+         * @brief Called from drawHud(),
+         *  Draw a heads up display on the current round information
+         *
+         * @param hud Where to add the bars, drawHud() draws them all at once
+         */
+        void drawRoundProgressHUD(FrameVector<sf::Vertex> &hud, const sf::View &view, const RoundInfo &round);
+};
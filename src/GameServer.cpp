@@ -0,0 +1,328 @@
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+
+#include "GameServer.h"
+
+const int GameServer::tickRate;
+const int GameServer::snapshotInterval;
+
+// How many sent snapshots are kept around to be acked, about 1.5 seconds worth
+static const int frameHistory = 32;
+
+// Clients that go quiet for this many seconds are dropped
+static const int clientTimeout = 5;
+
+GameServer::GameServer(unsigned short port) :
+    // Every server plays out its own waves
+    _sim {true, (std::uint32_t)time(nullptr)},
+    _frames(frameHistory),
+    _tick(0),
+    _logging(true),
+    _simTotal(sf::Time::Zero),
+    _sendTotal(sf::Time::Zero),
+    _packetBytes(0),
+    _packetCount(0),
+    _statsTicks(0)
+{
+    _listening = this->_socket.bind(port) == sf::Socket::Done;
+    if(!_listening)
+    {
+        printf("ERROR: server can not listen on port %d!!\n", (int)port);
+    }
+    this->_socket.setBlocking(false);
+
+    for(std::size_t i = 0; i < this->_frames.size(); i++)
+    {
+        this->_frames[i].tick = netNoTick;
+    }
+
+    _stats.ticks = 0;
+    _stats.clients = 0;
+    _stats.bytesPerClient = 0;
+    _stats.maxBytesPerClient = 0;
+    _stats.packetSize = 0;
+
+    this->_sim.start();
+}
+
+bool GameServer::isListening() const
+{
+    return _listening;
+}
+
+unsigned short GameServer::getPort() const
+{
+    return this->_socket.getLocalPort();
+}
+
+void GameServer::run(int ticks)
+{
+    sf::Clock clock;
+    const sf::Time step = sf::seconds(1.0f / tickRate);
+    sf::Time next = clock.getElapsedTime();
+
+    for(int i = 0; ticks < 0 || i < ticks; i++)
+    {
+        tick();
+
+        // Sleep until the next tick is due. If we've fallen well behind, don't try to catch up.
+        next += step;
+        const sf::Time now = clock.getElapsedTime();
+        if(now < next)
+        {
+            sf::sleep(next - now);
+        }
+        else if(now - next > sf::seconds(0.25f))
+        {
+            next = now;
+        }
+    }
+}
+
+void GameServer::tick()
+{
+    receive();
+
+    // Only the first client steers the player, presses are cleared once they've been used
+    sf::Clock timer;
+    if(!this->_clients.empty())
+    {
+        PlayerInput &input = this->_clients[0].input;
+        this->_sim.applyInput(input);
+        input.dodge = false;
+        input.attack = false;
+    }
+    this->_sim.step(1.0f / tickRate);
+    _simTotal += timer.restart();
+
+    if(_tick % snapshotInterval == 0)
+    {
+        sendSnapshots();
+    }
+    _sendTotal += timer.getElapsedTime();
+
+    dropTimedOut();
+
+    _tick++;
+    _statsTicks++;
+    if(_statsTicks == tickRate)
+    {
+        updateStats();
+    }
+}
+
+void GameServer::receive()
+{
+    sf::IpAddress address;
+    unsigned short port;
+    while(this->_socket.receive(this->_packet, address, port) == sf::Socket::Done)
+    {
+        sf::Uint8 type;
+        if(!(this->_packet >> type))
+        {
+            continue;
+        }
+
+        int index = findClient(address, port);
+        switch(type)
+        {
+            case HelloPacket:
+            {
+                sf::Uint16 version;
+                if(!(this->_packet >> version) || version != netProtocolVersion)
+                {
+                    printf("ERROR: client %s:%d has the wrong protocol version!!\n",
+                            address.toString().c_str(), (int)port);
+                    break;
+                }
+
+                if(index < 0)
+                {
+                    ServerClient client;
+                    client.address = address;
+                    client.port = port;
+                    client.ackTick = netNoTick;
+                    client.inputSequence = 0;
+                    client.lastHeard = _tick;
+                    client.input.move = sf::Vector2<float>(0, 0);
+                    client.input.dodge = false;
+                    client.input.attack = false;
+                    client.bytesSent = 0;
+                    this->_clients.push_back(client);
+                    printf("Client %s:%d joined\n", address.toString().c_str(), (int)port);
+                }
+
+                // Answer every hello, in case an earlier welcome got lost
+                sf::Packet welcome;
+                welcome << (sf::Uint8)WelcomePacket << (sf::Uint16)tickRate << (sf::Uint16)snapshotInterval;
+                this->_socket.send(welcome, address, port);
+                break;
+            }
+            case InputPacket:
+            {
+                sf::Uint32 sequence, ack;
+                sf::Int8 moveX, moveY;
+                sf::Uint8 buttons;
+                if(index < 0 || !(this->_packet >> sequence >> ack >> moveX >> moveY >> buttons))
+                {
+                    break;
+                }
+
+                // Packets can arrive out of order, anything older than what we have is stale
+                ServerClient &client = this->_clients[index];
+                client.lastHeard = _tick;
+                if(sequence <= client.inputSequence)
+                {
+                    break;
+                }
+                client.inputSequence = sequence;
+                if(ack != netNoTick && (client.ackTick == netNoTick || ack > client.ackTick))
+                {
+                    client.ackTick = ack;
+                }
+                client.input.move = sf::Vector2<float>(moveX, moveY);
+                client.input.dodge = client.input.dodge || (buttons & 1) != 0;
+                client.input.attack = client.input.attack || (buttons & 2) != 0;
+                break;
+            }
+            case ByePacket:
+            {
+                if(index >= 0)
+                {
+                    printf("Client %s:%d left\n", address.toString().c_str(), (int)port);
+                    this->_clients.erase(this->_clients.begin() + index);
+                }
+                break;
+            }
+            default:
+                // Not something clients send
+                break;
+        }
+    }
+}
+
+void GameServer::sendSnapshots()
+{
+    if(this->_clients.empty())
+    {
+        return;
+    }
+
+    NetFrame &frame = this->_frames[(_tick / snapshotInterval) % this->_frames.size()];
+    captureNetFrame(this->_sim.getWorld(), this->_sim.getWave(), _tick, frame);
+
+    for(std::size_t i = 0; i < this->_clients.size(); i++)
+    {
+        ServerClient &client = this->_clients[i];
+        frame.controlling = i == 0;
+        writeNetFrame(frame, findFrame(client.ackTick), this->_packet);
+
+        if(this->_packet.getDataSize() > sf::UdpSocket::MaxDatagramSize)
+        {
+            printf("ERROR: a %d byte snapshot is too big to send!!\n", (int)this->_packet.getDataSize());
+            continue;
+        }
+        this->_socket.send(this->_packet, client.address, client.port);
+        client.bytesSent += this->_packet.getDataSize();
+        _packetBytes += this->_packet.getDataSize();
+        _packetCount++;
+    }
+    frame.controlling = false;
+}
+
+void GameServer::dropTimedOut()
+{
+    for(std::size_t i = this->_clients.size(); i-- > 0;)
+    {
+        if(_tick - this->_clients[i].lastHeard > (std::uint32_t)(clientTimeout * tickRate))
+        {
+            printf("Client %s:%d timed out\n", this->_clients[i].address.toString().c_str(),
+                    (int)this->_clients[i].port);
+            this->_clients.erase(this->_clients.begin() + i);
+        }
+    }
+}
+
+void GameServer::updateStats()
+{
+    _stats.ticks = _statsTicks;
+    _stats.simTime = sf::microseconds(_simTotal.asMicroseconds() / _statsTicks);
+    _stats.sendTime = sf::microseconds(_sendTotal.asMicroseconds() / _statsTicks);
+    _stats.clients = (int)this->_clients.size();
+    _stats.packetSize = _packetCount > 0 ? (float)_packetBytes / _packetCount : 0;
+
+    // Counted per tickRate ticks, which is a second of game time however fast we're running
+    std::size_t totalBytes = 0;
+    std::size_t maxBytes = 0;
+    for(std::size_t i = 0; i < this->_clients.size(); i++)
+    {
+        totalBytes += this->_clients[i].bytesSent;
+        maxBytes = std::max(maxBytes, this->_clients[i].bytesSent);
+        this->_clients[i].bytesSent = 0;
+    }
+    _stats.bytesPerClient = this->_clients.empty() ? 0 : (float)totalBytes / this->_clients.size();
+    _stats.maxBytesPerClient = (float)maxBytes;
+
+    if(_logging)
+    {
+        printf("Server tick %u: %d clients, sim %d us, send %d us, %.2f KB/s per client (max %.2f), "
+                "%.0f byte snapshots\n", _tick, _stats.clients, (int)_stats.simTime.asMicroseconds(),
+                (int)_stats.sendTime.asMicroseconds(), _stats.bytesPerClient / 1024,
+                _stats.maxBytesPerClient / 1024, _stats.packetSize);
+    }
+
+    _simTotal = sf::Time::Zero;
+    _sendTotal = sf::Time::Zero;
+    _packetBytes = 0;
+    _packetCount = 0;
+    _statsTicks = 0;
+}
+
+void GameServer::setLogging(bool logging)
+{
+    _logging = logging;
+}
+
+const ServerStats& GameServer::getStats() const
+{
+    return _stats;
+}
+
+int GameServer::getClientCount() const
+{
+    return (int)this->_clients.size();
+}
+
+const NetFrame& GameServer::getLastFrame() const
+{
+    return this->_frames[((_tick - 1) / snapshotInterval) % this->_frames.size()];
+}
+
+GameSimulation& GameServer::getSimulation()
+{
+    return this->_sim;
+}
+
+int GameServer::findClient(const sf::IpAddress &address, unsigned short port) const
+{
+    for(std::size_t i = 0; i < this->_clients.size(); i++)
+    {
+        if(this->_clients[i].address == address && this->_clients[i].port == port)
+        {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+const NetFrame* GameServer::findFrame(std::uint32_t tick) const
+{
+    if(tick == netNoTick || tick % snapshotInterval != 0)
+    {
+        return nullptr;
+    }
+
+    const NetFrame &frame = this->_frames[(tick / snapshotInterval) % this->_frames.size()];
+    return frame.tick == tick ? &frame : nullptr;
+}
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <SFML/Network.hpp>
+
+#include "GameSimulation.h"
+#include "NetProtocol.h"
+
+/** Timing and bandwidth of the server, measured over the last second. */
+struct ServerStats
+{
+    /** Ticks run in the last second */
+    int ticks;
+
+    /** Average time per tick spent simulating, and capturing and sending snapshots */
+    sf::Time simTime;
+    sf::Time sendTime;
+
+    /** Connected clients */
+    int clients;
+
+    /** Average and highest bytes sent per client per second */
+    float bytesPerClient;
+    float maxBytesPerClient;
+
+    /** Average size of a snapshot packet */
+    float packetSize;
+};
+
+/** Headless authoritative server.
+ *
+ * Runs a GameSimulation at a fixed tick rate and streams it to every connected client over
+ * UDP. Snapshots are quantized (see NetEntity) and sent as deltas against the newest snapshot
+ * each client has told us it received, so an entity that didn't change costs nothing.
+ *
+ * The game only has one player, so the first client to join controls it and the rest watch.
+ * When the controlling client leaves, the next one takes over.
+ */
+class GameServer
+{
+    public:
+        /**
+         * @brief Creates the server and starts listening
+         *
+         * @param port UDP port to listen on, sf::Socket::AnyPort picks a free one
+         */
+        explicit GameServer(unsigned short port);
+
+        /** Simulation ticks per second */
+        static const int tickRate = 60;
+
+        /** Ticks between snapshots, 3 sends at 20Hz */
+        static const int snapshotInterval = 3;
+
+        /**
+         * @brief Checks if the socket could be bound
+         *
+         * @return true if the server is listening
+         */
+        bool isListening() const;
+
+        /**
+         * @brief Getter for the port the server is listening on
+         *
+         * @return The UDP port
+         */
+        unsigned short getPort() const;
+
+        /**
+         * @brief Runs ticks in real time
+         *
+         * @param ticks How many ticks to run for, forever if negative
+         */
+        void run(int ticks);
+
+        /**
+         * @brief Runs a single tick: takes in packets, steps the game, sends snapshots
+         */
+        void tick();
+
+        /**
+         * @brief Turns printing the stats every second on or off
+         *
+         * @param logging true to print
+         */
+        void setLogging(bool logging);
+
+        /**
+         * @brief Getter for the stats of the last full second
+         *
+         * @return The stats
+         */
+        const ServerStats& getStats() const;
+
+        /**
+         * @brief Getter for the number of connected clients
+         *
+         * @return Number of clients
+         */
+        int getClientCount() const;
+
+        /**
+         * @brief Getter for the newest snapshot sent, before delta compression
+         *
+         * @return The frame
+         */
+        const NetFrame& getLastFrame() const;
+
+        GameSimulation& getSimulation();
+
+    private:
+        /** A connected client */
+        struct ServerClient
+        {
+            sf::IpAddress address;
+            unsigned short port;
+
+            /** Newest snapshot tick the client has, or netNoTick */
+            std::uint32_t ackTick;
+
+            /** Newest input sequence number taken from the client */
+            std::uint32_t inputSequence;
+
+            /** Server tick when the client was last heard from */
+            std::uint32_t lastHeard;
+
+            /** Input waiting for the next tick, presses stay set until then */
+            PlayerInput input;
+
+            /** Bytes sent this second */
+            std::size_t bytesSent;
+        };
+
+        GameSimulation _sim;
+        sf::UdpSocket _socket;
+        bool _listening;
+        std::vector<ServerClient> _clients;
+
+        /** Snapshots recently sent, indexed by send, kept so clients can ack them as a base */
+        std::vector<NetFrame> _frames;
+        std::uint32_t _tick;
+
+        sf::Packet _packet;
+        bool _logging;
+
+        ServerStats _stats;
+        sf::Time _simTotal;
+        sf::Time _sendTotal;
+        std::size_t _packetBytes;
+        int _packetCount;
+        int _statsTicks;
+
+        /**
+         * @brief Takes in every waiting packet
+         */
+        void receive();
+
+        /**
+         * @brief Captures the world and sends each client its delta
+         */
+        void sendSnapshots();
+
+        /**
+         * @brief Drops clients that haven't been heard from in a while
+         */
+        void dropTimedOut();
+
+        /**
+         * @brief Works out the stats once a second has gone by
+         */
+        void updateStats();
+
+        /**
+         * @brief Finds a client by address
+         *
+         * @return Index into _clients, or -1
+         */
+        int findClient(const sf::IpAddress &address, unsigned short port) const;
+
+        /**
+         * @brief Finds a recently sent frame by tick
+         *
+         * @return The frame, or nullptr if it's too old
+         */
+        const NetFrame* findFrame(std::uint32_t tick) const;
+};
@@ -0,0 +1,261 @@
+#include <cstdlib>
+
+#include "GameSimulation.h"
+#include "Enemy.h"
+#include "AllocTracker.h"
+#include "Collision.h"
+
+const sf::FloatRect GameSimulation::mapBounds(0.0, 0.0, 1500.0, 1125.0);
+
+GameSimulation::GameSimulation(bool headless, std::uint32_t seed) :
+    _textures {headless},
+    // The grid and projectiles cover the whole map
+    _grid {mapBounds, 64.0},
+    _projectiles {65536, mapBounds},
+    // Enemies hit the player from inside the no-allocation zone of the wave update,
+    // so the buffers need their room up front
+    _events {1024},
+    _tickOver(false),
+    _tick(0)
+{
+    this->_player.setEventBuffer(&this->_events.getBuffer(PlayerProducer));
+
+    // Every component is known up front, so a snapshot can be checked before any enemy spawns
+    this->_world.registerComponents<Transform, Bounds, Health, SpriteRef, PlayerControl, EnemyBrain, Animation>();
+
+    // Clips are loaded before anything spawns, so an entity's first frame is already defined
+    this->_animations.load("assets/data/animations.txt", this->_textures);
+    this->_player.spawn(this->_world, this->_textures, this->_animations, sf::Vector2<float>(0, 0));
+    this->_wave.setWorld(this->_world);
+    this->_wave.setSeed(seed);
+
+    // Enemy definitions are loaded once, enemies only keep an index into them
+    EnemyArchetypes archetypes;
+    archetypes.loadBehaviors("assets/data/behaviors.txt");
+    archetypes.load("assets/data/enemies.txt", this->_textures);
+    this->_wave.setArchetypes(archetypes);
+    this->_wave.setPlayer(this->_player);
+    this->_wave.setProjectiles(this->_projectiles);
+    this->_wave.setEvents(&this->_events);
+}
+
+void GameSimulation::start()
+{
+    this->_wave.beginWave();
+}
+
+void GameSimulation::beginTick()
+{
+    if(this->_tickOver)
+    {
+        this->_events.clear();
+        this->_tickOver = false;
+    }
+}
+
+EntityId GameSimulation::applyInput(const PlayerInput &input)
+{
+    this->beginTick();
+
+    // Each axis is handed over separately so diagonal movement works like holding two keys
+    if(input.move.y != 0)
+    {
+        this->_player.moveInDirection(sf::Vector2<float>(0, input.move.y));
+    }
+    if(input.move.x != 0)
+    {
+        this->_player.moveInDirection(sf::Vector2<float>(input.move.x, 0));
+    }
+
+    if(input.dodge)
+    {
+        this->_player.dodgeInDirection(sf::Vector2<float>(0, 0));
+    }
+
+    EntityId hitEnemy;
+    if(input.attack)
+    {
+        hitEnemy = this->rayCast(this->_player.getId(),
+                this->_player.getLastMoveDirection() * this->_player.getAttackRange());
+
+        // The player swings whether or not there's anything to hit
+        this->_player.attack(hitEnemy);
+    }
+    return hitEnemy;
+}
+
+void GameSimulation::step(float deltaTime)
+{
+    this->beginTick();
+
+    // First we check for the health of everything to see if anything is dead
+    updateHealth(this->_world);
+
+    // Update player
+    Player::updateAll(this->_world, deltaTime);
+    this->_player.updateAnimation();
+
+    // Update the enemy wave manager
+    this->_wave.update(deltaTime);
+
+    // After the update, we want to update every entity's position based off of it's velocity
+    integrateMotion(this->_world, deltaTime);
+
+    // Move every animation on and point each sprite at its current frame
+    updateAnimations(this->_world, this->_animations, deltaTime);
+
+    // Enemies drift away from their neighbours in memory as they move, so every so often
+    // put them back in order before the grid walks them
+    if(this->_tick % _sortInterval == 0)
+    {
+        this->sortEnemies();
+    }
+
+    // Index where every enemy is now that they've moved. Then sweep the player through
+    // them, and let every projectile sweep its path for this step against the enemies near
+    // it and the player.
+    const AllocPhase phase = AllocTracker::setPhase(CollisionPhase);
+    this->_grid.build(this->_world, this->_textures);
+    sweepBodies(this->_world, this->_grid, mapBounds, deltaTime);
+    this->_projectiles.update(deltaTime, this->_world, this->_grid, this->_player,
+            getSpriteBox(this->_world, this->_textures, this->_player.getId()),
+            &this->_events.getBuffer(ProjectileProducer));
+    AllocTracker::setPhase(phase);
+
+    // Everything the systems raised comes out together, in the same order every time. The
+    // wave counts its enemies down from the deaths, so it's over as of the next step.
+    this->_events.merge();
+    this->_wave.countEvents(this->_events.getEvents());
+
+    this->_tick++;
+    this->_tickOver = true;
+}
+
+void GameSimulation::sortEnemies()
+{
+    const SpatialGrid &grid = this->_grid;
+    this->_world.sortRows<Transform, Health, EnemyBrain>([&grid](EntityId id, Transform &transform,
+            Health &health, EnemyBrain &brain)
+    {
+        return health.alive ? (std::uint32_t)grid.cellOf(transform.position) : 0xFFFFFFFF;
+    });
+}
+
+EntityId GameSimulation::rayCast(EntityId source, const sf::Vector2<float> &ray)
+{
+    // TODO: Add other entities
+    const sf::Vector2<float> sourcePos = this->_world.get<Transform>(source)->position;
+    const Bounds &sourceBounds = *this->_world.get<Bounds>(source);
+
+    // Let's get the center point for the source
+    sf::Vector2<float> sourceCenter(sourcePos.x + sourceBounds.width / 2.0,
+        sourcePos.y + sourceBounds.height / 2.0);
+
+    // Now we get the end point
+    sf::Vector2<float> endRayPoint = sourcePos + ray;
+
+    EntityId hit;
+    this->_world.eachBatch<Transform, Health, EnemyBrain>([&](std::size_t count,
+            const EntityId *ids, Transform *transform, Health *health, EnemyBrain *brain)
+    {
+        for(std::size_t i = 0; i < count && !hit.isValid(); i++)
+        {
+            // Skip this loop is enemy is dead
+            if(!health[i].alive)
+                continue;
+
+            // Enemies are points, so the closest point on the entity we're checking is its position
+            const sf::Vector2<float> &enemyPoint = transform[i].position;
+
+            // TODO: This is wrong, it doesn't entirely get the idea together
+            // Now we check to see if it's hit this object
+            if(abs(endRayPoint.x - sourcePos.x) > abs(sourcePos.x - enemyPoint.x) &&
+                    (abs(endRayPoint.y - sourcePos.y) > abs(sourcePos.y - enemyPoint.y)))
+            {
+                // Here it has intersected the box of the other entity, so we do the thing now
+                hit = ids[i];
+            }
+        }
+    });
+
+    return hit;
+}
+
+void GameSimulation::kill(EntityId id)
+{
+    ::kill(this->_world, id, &this->_events.getBuffer(PlayerProducer));
+}
+
+void GameSimulation::saveTo(Snapshot &snapshot) const
+{
+    snapshot.write(this->_tick);
+    this->_world.saveTo(snapshot);
+    this->_wave.saveTo(snapshot);
+    this->_projectiles.saveTo(snapshot);
+}
+
+bool GameSimulation::loadFrom(Snapshot &snapshot)
+{
+    if(!snapshot.read(this->_tick) || !this->_world.loadFrom(snapshot))
+    {
+        return false;
+    }
+
+    // The player's id is kept by the world, so the Player handle stays valid as long as
+    // the snapshot has it with everything the player is spawned with
+    const EntityId player = this->_player.getId();
+    bool valid = this->_world.get<Transform>(player) != nullptr && this->_world.get<Bounds>(player) != nullptr
+        && this->_world.get<Health>(player) != nullptr && this->_world.get<SpriteRef>(player) != nullptr
+        && this->_world.get<PlayerControl>(player) != nullptr && this->_world.get<Animation>(player) != nullptr;
+
+    // Components come back as they were saved, so their indices into the sprites and clips
+    // loaded now are checked before anything draws or animates with them
+    const int sprites = this->_textures.getSpriteCount();
+    this->_world.each<SpriteRef>([&](EntityId, SpriteRef &sprite)
+    {
+        valid = valid && sprite.sprite < sprites;
+    });
+    const AnimationLibrary &animations = this->_animations;
+    this->_world.each<Animation>([&](EntityId, Animation &animation)
+    {
+        valid = valid && animation.clip < animations.size()
+            && animation.frame < animations.get(animation.clip).frameCount;
+    });
+
+    return valid && this->_wave.loadFrom(snapshot) && this->_projectiles.loadFrom(snapshot);
+}
+
+EntityWorld& GameSimulation::getWorld()
+{
+    return this->_world;
+}
+
+TextureCache& GameSimulation::getTextures()
+{
+    return this->_textures;
+}
+
+ProjectileSystem& GameSimulation::getProjectiles()
+{
+    return this->_projectiles;
+}
+
+Player& GameSimulation::getPlayer()
+{
+    return this->_player;
+}
+
+WaveManager& GameSimulation::getWave()
+{
+    return this->_wave;
+}
+
+SpatialGrid& GameSimulation::getGrid()
+{
+    return this->_grid;
+}
+
+const EventBuffer& GameSimulation::getEvents() const
+{
+    return this->_events.getEvents();
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <SFML/Graphics.hpp>
+
+#include "EntityWorld.h"
+#include "Entity.h"
+#include "TextureCache.h"
+#include "SpatialGrid.h"
+#include "ProjectileSystem.h"
+#include "Player.h"
+#include "WaveManager.h"
+#include "Animation.h"
+#include "GameEvents.h"
+#include "Snapshot.h"
+
+/** What the player wants to do for one tick, from the keyboard or from a network client. */
+struct PlayerInput
+{
+    /** Direction held, each axis is -1, 0 or 1 */
+    sf::Vector2<float> move;
+
+    /** Dodge was pressed since the last tick */
+    bool dodge;
+
+    /** Attack was pressed since the last tick */
+    bool attack;
+};
+
+/** Class which owns and steps the game world, with no window, input or drawing.
+ *
+ * GameManager wraps one of these with a window for local play, and GameServer runs one
+ * headless and streams it to clients. Anything that only exists to be looked at, like
+ * particles and the HUD, stays out of here.
+ *
+ * Nothing in here is shared between instances, randomness included, so any number of them
+ * can be run side by side on different threads (see BatchSimulator).
+ */
+class GameSimulation
+{
+    public:
+        /**
+         * @brief Creates the world, spawns the player and loads the enemy and animation definitions
+         *
+         * @param headless true to skip creating textures, for running without a window
+         * @param seed Seed for everything random in the game, the same seed and inputs
+         *  always play out the same way
+         */
+        explicit GameSimulation(bool headless = false, std::uint32_t seed = 1);
+
+        /** The area the game is played in */
+        static const sf::FloatRect mapBounds;
+
+        /**
+         * @brief Spawns the first wave
+         */
+        void start();
+
+        /**
+         * @brief Hands a tick of input to the player
+         *
+         * @param input What the player wants to do
+         *
+         * @return The enemy hit if the player attacked one, an invalid id otherwise
+         */
+        EntityId applyInput(const PlayerInput &input);
+
+        /**
+         * @brief Moves the game forward, updating and then colliding everything
+         *
+         * @param deltaTime The time to move forward by
+         */
+        void step(float deltaTime);
+
+        /**
+         * @brief Finds the first living enemy along a ray
+         *
+         * @param source The entity the ray starts from
+         * @param rayDir The direction and length of the ray
+         *
+         * @return The enemy that was hit, or an invalid id if nothing was
+         */
+        EntityId rayCast(EntityId source, const sf::Vector2<float> &rayDir);
+
+        /**
+         * @brief Kills an entity outright, at the player's hand
+         *  Between ticks its death comes out with the next one, so the wave still counts it
+         *
+         * @param id The entity to kill
+         */
+        void kill(EntityId id);
+
+        /**
+         * @brief Writes the entities, wave and projectiles into a snapshot
+         *
+         * @param snapshot Where to write to
+         */
+        void saveTo(Snapshot &snapshot) const;
+
+        /**
+         * @brief Replaces the entities, wave and projectiles with the ones in a snapshot
+         *
+         * @param snapshot Where to read from
+         *
+         * @return false if the snapshot can't be read, or holds a player, sprite or animation
+         *  this game can't have
+         */
+        bool loadFrom(Snapshot &snapshot);
+
+        EntityWorld& getWorld();
+        TextureCache& getTextures();
+        ProjectileSystem& getProjectiles();
+        Player& getPlayer();
+        WaveManager& getWave();
+        SpatialGrid& getGrid();
+
+        /**
+         * @brief Getter for every event of the last tick, the applyInput() before the last
+         *  step() included, anything raised by start() comes out with the first tick
+         *
+         * @return Damage, deaths, spawns and wave changes, each kind in producer order
+         */
+        const EventBuffer& getEvents() const;
+
+    private:
+        /** Storage for every entity in the game, the player and enemies included. */
+        EntityWorld _world;
+
+        /** Every texture entities are drawn with. */
+        TextureCache _textures;
+
+        /** Every animation clip, their frames are sprites in _textures. */
+        AnimationLibrary _animations;
+
+        /** Index of where every enemy is, rebuilt each step for collisions. */
+        SpatialGrid _grid;
+
+        /** Every projectile in flight. */
+        ProjectileSystem _projectiles;
+
+        /** Events raised during the last tick, and whether that tick's step() has run so the
+         *  next applyInput() or step() starts a new one. */
+        EventQueue _events;
+        bool _tickOver;
+
+        /** Steps run so far, kept in snapshots so rewinds sort enemies on the same ticks. */
+        std::uint32_t _tick;
+
+        /** Steps between sortEnemies() calls. */
+        static const std::uint32_t _sortInterval = 30;
+
+        /**
+         * @brief Throws away the last tick's events if it's over
+         */
+        void beginTick();
+
+        /**
+         * @brief Lays the enemies out in the order of the grid cells they're in, dead ones last,
+         *  so the passes over them walk memory in step with the map
+         */
+        void sortEnemies();
+
+        /** The player. */
+        Player _player;
+
+        /** The WaveManager, which owns all Enemies. */
+        WaveManager _wave;
+};
@@ -0,0 +1,133 @@
+#include <cstdio>
+
+#include "GlyphAtlas.h"
+#include "AssetArchive.h"
+
+GlyphAtlas::GlyphAtlas() :
+    _characterSize(0)
+{
+    for(int i = 0; i < 128; i++)
+    {
+        _loaded[i] = false;
+    }
+}
+
+bool GlyphAtlas::load(const std::string &path, const std::string &characters, unsigned characterSize,
+        float outline)
+{
+    for(int i = 0; i < 128; i++)
+    {
+        _loaded[i] = false;
+    }
+
+    sf::Font font;
+    if(!loadAsset(font, path))
+    {
+        printf("ERROR: font can not be loaded from %s!!\n", path.c_str());
+        return false;
+    }
+
+    // The font rasterizes every glyph of one size onto the same page, so once all of them
+    // are asked for the page holds the whole atlas and the rects into it stay put
+    for(std::size_t i = 0; i < characters.size(); i++)
+    {
+        const unsigned char character = (unsigned char)characters[i];
+        if(character >= 128)
+        {
+            continue;
+        }
+
+        const sf::Glyph &fill = font.getGlyph(character, characterSize, false);
+        AtlasGlyph &glyph = _glyphs[character];
+        glyph.fillRect = fill.textureRect;
+        glyph.fillBounds = fill.bounds;
+        glyph.advance = fill.advance;
+
+        const sf::Glyph &outlined = font.getGlyph(character, characterSize, false, outline);
+        glyph.outlineRect = outlined.textureRect;
+        glyph.outlineBounds = outlined.bounds;
+        _loaded[character] = true;
+    }
+
+    // Keep our own copy of the page, the font can go now
+    if(!_texture.loadFromImage(font.getTexture(characterSize).copyToImage()))
+    {
+        printf("ERROR: glyph atlas texture can not be created!!\n");
+        return false;
+    }
+    _characterSize = characterSize;
+    return true;
+}
+
+float GlyphAtlas::measure(const char *text, float scale) const
+{
+    float width = 0;
+    for(const char *c = text; *c != '\0'; c++)
+    {
+        const unsigned char character = (unsigned char)*c;
+        if(character < 128 && _loaded[character])
+        {
+            width += _glyphs[character].advance;
+        }
+    }
+    return width * scale;
+}
+
+// Adds one textured quad, bounds are relative to the pen position
+static void appendQuad(sf::VertexArray &vertices, sf::Vector2<float> pen, const sf::FloatRect &bounds,
+        const sf::IntRect &rect, sf::Color color, float scale)
+{
+    const float left = pen.x + bounds.left * scale;
+    const float top = pen.y + bounds.top * scale;
+    const float right = left + bounds.width * scale;
+    const float bottom = top + bounds.height * scale;
+    const float u0 = (float)rect.left;
+    const float v0 = (float)rect.top;
+    const float u1 = (float)(rect.left + rect.width);
+    const float v1 = (float)(rect.top + rect.height);
+
+    vertices.append(sf::Vertex(sf::Vector2<float>(left, top), color, sf::Vector2<float>(u0, v0)));
+    vertices.append(sf::Vertex(sf::Vector2<float>(right, top), color, sf::Vector2<float>(u1, v0)));
+    vertices.append(sf::Vertex(sf::Vector2<float>(right, bottom), color, sf::Vector2<float>(u1, v1)));
+    vertices.append(sf::Vertex(sf::Vector2<float>(left, bottom), color, sf::Vector2<float>(u0, v1)));
+}
+
+void GlyphAtlas::append(sf::VertexArray &vertices, const char *text, sf::Vector2<float> position,
+        sf::Color fill, sf::Color outline, float scale) const
+{
+    // Every outline goes down before any fill, so a character's outline never covers
+    // the one next to it
+    sf::Vector2<float> pen = position;
+    for(const char *c = text; *c != '\0'; c++)
+    {
+        const unsigned char character = (unsigned char)*c;
+        if(character < 128 && _loaded[character])
+        {
+            const AtlasGlyph &glyph = _glyphs[character];
+            appendQuad(vertices, pen, glyph.outlineBounds, glyph.outlineRect, outline, scale);
+            pen.x += glyph.advance * scale;
+        }
+    }
+
+    pen = position;
+    for(const char *c = text; *c != '\0'; c++)
+    {
+        const unsigned char character = (unsigned char)*c;
+        if(character < 128 && _loaded[character])
+        {
+            const AtlasGlyph &glyph = _glyphs[character];
+            appendQuad(vertices, pen, glyph.fillBounds, glyph.fillRect, fill, scale);
+            pen.x += glyph.advance * scale;
+        }
+    }
+}
+
+const sf::Texture& GlyphAtlas::getTexture() const
+{
+    return _texture;
+}
+
+unsigned GlyphAtlas::getCharacterSize() const
+{
+    return _characterSize;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <string>
+#include <SFML/Graphics.hpp>
+
+/** Where one character is in a GlyphAtlas and how to lay it out. */
+struct AtlasGlyph
+{
+    /** Region of the atlas texture, for the fill and for the outline behind it */
+    sf::IntRect fillRect;
+    sf::IntRect outlineRect;
+
+    /** Where each quad goes relative to the pen position on the baseline */
+    sf::FloatRect fillBounds;
+    sf::FloatRect outlineBounds;
+
+    /** How far the pen moves on after the character */
+    float advance;
+};
+
+/** Class which rasterizes a small set of characters from a font into one texture, once.
+ *
+ * Every character is rasterized at a single size, with an outline version of it next to the
+ * fill, then the whole page is copied into a texture the atlas owns. Drawing text is then
+ * just adding quads to a vertex array, so any amount of text shares a single texture and
+ * can go out in one draw call. Characters that weren't asked for are skipped when drawing.
+ */
+class GlyphAtlas
+{
+    public:
+        GlyphAtlas();
+
+        /**
+         * @brief Rasterizes characters from a font into the atlas
+         *
+         * @param path Path of the font file
+         * @param characters Every character the atlas should hold
+         * @param characterSize Size to rasterize them at, in pixels
+         * @param outline Thickness of the outline, in pixels
+         *
+         * @return false if the font can't be loaded, the atlas is then empty
+         */
+        bool load(const std::string &path, const std::string &characters, unsigned characterSize,
+                float outline);
+
+        /**
+         * @brief Works out how wide a string is
+         *
+         * @param text The string
+         * @param scale Size to draw at, relative to the rasterized size
+         *
+         * @return Width in pixels
+         */
+        float measure(const char *text, float scale = 1) const;
+
+        /**
+         * @brief Adds the quads for a string to a vertex array, outlines first
+         *
+         * @param vertices Where to add the quads, its primitive type should be sf::Quads
+         * @param text The string
+         * @param position Where the left end of the baseline goes
+         * @param fill Color of the characters
+         * @param outline Color of the outline
+         * @param scale Size to draw at, relative to the rasterized size
+         */
+        void append(sf::VertexArray &vertices, const char *text, sf::Vector2<float> position,
+                sf::Color fill, sf::Color outline, float scale = 1) const;
+
+        /**
+         * @brief Getter for the texture the quads from append() are drawn with
+         *
+         * @return The atlas texture
+         */
+        const sf::Texture& getTexture() const;
+
+        /**
+         * @brief Getter for the size the characters were rasterized at
+         *
+         * @return Size in pixels
+         */
+        unsigned getCharacterSize() const;
+
+    private:
+        sf::Texture _texture;
+        unsigned _characterSize;
+
+        /** Layout of every character, indexed by the character itself */
+        AtlasGlyph _glyphs[128];
+
+        /** Which of _glyphs are in the atlas */
+        bool _loaded[128];
+};
@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <cstdio>
+
+#include "Minimap.h"
+
+// Adds a rectangle as a quad with no texture
+static void appendQuad(sf::VertexArray &vertices, float left, float top, float right, float bottom,
+        sf::Color color)
+{
+    vertices.append(sf::Vertex(sf::Vector2<float>(left, top), color));
+    vertices.append(sf::Vertex(sf::Vector2<float>(right, top), color));
+    vertices.append(sf::Vertex(sf::Vector2<float>(right, bottom), color));
+    vertices.append(sf::Vertex(sf::Vector2<float>(left, bottom), color));
+}
+
+Minimap::Minimap(float refreshRate, int crowded) :
+    _refreshPeriod(1.0f / refreshRate),
+    _crowded(std::max(1, crowded)),
+    _created(false)
+{
+    // Due straight away, so the first frame has something to show
+    _sinceRefresh = _refreshPeriod;
+    _cells.setPrimitiveType(sf::Quads);
+}
+
+bool Minimap::create(unsigned width, unsigned height)
+{
+    _created = _texture.create(width, height);
+    if(!_created)
+    {
+        printf("ERROR: minimap texture can not be created!!\n");
+    }
+    return _created;
+}
+
+bool Minimap::advance(float deltaTime)
+{
+    _sinceRefresh += deltaTime;
+    if(!_created || _sinceRefresh < _refreshPeriod)
+    {
+        return false;
+    }
+
+    // A long frame doesn't queue up more redraws
+    _sinceRefresh = 0;
+    return true;
+}
+
+void Minimap::render(const SpatialGrid &grid, sf::Vector2<float> focus)
+{
+    if(!_created)
+    {
+        return;
+    }
+
+    const sf::Vector2u size = _texture.getSize();
+    const sf::FloatRect &bounds = grid.getBounds();
+    const float cellWidth = (float)size.x / grid.getColumns();
+    const float cellHeight = (float)size.y / grid.getRows();
+
+    // Empty cells are left as background, the rest get more solid the more crowded they are
+    _cells.clear();
+    for(int row = 0; row < grid.getRows(); row++)
+    {
+        for(int col = 0; col < grid.getColumns(); col++)
+        {
+            const int count = std::min(grid.getCellCount(col, row), _crowded);
+            if(count > 0)
+            {
+                const sf::Uint8 alpha = (sf::Uint8)(80 + 175 * count / _crowded);
+                appendQuad(_cells, col * cellWidth, row * cellHeight, (col + 1) * cellWidth,
+                        (row + 1) * cellHeight, sf::Color(220, 40, 40, alpha));
+            }
+        }
+    }
+
+    // The player is a small square on top
+    const float x = (focus.x - bounds.left) / bounds.width * size.x;
+    const float y = (focus.y - bounds.top) / bounds.height * size.y;
+    appendQuad(_cells, x - 2, y - 2, x + 2, y + 2, sf::Color(80, 200, 255));
+
+    _texture.clear(sf::Color(20, 20, 20, 180));
+    _texture.draw(_cells);
+    _texture.display();
+}
+
+void Minimap::draw(RenderCounter &target, const sf::FloatRect &area)
+{
+    if(!_created)
+    {
+        return;
+    }
+
+    const sf::Vector2u size = _texture.getSize();
+    const sf::Vertex quad[4] = {
+        sf::Vertex(sf::Vector2<float>(area.left, area.top), sf::Vector2<float>(0, 0)),
+        sf::Vertex(sf::Vector2<float>(area.left + area.width, area.top), sf::Vector2<float>(size.x, 0)),
+        sf::Vertex(sf::Vector2<float>(area.left + area.width, area.top + area.height),
+                sf::Vector2<float>(size.x, size.y)),
+        sf::Vertex(sf::Vector2<float>(area.left, area.top + area.height), sf::Vector2<float>(0, size.y))
+    };
+    target.draw(quad, 4, sf::Quads, sf::RenderStates(&_texture.getTexture()));
+}
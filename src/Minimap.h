@@ -0,0 +1,74 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include "SpatialGrid.h"
+#include "RenderCounter.h"
+
+/** Class which draws an overview of where the enemies are, in the corner of the screen.
+ *
+ * Rather than drawing the wave a second time, the map is built from how many enemies each
+ * SpatialGrid cell holds: one quad per cell, shaded by how crowded it is, plus a marker for
+ * the player. That's a fixed amount of work however many enemies there are, and cells
+ * holding more than a set number all look the same.
+ *
+ * The map is rendered into a texture only a few times a second and shown as a single
+ * textured quad every frame in between.
+ */
+class Minimap
+{
+    public:
+        /**
+         * @brief Creates the minimap, call create() before using it
+         *
+         * @param refreshRate How many times a second the map is redrawn
+         * @param crowded Enemies in a cell for it to be drawn at full strength
+         */
+        Minimap(float refreshRate, int crowded);
+
+        /**
+         * @brief Creates the texture the map is rendered into
+         *
+         * @param width Width of the texture in pixels
+         * @param height Height of the texture in pixels
+         *
+         * @return false if the texture can't be created, draw() then does nothing
+         */
+        bool create(unsigned width, unsigned height);
+
+        /**
+         * @brief Moves the refresh timer on
+         *
+         * @param deltaTime Time between last update and this one
+         *
+         * @return true when the map is due to be redrawn with render()
+         */
+        bool advance(float deltaTime);
+
+        /**
+         * @brief Redraws the map into its texture
+         *
+         * @param grid Index of the enemies, built this tick
+         * @param focus Where the player is
+         */
+        void render(const SpatialGrid &grid, sf::Vector2<float> focus);
+
+        /**
+         * @brief Draws the last rendered map as one textured quad
+         *
+         * @param target Where to draw to
+         * @param area Where the map goes, in the target's coordinates
+         */
+        void draw(RenderCounter &target, const sf::FloatRect &area);
+
+    private:
+        float _refreshPeriod;
+        float _sinceRefresh;
+        int _crowded;
+        bool _created;
+
+        sf::RenderTexture _texture;
+
+        /** One quad per grid cell and the player marker, reused every render() */
+        sf::VertexArray _cells;
+};
@@ -0,0 +1,335 @@
+#include <algorithm>
+#include <cmath>
+
+#include "NetProtocol.h"
+#include "Entity.h"
+#include "Enemy.h"
+#include "Player.h"
+
+/** Bits saying which fields of an entity follow in a snapshot packet */
+enum NetChange
+{
+    /** Every field follows, the entity is new to the client */
+    ChangedAll = 1,
+    ChangedX = 2,
+    ChangedY = 4,
+    ChangedHealth = 8,
+    ChangedFlags = 16,
+    ChangedSprite = 32
+};
+
+static std::int16_t quantize(float value)
+{
+    return (std::int16_t)std::max(-32768.0f, std::min(32767.0f, std::round(value * netPositionScale)));
+}
+
+static bool lessById(const NetEntity &lhs, const NetEntity &rhs)
+{
+    return lhs.id < rhs.id;
+}
+
+// Finds an entity in the sorted part of a list
+static NetEntity* findById(std::vector<NetEntity> &entities, std::size_t sortedCount, std::uint32_t id)
+{
+    NetEntity key;
+    key.id = id;
+    std::vector<NetEntity>::iterator found = std::lower_bound(entities.begin(),
+            entities.begin() + sortedCount, key, lessById);
+    return found != entities.begin() + sortedCount && found->id == id ? &*found : nullptr;
+}
+
+// Which fields of an entity need sending, given the client's copy of it (or nullptr)
+static sf::Uint8 getChanges(const NetEntity &entity, const NetEntity *old)
+{
+    if(old == nullptr || old->generation != entity.generation)
+    {
+        return ChangedAll;
+    }
+
+    sf::Uint8 changes = 0;
+    changes |= old->x != entity.x ? ChangedX : 0;
+    changes |= old->y != entity.y ? ChangedY : 0;
+    changes |= old->health != entity.health ? ChangedHealth : 0;
+    changes |= old->flags != entity.flags ? ChangedFlags : 0;
+    changes |= old->sprite != entity.sprite ? ChangedSprite : 0;
+    return changes;
+}
+
+void captureNetFrame(EntityWorld &world, WaveManager &wave, std::uint32_t tick, NetFrame &frame)
+{
+    frame.tick = tick;
+    frame.controlling = false;
+    frame.wave = (std::uint16_t)wave.getWave();
+    frame.enemies = (std::uint16_t)wave.getEnemies();
+    frame.alive = (std::uint16_t)wave.getEnemiesAlive();
+    frame.entities.clear();
+
+    world.each<Transform, Health, SpriteRef>([&](EntityId id, Transform &transform, Health &health,
+            SpriteRef &sprite)
+    {
+        const EnemyBrain *brain = world.get<EnemyBrain>(id);
+
+        NetEntity entity;
+        entity.id = id.index;
+        entity.generation = (std::uint16_t)id.generation;
+        entity.flags = (health.alive ? NetAlive : 0)
+            | (brain != nullptr ? NetEnemy : 0)
+            | (world.get<PlayerControl>(id) != nullptr ? NetPlayer : 0);
+        entity.archetype = brain != nullptr ? brain->archetype : 0;
+        entity.x = quantize(transform.position.x);
+        entity.y = quantize(transform.position.y);
+        entity.health = (std::int16_t)std::max(-32768, std::min(32767, health.health));
+        entity.sprite = sprite.sprite;
+        frame.entities.push_back(entity);
+    });
+
+    std::sort(frame.entities.begin(), frame.entities.end(), lessById);
+}
+
+void writeNetFrame(const NetFrame &frame, const NetFrame *base, sf::Packet &packet)
+{
+    static const std::vector<NetEntity> none;
+    const std::vector<NetEntity> &old = base != nullptr ? base->entities : none;
+    const std::vector<NetEntity> &entities = frame.entities;
+
+    packet.clear();
+    packet << (sf::Uint8)SnapshotPacket << (sf::Uint32)frame.tick
+        << (sf::Uint32)(base != nullptr ? base->tick : netNoTick)
+        << (sf::Uint8)frame.controlling << (sf::Uint16)frame.wave
+        << (sf::Uint16)frame.enemies << (sf::Uint16)frame.alive;
+
+    // Both lists are sorted by id, so walking them together finds what's gone in one pass
+    std::vector<std::uint32_t> removed;
+    for(std::size_t i = 0, j = 0; i < old.size(); i++)
+    {
+        while(j < entities.size() && entities[j].id < old[i].id)
+        {
+            j++;
+        }
+        if(j == entities.size() || entities[j].id != old[i].id)
+        {
+            removed.push_back(old[i].id);
+        }
+    }
+    packet << (sf::Uint16)removed.size();
+    for(std::size_t i = 0; i < removed.size(); i++)
+    {
+        packet << (sf::Uint32)removed[i];
+    }
+
+    // Then everything new or changed, with only the fields that changed
+    std::vector<sf::Uint8> changes(entities.size());
+    sf::Uint16 changedCount = 0;
+    for(std::size_t i = 0, j = 0; i < entities.size(); i++)
+    {
+        while(j < old.size() && old[j].id < entities[i].id)
+        {
+            j++;
+        }
+        changes[i] = getChanges(entities[i], j < old.size() && old[j].id == entities[i].id ? &old[j] : nullptr);
+        changedCount += changes[i] != 0 ? 1 : 0;
+    }
+
+    packet << changedCount;
+    for(std::size_t i = 0; i < entities.size(); i++)
+    {
+        const NetEntity &entity = entities[i];
+        const sf::Uint8 changed = changes[i];
+        if(changed == 0)
+        {
+            continue;
+        }
+
+        packet << (sf::Uint32)entity.id << changed;
+        if(changed & ChangedAll)
+        {
+            packet << (sf::Uint16)entity.generation << (sf::Uint8)entity.flags
+                << (sf::Uint16)entity.archetype << (sf::Int16)entity.x << (sf::Int16)entity.y
+                << (sf::Int16)entity.health << (sf::Uint16)entity.sprite;
+            continue;
+        }
+        if(changed & ChangedX)
+        {
+            packet << (sf::Int16)entity.x;
+        }
+        if(changed & ChangedY)
+        {
+            packet << (sf::Int16)entity.y;
+        }
+        if(changed & ChangedHealth)
+        {
+            packet << (sf::Int16)entity.health;
+        }
+        if(changed & ChangedFlags)
+        {
+            packet << (sf::Uint8)entity.flags;
+        }
+        if(changed & ChangedSprite)
+        {
+            packet << (sf::Uint16)entity.sprite;
+        }
+    }
+}
+
+bool readNetFrame(sf::Packet &packet, const NetFrame *base, NetFrame &frame)
+{
+    sf::Uint8 controlling;
+    sf::Uint16 wave, enemies, alive, removedCount;
+    packet >> controlling >> wave >> enemies >> alive >> removedCount;
+    if(!packet)
+    {
+        return false;
+    }
+    frame.controlling = controlling != 0;
+    frame.wave = wave;
+    frame.enemies = enemies;
+    frame.alive = alive;
+
+    std::vector<sf::Uint32> removed(removedCount);
+    for(sf::Uint16 r = 0; r < removedCount; r++)
+    {
+        packet >> removed[r];
+    }
+    if(!packet)
+    {
+        return false;
+    }
+
+    // Start from the client's copy of the base, minus whatever is gone.
+    // Removed ids were written in order, so this is one walk over both.
+    frame.entities.clear();
+    for(std::size_t i = 0, r = 0; base != nullptr && i < base->entities.size(); i++)
+    {
+        while(r < removed.size() && removed[r] < base->entities[i].id)
+        {
+            r++;
+        }
+        if(r == removed.size() || removed[r] != base->entities[i].id)
+        {
+            frame.entities.push_back(base->entities[i]);
+        }
+    }
+
+    sf::Uint16 changedCount;
+    if(!(packet >> changedCount))
+    {
+        return false;
+    }
+
+    // New entities go on the end for now, only the base part is sorted while reading
+    const std::size_t sortedCount = frame.entities.size();
+    for(sf::Uint16 c = 0; c < changedCount; c++)
+    {
+        sf::Uint32 id;
+        sf::Uint8 changed;
+        if(!(packet >> id >> changed))
+        {
+            return false;
+        }
+
+        NetEntity *entity = findById(frame.entities, sortedCount, id);
+        if(changed & ChangedAll)
+        {
+            NetEntity fresh;
+            sf::Uint16 generation, archetype, sprite;
+            sf::Uint8 flags;
+            sf::Int16 x, y, health;
+            if(!(packet >> generation >> flags >> archetype >> x >> y >> health >> sprite))
+            {
+                return false;
+            }
+            fresh.id = id;
+            fresh.generation = generation;
+            fresh.flags = flags;
+            fresh.archetype = archetype;
+            fresh.x = x;
+            fresh.y = y;
+            fresh.health = health;
+            fresh.sprite = sprite;
+
+            if(entity != nullptr)
+            {
+                *entity = fresh;
+            }
+            else
+            {
+                frame.entities.push_back(fresh);
+            }
+            continue;
+        }
+
+        // A change to something the client never had means the base was wrong
+        if(entity == nullptr)
+        {
+            return false;
+        }
+        sf::Int16 value16 = 0;
+        sf::Uint16 unsigned16 = 0;
+        sf::Uint8 value8 = 0;
+        if(changed & ChangedX)
+        {
+            packet >> value16;
+            entity->x = value16;
+        }
+        if(changed & ChangedY)
+        {
+            packet >> value16;
+            entity->y = value16;
+        }
+        if(changed & ChangedHealth)
+        {
+            packet >> value16;
+            entity->health = value16;
+        }
+        if(changed & ChangedFlags)
+        {
+            packet >> value8;
+            entity->flags = value8;
+        }
+        if(changed & ChangedSprite)
+        {
+            packet >> unsigned16;
+            entity->sprite = unsigned16;
+        }
+        if(!packet)
+        {
+            return false;
+        }
+    }
+
+    if(frame.entities.size() != sortedCount)
+    {
+        std::sort(frame.entities.begin(), frame.entities.end(), lessById);
+    }
+    return true;
+}
+
+void interpolateNetFrame(const NetFrame &from, const NetFrame &to, float alpha, NetFrame &frame)
+{
+    frame.tick = from.tick;
+    frame.controlling = to.controlling;
+    frame.wave = from.wave;
+    frame.enemies = from.enemies;
+    frame.alive = from.alive;
+    frame.entities.assign(from.entities.begin(), from.entities.end());
+
+    for(std::size_t i = 0, j = 0; i < frame.entities.size(); i++)
+    {
+        NetEntity &entity = frame.entities[i];
+        while(j < to.entities.size() && to.entities[j].id < entity.id)
+        {
+            j++;
+        }
+        if(j < to.entities.size() && to.entities[j].id == entity.id
+                && to.entities[j].generation == entity.generation)
+        {
+            entity.x = (std::int16_t)std::lround(entity.x + (to.entities[j].x - entity.x) * alpha);
+            entity.y = (std::int16_t)std::lround(entity.y + (to.entities[j].y - entity.y) * alpha);
+        }
+    }
+}
+
+sf::Vector2<float> getNetPosition(const NetEntity &entity)
+{
+    return sf::Vector2<float>(entity.x / netPositionScale, entity.y / netPositionScale);
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <SFML/Network.hpp>
+
+#include "EntityWorld.h"
+#include "WaveManager.h"
+
+/** The first byte of every packet between GameServer and GameClient. */
+enum NetPacketType
+{
+    /** Client asks to join, sent until a WelcomePacket comes back */
+    HelloPacket,
+
+    /** Client input for a tick, and the newest snapshot it has */
+    InputPacket,
+
+    /** Client is leaving */
+    ByePacket,
+
+    /** Server accepted a client */
+    WelcomePacket,
+
+    /** Server state of the world, as a delta against a snapshot the client has */
+    SnapshotPacket
+};
+
+/** Bits of NetEntity::flags */
+enum NetEntityFlag
+{
+    NetAlive = 1,
+    NetPlayer = 2,
+    NetEnemy = 4
+};
+
+/** Bumped whenever a packet layout changes, mismatched clients are ignored. */
+const std::uint16_t netProtocolVersion = 1;
+
+/** Sent as NetFrame::tick when a snapshot isn't a delta against anything. */
+const std::uint32_t netNoTick = 0xFFFFFFFF;
+
+/** Positions are sent as 16 bit fixed point with this many steps per pixel. */
+const float netPositionScale = 8;
+
+/** Everything a client needs to draw one entity, quantized for the wire. */
+struct NetEntity
+{
+    /** The EntityId index, which is also the sort key */
+    std::uint32_t id;
+
+    /** Low bits of the EntityId generation, a new one means a new entity */
+    std::uint16_t generation;
+
+    /** NetEntityFlag bits */
+    std::uint8_t flags;
+
+    /** Index into EnemyArchetypes, for enemies */
+    std::uint16_t archetype;
+
+    /** Position in 1 / netPositionScale pixels */
+    std::int16_t x;
+    std::int16_t y;
+
+    std::int16_t health;
+    std::uint16_t sprite;
+};
+
+/** One snapshot of the world as clients see it. */
+struct NetFrame
+{
+    std::uint32_t tick;
+
+    /** Whether this client's input moves the player */
+    bool controlling;
+
+    std::uint16_t wave;
+    std::uint16_t enemies;
+    std::uint16_t alive;
+
+    /** Every entity with a sprite, sorted by id */
+    std::vector<NetEntity> entities;
+};
+
+/**
+ * @brief Fills a frame from every entity with a sprite in the world
+ *
+ * @param world The world to capture
+ * @param wave The wave progress to capture
+ * @param tick The server tick being captured
+ * @param frame Where to put it, its storage gets reused
+ */
+void captureNetFrame(EntityWorld &world, WaveManager &wave, std::uint32_t tick, NetFrame &frame);
+
+/**
+ * @brief Writes a snapshot packet with only what changed since a frame the client has
+ *
+ *  Entities that are gone are sent as ids, new ones in full, and the rest only with the
+ *  fields that changed. Entities that didn't change at all aren't sent.
+ *
+ * @param frame The frame to send
+ * @param base The newest frame the client has, or nullptr to send everything
+ * @param packet Where to write the packet
+ */
+void writeNetFrame(const NetFrame &frame, const NetFrame *base, sf::Packet &packet);
+
+/**
+ * @brief Reads the rest of a snapshot packet, after its type, tick and base tick
+ *
+ * @param packet The packet to read from
+ * @param base The frame the packet was made against, nullptr if it had none
+ * @param frame Where to put it, tick is left for the caller to fill in
+ *
+ * @return false if the packet is cut short or makes no sense
+ */
+bool readNetFrame(sf::Packet &packet, const NetFrame *base, NetFrame &frame);
+
+/**
+ * @brief Blends two frames, entities only in from are copied as they are
+ *
+ * @param from The older frame
+ * @param to The newer frame
+ * @param alpha How far between them, 0 is from and 1 is to
+ * @param frame Where to put it, its storage gets reused
+ */
+void interpolateNetFrame(const NetFrame &from, const NetFrame &to, float alpha, NetFrame &frame);
+
+/**
+ * @brief Turns a fixed point position back into pixels
+ *
+ * @param entity The entity to look at
+ *
+ * @return Its position
+ */
+sf::Vector2<float> getNetPosition(const NetEntity &entity);
@@ -0,0 +1,187 @@
+#include <algorithm>
+#include <cmath>
+
+#include "ParticleSystem.h"
+
+const ParticleEmitter ParticleSystem::hitEffect = {12, 60, 180, 0.15, 0.35, 0.02, 2,
+    sf::Color(255, 230, 140), AddBlend};
+
+const ParticleEmitter ParticleSystem::deathEffect = {40, 30, 220, 0.4, 0.9, 0.1, 3,
+    sf::Color(150, 20, 30), AlphaBlend};
+
+ParticleSystem::ParticleSystem(int capacity, int frameBudget) :
+    _capacity(capacity),
+    _frameBudget(frameBudget),
+    _count(0),
+    _spawnedThisFrame(0),
+    _droppedThisFrame(0),
+    _seed(0x9E3779B9),
+    _posX(capacity),
+    _posY(capacity),
+    _velX(capacity),
+    _velY(capacity),
+    _life(capacity),
+    _invMaxLife(capacity),
+    _drag(capacity),
+    _size(capacity),
+    _alpha(capacity),
+    _color(capacity),
+    _blend(capacity)
+{
+    _stats.live = 0;
+    _stats.spawned = 0;
+    _stats.dropped = 0;
+
+    for(int i = 0; i < ParticleBlendCount; i++)
+    {
+        _layers[i].setPrimitiveType(sf::Quads);
+    }
+}
+
+void ParticleSystem::burst(const ParticleEmitter &emitter, sf::Vector2<float> position)
+{
+    // Trim the burst to whatever is left of this frame's budget and of the pool
+    int count = std::min(emitter.count, _frameBudget - _spawnedThisFrame);
+    count = std::max(0, std::min(count, _capacity - _count));
+    _droppedThisFrame += emitter.count - count;
+    _spawnedThisFrame += count;
+
+    for(int n = 0; n < count; n++)
+    {
+        const int i = _count++;
+        const float angle = random() * 6.2831853f;
+        const float speed = emitter.minSpeed + random() * (emitter.maxSpeed - emitter.minSpeed);
+        const float life = emitter.minLife + random() * (emitter.maxLife - emitter.minLife);
+
+        _posX[i] = position.x;
+        _posY[i] = position.y;
+        _velX[i] = std::cos(angle) * speed;
+        _velY[i] = std::sin(angle) * speed;
+        _life[i] = life;
+        _invMaxLife[i] = 1.0f / life;
+        _drag[i] = emitter.drag;
+        _size[i] = emitter.size;
+        _alpha[i] = 1;
+        _color[i] = emitter.color;
+        _blend[i] = (std::uint8_t)emitter.blend;
+    }
+}
+
+// Straight line math over plain arrays with no branches, so the compiler can vectorize it.
+// The arrays never overlap, __restrict__ tells the compiler it doesn't need to check.
+static void advanceParticles(int count, float deltaTime,
+        float * __restrict__ posX, float * __restrict__ posY,
+        float * __restrict__ velX, float * __restrict__ velY,
+        float * __restrict__ life, float * __restrict__ alpha,
+        const float * __restrict__ invMaxLife, const float * __restrict__ drag)
+{
+    for(int i = 0; i < count; i++)
+    {
+        // Drag is the fraction of speed kept per second, lerp towards it over the frame
+        const float keep = 1.0f - (1.0f - drag[i]) * deltaTime;
+        velX[i] *= keep;
+        velY[i] *= keep;
+        posX[i] += velX[i] * deltaTime;
+        posY[i] += velY[i] * deltaTime;
+        life[i] -= deltaTime;
+        alpha[i] = std::max(0.0f, life[i] * invMaxLife[i]);
+    }
+}
+
+void ParticleSystem::update(float deltaTime)
+{
+    sf::Clock timer;
+    const int count = _count;
+
+    advanceParticles(count, deltaTime, _posX.data(), _posY.data(), _velX.data(), _velY.data(),
+            _life.data(), _alpha.data(), _invMaxLife.data(), _drag.data());
+
+    // Pack out the dead, walking backwards so swapped in particles are already checked
+    for(int i = count - 1; i >= 0; i--)
+    {
+        if(_life[i] <= 0)
+        {
+            const int last = --_count;
+            _posX[i] = _posX[last];
+            _posY[i] = _posY[last];
+            _velX[i] = _velX[last];
+            _velY[i] = _velY[last];
+            _life[i] = _life[last];
+            _invMaxLife[i] = _invMaxLife[last];
+            _drag[i] = _drag[last];
+            _size[i] = _size[last];
+            _alpha[i] = _alpha[last];
+            _color[i] = _color[last];
+            _blend[i] = _blend[last];
+        }
+    }
+
+    _stats.live = _count;
+    _stats.spawned = _spawnedThisFrame;
+    _stats.dropped = _droppedThisFrame;
+    _stats.updateTime = timer.getElapsedTime();
+
+    // A new frame's budget starts now
+    _spawnedThisFrame = 0;
+    _droppedThisFrame = 0;
+}
+
+void ParticleSystem::draw(RenderCounter &target)
+{
+    build();
+
+    if(_layers[AlphaBlend].getVertexCount() > 0)
+    {
+        target.draw(_layers[AlphaBlend], sf::RenderStates(sf::BlendAlpha));
+    }
+    if(_layers[AddBlend].getVertexCount() > 0)
+    {
+        target.draw(_layers[AddBlend], sf::RenderStates(sf::BlendAdd));
+    }
+}
+
+void ParticleSystem::build()
+{
+    sf::Clock timer;
+
+    for(int b = 0; b < ParticleBlendCount; b++)
+    {
+        _layers[b].clear();
+    }
+
+    for(int i = 0; i < _count; i++)
+    {
+        sf::Color color = _color[i];
+        color.a = (sf::Uint8)(color.a * _alpha[i]);
+
+        const float half = _size[i] / 2;
+        sf::VertexArray &layer = _layers[_blend[i]];
+        layer.append(sf::Vertex(sf::Vector2<float>(_posX[i] - half, _posY[i] - half), color));
+        layer.append(sf::Vertex(sf::Vector2<float>(_posX[i] + half, _posY[i] - half), color));
+        layer.append(sf::Vertex(sf::Vector2<float>(_posX[i] + half, _posY[i] + half), color));
+        layer.append(sf::Vertex(sf::Vector2<float>(_posX[i] - half, _posY[i] + half), color));
+    }
+
+    _stats.buildTime = timer.getElapsedTime();
+}
+
+void ParticleSystem::clear()
+{
+    _count = 0;
+    _spawnedThisFrame = 0;
+    _droppedThisFrame = 0;
+}
+
+const ParticleStats& ParticleSystem::getStats() const
+{
+    return _stats;
+}
+
+float ParticleSystem::random()
+{
+    // xorshift32, plenty for scattering particles and doesn't touch the global rand()
+    _seed ^= _seed << 13;
+    _seed ^= _seed >> 17;
+    _seed ^= _seed << 5;
+    return (_seed >> 8) * (1.0f / 16777216.0f);
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <SFML/Graphics.hpp>
+
+#include "RenderCounter.h"
+
+/** How a particle is blended onto the scene. */
+enum ParticleBlend
+{
+    /** Regular alpha blending. */
+    AlphaBlend,
+    /** Additive blending, for glowing effects. */
+    AddBlend,
+    ParticleBlendCount
+};
+
+/** Description of a burst of particles. */
+struct ParticleEmitter
+{
+    /** How many particles one burst spawns */
+    int count;
+
+    /** Range of speeds particles leave the burst with, in pixels per second */
+    float minSpeed;
+    float maxSpeed;
+
+    /** Range of how long particles live, in seconds */
+    float minLife;
+    float maxLife;
+
+    /** Fraction of speed kept each second */
+    float drag;
+
+    /** Size of each particle, in pixels */
+    float size;
+
+    /** Colour particles start with, they fade out to transparent over their life */
+    sf::Color color;
+
+    ParticleBlend blend;
+};
+
+/** Timing and counts of the particle system for the last frame. */
+struct ParticleStats
+{
+    /** Particles alive after the last update */
+    int live;
+
+    /** Particles spawned since the last update */
+    int spawned;
+
+    /** Particles that weren't spawned since the last update because of the budget */
+    int dropped;
+
+    /** Time spent in update() and build() the last time they ran */
+    sf::Time updateTime;
+    sf::Time buildTime;
+};
+
+/** Class which owns every particle for hit and death effects.
+ *
+ * Particles live in a fixed capacity pool of parallel arrays (structure of arrays). update()
+ * runs one branch free loop over them for velocity, lifetime and fade, so the compiler can
+ * vectorize it, then packs out the dead ones. draw() puts every particle into one vertex
+ * array per blend mode, so the whole system costs at most ParticleBlendCount draw calls.
+ *
+ * Bursts beyond the per-frame spawn budget are trimmed instead of spawned, so a pile of
+ * deaths in one frame can't blow up the frame time.
+ */
+class ParticleSystem
+{
+    public:
+        /**
+         * @brief Creates an empty pool
+         *
+         * @param capacity The most particles alive at once
+         * @param frameBudget The most particles spawned between two updates
+         */
+        ParticleSystem(int capacity, int frameBudget);
+
+        /**
+         * @brief Spawns a burst of particles
+         *
+         * @param emitter What the burst looks like
+         * @param position Where the burst comes from
+         */
+        void burst(const ParticleEmitter &emitter, sf::Vector2<float> position);
+
+        /**
+         * @brief Moves, ages and fades every particle
+         *
+         * @param deltaTime Time between last update and this one
+         */
+        void update(float deltaTime);
+
+        /**
+         * @brief Draws every particle, one draw call per blend mode
+         *
+         * @param target Where to draw to
+         */
+        void draw(RenderCounter &target);
+
+        /**
+         * @brief Removes every particle
+         */
+        void clear();
+
+        /**
+         * @brief Getter for the counters of the last frame
+         *
+         * @return The stats
+         */
+        const ParticleStats& getStats() const;
+
+        /** Burst for when the player hits an enemy */
+        static const ParticleEmitter hitEffect;
+
+        /** Burst for when an enemy dies */
+        static const ParticleEmitter deathEffect;
+
+    private:
+        int _capacity;
+        int _frameBudget;
+        int _count;
+        int _spawnedThisFrame;
+        int _droppedThisFrame;
+        ParticleStats _stats;
+
+        /** State of the little xorshift generator used for spread */
+        std::uint32_t _seed;
+
+        // One array per field, live particles are [0, _count)
+        std::vector<float> _posX;
+        std::vector<float> _posY;
+        std::vector<float> _velX;
+        std::vector<float> _velY;
+        std::vector<float> _life;
+        std::vector<float> _invMaxLife;
+        std::vector<float> _drag;
+        std::vector<float> _size;
+        std::vector<float> _alpha;
+        std::vector<sf::Color> _color;
+        std::vector<std::uint8_t> _blend;
+
+        sf::VertexArray _layers[ParticleBlendCount];
+
+        /**
+         * @brief Puts the particles into the vertex arrays
+         */
+        void build();
+
+        /**
+         * @brief Gets the next random number
+         *
+         * @return Random number in [0, 1)
+         */
+        float random();
+};
@@ -1,74 +1,165 @@
 #include "Player.h"
 #include <cmath>
 
-Player::Player() : 
-    // Initialize movement vector to <0, 0>
-    _moveVec(sf::Vector2<float>(0, 0)),
-    _dodgeVec(sf::Vector2<float>(0, 0))
+constexpr float Player::_moveSpeed;
+constexpr float Player::_dodgeSpeed;
+constexpr float Player::_friction;
+constexpr float Player::_dodgeFriction;
+constexpr float Player::_attackRange;
+constexpr float Player::_deadZone;
+
+Player::Player() :
+    _world(nullptr),
+    _events(nullptr),
+    _animations(nullptr),
+    _idleClip(0),
+    _walkClip(0),
+    _attackClip(0),
+    _dodgeClip(0)
+{
+
+}
+
+void Player::spawn(EntityWorld &world, TextureCache &textures, AnimationLibrary &animations,
+        sf::Vector2<float> spawnLocation)
+{
+    _world = &world;
+    _animations = &animations;
+
+    // TODO: Does this need to by dynamic?
+    int texture = textures.load("assets/textures/test.png");
+    int still = textures.addSprite(texture, sf::IntRect());
+    _idleClip = findClip(animations, "player_idle", still);
+    _walkClip = findClip(animations, "player_walk", still);
+    _attackClip = findClip(animations, "player_attack", still);
+    _dodgeClip = findClip(animations, "player_dodge", still);
+
+    // Initialize velocity and movement vectors to <0, 0>, and set default move state to None
+    Transform transform = {spawnLocation, sf::Vector2<float>(0, 0)};
+    // The player collides with the box its sprite covers
+    const SpriteDef &idle = textures.getSprite(animations.getSprite(_idleClip, 0));
+    Bounds bounds = {idle.rect.width, idle.rect.height};
+    Health health = {100, true};
+    SpriteRef sprite = {animations.getSprite(_idleClip, 0)};
+    PlayerControl control = {None, sf::Vector2<float>(0, 0), sf::Vector2<float>(0, 0),
+        sf::Vector2<float>(0, 0)};
+    Animation animation = {(std::uint16_t)_idleClip, 0, 0, false};
+
+    _id = world.create(transform, bounds, health, sprite, control, animation);
+}
+
+int Player::findClip(AnimationLibrary &animations, const std::string &name, int sprite)
+{
+    int clip = animations.find(name);
+    return clip >= 0 ? clip : animations.addStill(name, sprite);
+}
+
+EntityId Player::getId() const
+{
+    return _id;
+}
+
+sf::Vector2<float> Player::getPosition() const
+{
+    return _world->get<Transform>(_id)->position;
+}
+
+int Player::getHealth() const
+{
+    return _world->get<Health>(_id)->health;
+}
+
+bool Player::isAlive() const
+{
+    return ::isAlive(*_world, _id);
+}
+
+void Player::setEventBuffer(EventBuffer *events)
+{
+    _events = events;
+}
+
+void Player::doDamage(int damage, EventBuffer *events)
+{
+    ::doDamage(*_world, _id, damage, events);
+}
+
+PlayerControl& Player::getControl() const
 {
-    // Set default move state to None
-    _currentMoveState = None;
+    return *_world->get<PlayerControl>(_id);
 }
 
 // TODO: Dodging and then moving in a different direction causes it to zip around at mach 6
 
-// Pure virtual function from the Entity class
-void Player::onUpdate(float deltaTime)
+void Player::updateAll(EntityWorld &world, float deltaTime)
 {
-    // At this point, we want to slow down if we are not currently moving 
+    world.eachBatch<Transform, PlayerControl>([deltaTime](std::size_t count, const EntityId *ids,
+            Transform *transform, PlayerControl *control)
+    {
+        for(std::size_t i = 0; i < count; i++)
+        {
+            onUpdate(transform[i], control[i], deltaTime);
+        }
+    });
+}
+
+void Player::onUpdate(Transform &transform, PlayerControl &control, float deltaTime)
+{
+    sf::Vector2<float> &velocity = transform.velocity;
+
+    // At this point, we want to slow down if we are not currently moving
     // We want to individually check each movement axis to see if we need to slow them
-    this->_velocity.x = this->checkDeadMoveAxis(this->_velocity.x, this->_moveVec.x,
-            this->_friction, deltaTime);
-    this->_velocity.y = this->checkDeadMoveAxis(this->_velocity.y, this->_moveVec.y,
-            this->_friction, deltaTime);
+    velocity.x = checkDeadMoveAxis(velocity.x, control.moveVec.x, control.moveVec, _friction, deltaTime);
+    velocity.y = checkDeadMoveAxis(velocity.y, control.moveVec.y, control.moveVec, _friction, deltaTime);
 
     // If there is movement on both axes, then we want to do something special
-    if(this->_moveVec.x != 0 && this->_moveVec.y != 0)
+    if(control.moveVec.x != 0 && control.moveVec.y != 0)
     {
         // We want to get the magnitude of the moveVector to make sure we're not moving
         // more when moving diagonally vs laterally
-        sf::Vector2<float> moveVecUnit = this->getUnitVector(this->_moveVec);
+        sf::Vector2<float> moveVecUnit = getUnitVector(control.moveVec);
 
         // Set the current velocity to the movement vector
         // We want to multiply by the private move speed var so we don't move at
         // a snail's pace, this can be edited for better feeling movement before compile
-        this->_velocity.x = (abs(this->_velocity.x + moveVecUnit.x * this->_friction *
-            deltaTime)) > this->_moveSpeed ? (this->_velocity.x < 0 ? -this->_moveSpeed :
-            this->_moveSpeed) : this->_velocity.x + moveVecUnit.x * this->_friction * deltaTime;       
+        velocity.x = (abs(velocity.x + moveVecUnit.x * _friction *
+            deltaTime)) > _moveSpeed ? (velocity.x < 0 ? -_moveSpeed :
+            _moveSpeed) : velocity.x + moveVecUnit.x * _friction * deltaTime;
 
-        this->_velocity.y = (abs(this->_velocity.y + moveVecUnit.y * this->_friction * 
-            deltaTime)) > this->_moveSpeed ? (this->_velocity.y < 0 ? -this->_moveSpeed :
-            this->_moveSpeed) : this->_velocity.y + moveVecUnit.y * this->_friction * deltaTime;
-    }  
+        velocity.y = (abs(velocity.y + moveVecUnit.y * _friction *
+            deltaTime)) > _moveSpeed ? (velocity.y < 0 ? -_moveSpeed :
+            _moveSpeed) : velocity.y + moveVecUnit.y * _friction * deltaTime;
+    }
 
-    if(this->_dodgeVec.x != 0 || this->_dodgeVec.y != 0)
+    if(control.dodgeVec.x != 0 || control.dodgeVec.y != 0)
     {
         // TODO: There needs to be a better way to call this function
-        this->_dodgeVec.x = this->checkDeadMoveAxis(this->_dodgeVec.x, 0, this->_dodgeFriction,
+        control.dodgeVec.x = checkDeadMoveAxis(control.dodgeVec.x, 0, control.moveVec, _dodgeFriction,
                 deltaTime);
-        this->_dodgeVec.y = this->checkDeadMoveAxis(this->_dodgeVec.y, 0, this->_dodgeFriction,
+        control.dodgeVec.y = checkDeadMoveAxis(control.dodgeVec.y, 0, control.moveVec, _dodgeFriction,
                 deltaTime);
 
-        this->_velocity += this->_dodgeVec;
-    } 
+        velocity += control.dodgeVec;
+    }
 
     // Only if the current move vector is non zero
-    if(this->_moveVec.x != 0 || this->_moveVec.y != 0)
+    if(control.moveVec.x != 0 || control.moveVec.y != 0)
     {
         // Set previous move vector for dodging
-        this->_lastMoveVec = this->_moveVec;
+        control.lastMoveVec = control.moveVec;
     }
 
     // Reset the movement vector to <0, 0>
-    this->_moveVec = sf::Vector2<float>(0, 0);
+    control.moveVec = sf::Vector2<float>(0, 0);
 }
 
-float Player::checkDeadMoveAxis(float velAxis, float moveAxis, float friction, float deltaTime)
+float Player::checkDeadMoveAxis(float velAxis, float moveAxis, sf::Vector2<float> moveVec,
+        float friction, float deltaTime)
 {
-    if(moveAxis == 0) 
+    if(moveAxis == 0)
     {
         // We want to decrease the x and y components of velocity by the friction each frame
-        if(abs(velAxis) - friction * deltaTime >= this->_deadZone)
+        if(abs(velAxis) - friction * deltaTime >= _deadZone)
         {
             return velAxis + (velAxis > 0 ? -friction : friction) * deltaTime;
         }
@@ -81,35 +172,34 @@ float Player::checkDeadMoveAxis(float velAxis, float moveAxis, float friction, f
     {
         // I'm sorry, this is so fucking gross
         // TODO: Fix this mess
-        return (abs(velAxis + moveAxis * this->_friction * deltaTime)) >
-            this->_moveSpeed / this->getVectorMagnitude(this->_moveVec) ?
-            (velAxis < 0 ? -this->_moveSpeed : this->_moveSpeed) /
-            this->getVectorMagnitude(this->_moveVec) :
-            velAxis + moveAxis * this->_friction * deltaTime;
+        return (abs(velAxis + moveAxis * _friction * deltaTime)) >
+            _moveSpeed / getVectorMagnitude(moveVec) ?
+            (velAxis < 0 ? -_moveSpeed : _moveSpeed) /
+            getVectorMagnitude(moveVec) :
+            velAxis + moveAxis * _friction * deltaTime;
     }
 }
 
-void Player::onCollision(Entity &hitEntity)
-{
-
-}
-
 void Player::moveInDirection(sf::Vector2<float> moveDir)
 {
+    PlayerControl &control = getControl();
+
     // We want to round the product of the given moveDir
-    this->_moveVec += moveDir;
+    control.moveVec += moveDir;
 
     // We also want to tell the player it was given input, as to now slow its input down
-    this->_currentMoveState = MoveState::Moving;
+    control.moveState = MoveState::Moving;
 }
 
 void Player::dodgeInDirection(sf::Vector2<float> dodgeDir)
 {
+    PlayerControl &control = getControl();
+
     // The first thing we want to do is set the dodge vector now
-    this->_dodgeVec = this->getUnitVector(this->_lastMoveVec) * this->_dodgeSpeed;
+    control.dodgeVec = getUnitVector(control.lastMoveVec) * _dodgeSpeed;
 
-    // When we dodge, we want to set the state of movement to dodging 
-    this->_currentMoveState = MoveState::Dodging;
+    // When we dodge, we want to set the state of movement to dodging
+    control.moveState = MoveState::Dodging;
 }
 
 float Player::getVectorMagnitude(sf::Vector2<float> vec)
@@ -121,35 +211,65 @@ float Player::getVectorMagnitude(sf::Vector2<float> vec)
 sf::Vector2<float> Player::getUnitVector(sf::Vector2<float> vec)
 {
     // Get the unit vector using the above magnitude
-    return vec / this->getVectorMagnitude(vec);
+    return vec / getVectorMagnitude(vec);
 }
 
-void Player::attack(Entity* toAttack)
+void Player::attack(EntityId toAttack)
 {
+    // Start the swing over every time, even if the last one hasn't finished
+    playAnimation(*_world, _id, *_animations, _attackClip, true);
+
     // TODO: Change this
-    toAttack->doDamage(40);
+    if(toAttack.isValid())
+    {
+        ::doDamage(*_world, toAttack, 40, _events);
+    }
+}
+
+void Player::updateAnimation()
+{
+    const Animation &animation = *_world->get<Animation>(_id);
+    if(animation.clip == _attackClip && !animation.finished)
+    {
+        return;
+    }
+
+    const PlayerControl &control = getControl();
+    const sf::Vector2<float> &velocity = _world->get<Transform>(_id)->velocity;
+    if(control.dodgeVec.x != 0 || control.dodgeVec.y != 0)
+    {
+        playAnimation(*_world, _id, *_animations, _dodgeClip);
+    }
+    else if(velocity.x != 0 || velocity.y != 0)
+    {
+        playAnimation(*_world, _id, *_animations, _walkClip);
+    }
+    else
+    {
+        playAnimation(*_world, _id, *_animations, _idleClip);
+    }
 }
 
 void Player::counter()
 {
-    
+
 }
 
-bool Player::isDodging()
+bool Player::isDodging() const
 {
-    if(_currentMoveState==Dodging)
+    if(getControl().moveState==Dodging)
     {
         return(true);
     }
     return(false);
 }
 
-const sf::Vector2<float>& Player::getLastMoveDirection() const
+sf::Vector2<float> Player::getLastMoveDirection() const
 {
-    return this->_lastMoveVec;
+    return getControl().lastMoveVec;
 }
 
 const float& Player::getAttackRange() const
 {
-    return this->_attackRange;
+    return _attackRange;
 }
@@ -2,6 +2,8 @@
 
 #include <math.h>
 #include "Entity.h"
+#include "TextureCache.h"
+#include "Animation.h"
 
 /** Enum which holds what state the player is in. */
 enum MoveState
@@ -14,17 +16,90 @@ enum MoveState
     None
 };
 
+/** Component holding the player's movement input. */
+struct PlayerControl
+{
+    // TODO: Unsure if this is needed
+    MoveState moveState;
+
+    // Current direction to move in based off given user input
+    sf::Vector2<float> moveVec;
+    sf::Vector2<float> lastMoveVec;
+
+    // Current direction player is dodging in, as well as the speed of the dodge
+    sf::Vector2<float> dodgeVec;
+};
+
+template<> struct ComponentInfo<PlayerControl> { enum { id = PlayerControlComponent }; };
+
 /** Class for the player.
- * 
- * The Player is an Entity which is controlled by the player and responds to keyboard input.
+ *
+ * The player is an entity bundle (Transform, Bounds, Health, SpriteRef, PlayerControl and
+ * Animation) which is controlled by the player and responds to keyboard input. This class is
+ * the handle GameManager steers it through; the movement itself runs in updateAll().
  */
-class Player : public Entity
+class Player
 {
     public:
         Player();
 
         /**
-         * @brief Tells the player which direction it needs to be moving 
+         * @brief Creates the player's components in the world
+         *
+         * @param world The world to spawn in
+         * @param textures Where the player's texture gets loaded into
+         * @param animations The clips to play, the player's are named player_idle, player_walk,
+         *  player_attack and player_dodge. Any that are missing get added as the plain texture.
+         * @param spawnLocation The location to spawn the player at
+         */
+        void spawn(EntityWorld &world, TextureCache &textures, AnimationLibrary &animations,
+                sf::Vector2<float> spawnLocation);
+
+        /**
+         * @brief Getter for the player's entity
+         *
+         * @return The id of the player in the world
+         */
+        EntityId getId() const;
+
+        /**
+         * @brief Getter for player position
+         *
+         * @return Player's position
+         */
+        sf::Vector2<float> getPosition() const;
+
+        /**
+         * @brief Getter for player health
+         *
+         * @return Health of player
+         */
+        int getHealth() const;
+
+        /**
+         * @brief Getter for is player is alive
+         *
+         * @return If player is alive
+         */
+        bool isAlive() const;
+
+        /**
+         * @brief Sets where the events of the player's attacks get raised
+         *
+         * @param events The player's buffer, or nullptr to stop raising them
+         */
+        void setEventBuffer(EventBuffer *events);
+
+        /**
+         * @brief Will tell the player to lower it's health
+         *
+         * @param damage The amount of damage to do
+         * @param events If given, the buffer of whatever did the damage, the events go in it
+         */
+        void doDamage(int damage, EventBuffer *events = nullptr);
+
+        /**
+         * @brief Tells the player which direction it needs to be moving
          *
          * @param moveDir The direction from either the controller, or a keyboard input
          *  these will be added later
@@ -39,9 +114,11 @@ class Player : public Entity
         void dodgeInDirection(sf::Vector2<float> dodgeDir);
 
         /**
-         * @brief Tells the player it needs to be attacking 
+         * @brief Tells the player it needs to be attacking
+         *
+         * @param toAttack The entity being hit, or an invalid id to swing at nothing
          */
-        void attack(Entity* toAttack);
+        void attack(EntityId toAttack);
 
         /**
          * @brief Tells the player it needs to be countering
@@ -50,17 +127,17 @@ class Player : public Entity
 
         /**
          * @brief checks if player is dodging
-         * 
+         *
          * @return true if dodging
          */
-        bool isDodging();
+        bool isDodging() const;
 
         /**
          * @brief Gets the last direction the player moved in (for attacking)
          *
-         * @return Hmmmm, I wonder? Maybe the last direction the player moved in?? 
+         * @return Hmmmm, I wonder? Maybe the last direction the player moved in??
          */
-        const sf::Vector2<float>& getLastMoveDirection() const;
+        sf::Vector2<float> getLastMoveDirection() const;
 
         /**
          * @brief Getter for attack range
@@ -70,68 +147,102 @@ class Player : public Entity
          */
         const float& getAttackRange() const;
 
+        /**
+         * @brief Called from GameManager, updates the velocity of every player entity
+         *  based off user input
+         *
+         * @param world The world to update
+         * @param deltaTime Time between last update and this one
+         */
+        static void updateAll(EntityWorld &world, float deltaTime);
+
+        /**
+         * @brief Called from GameSimulation after updateAll(), picks the clip that matches
+         *  what the player is doing. An attack plays out in full before anything replaces it.
+         */
+        void updateAnimation();
+
     private:
         // Constants for player movement
-        const float _moveSpeed = 350;
-        const float _dodgeSpeed = 1100;
-        const float _friction = 1600;
-        const float _dodgeFriction = 6000;
-        const float _attackRange = 250;
-        const float _deadZone = 0.01;
+        static constexpr float _moveSpeed = 350;
+        static constexpr float _dodgeSpeed = 1100;
+        static constexpr float _friction = 1600;
+        static constexpr float _dodgeFriction = 6000;
+        static constexpr float _attackRange = 250;
+        static constexpr float _deadZone = 0.01;
+
+        /** The world the player lives in */
+        EntityWorld *_world;
 
-        // TODO: Unsure if this is needed
-        MoveState _currentMoveState;
+        /** The player's entity in _world */
+        EntityId _id;
 
-        // Current direction to move in based off given user input
-        sf::Vector2<float> _moveVec;
-        sf::Vector2<float> _lastMoveVec;
+        /** Where the player's attacks raise their events, if anywhere */
+        EventBuffer *_events;
 
-        // Current direction player is dodging in, as well as the speed of the dodge
-        sf::Vector2<float> _dodgeVec;
+        /** The clips the player plays, and where they're defined */
+        const AnimationLibrary *_animations;
+        int _idleClip;
+        int _walkClip;
+        int _attackClip;
+        int _dodgeClip;
 
         /**
-         * @brief Overrided function from Entity, auto called from GameManager
-         *  Used to update the entity based off user input
+         * @brief Finds one of the player's clips, adding it as a single sprite if it's missing
          *
-         * @param deltaTime Time between last update and this one
+         * @param animations Where to look
+         * @param name Name of the clip
+         * @param sprite Sprite to use if it's missing
+         *
+         * @return Index of the clip
+         */
+        static int findClip(AnimationLibrary &animations, const std::string &name, int sprite);
+
+        /**
+         * @brief Getter for the player's input component
+         *
+         * @return The PlayerControl of the player entity
          */
-        void onUpdate(float deltaTime);
+        PlayerControl& getControl() const;
 
         /**
-         * @brief Overrided function from Entity, auto called from GameManager
-         *  Used to handle collisions
+         * @brief Updates one player's velocity based off its input
          *
-         * @param hitEntity
+         * @param transform The player's transform
+         * @param control The player's input
+         * @param deltaTime Time between last update and this one
          */
-        void onCollision(Entity &hitEntity); 
+        static void onUpdate(Transform &transform, PlayerControl &control, float deltaTime);
 
         /**
          * @brief Handles slowing down when player isn't moving in a particular direction
          *
          * @param velAxis The velocity axis we're checking
          * @param moveAxis The direction we're supposed to be moving
+         * @param moveVec The full direction we're supposed to be moving
          * @param friction The friction for this type of movement
          * @param deltaTime The time needed to properly adjust for velocity and acceleration
          *
-         * @return The new value for the velocity after slow down 
+         * @return The new value for the velocity after slow down
          */
-        float checkDeadMoveAxis(float velAxis, float moveAxis, float friction, float deltaTime);
+        static float checkDeadMoveAxis(float velAxis, float moveAxis, sf::Vector2<float> moveVec,
+                float friction, float deltaTime);
 
         /**
          * @brief Get the magnitude of a vector
          *
          * @param vec The vector to get the magnitude of
          *
-         * @return The magnitude of the vector 
+         * @return The magnitude of the vector
          */
-        float getVectorMagnitude(sf::Vector2<float> vec);
+        static float getVectorMagnitude(sf::Vector2<float> vec);
 
         /**
          * @brief Get the unit vector of any vector
          *
          * @param vec The vector to get the unit of
          *
-         * @return The unit vector 
+         * @return The unit vector
          */
-        sf::Vector2<float> getUnitVector(sf::Vector2<float> vec);
+        static sf::Vector2<float> getUnitVector(sf::Vector2<float> vec);
 };
@@ -0,0 +1,210 @@
+#include <algorithm>
+#include <cmath>
+
+#include "ProjectileSystem.h"
+#include "Collision.h"
+#include "Entity.h"
+
+ProjectileSystem::ProjectileSystem(int capacity, sf::FloatRect bounds) :
+    _capacity(capacity),
+    _count(0),
+    _bounds(bounds),
+    _posX(capacity),
+    _posY(capacity),
+    _velX(capacity),
+    _velY(capacity),
+    _life(capacity),
+    _damage(capacity),
+    _team(capacity),
+    _dead(capacity),
+    _vertices(sf::Quads)
+{
+
+}
+
+bool ProjectileSystem::fire(sf::Vector2<float> position, sf::Vector2<float> velocity, int damage,
+        ProjectileTeam team, float lifetime)
+{
+    if(_count >= _capacity)
+    {
+        return false;
+    }
+
+    const int i = _count++;
+    _posX[i] = position.x;
+    _posY[i] = position.y;
+    _velX[i] = velocity.x;
+    _velY[i] = velocity.y;
+    _life[i] = lifetime;
+    _damage[i] = (std::int16_t)damage;
+    _team[i] = (std::uint8_t)team;
+    _dead[i] = 0;
+    return true;
+}
+
+void ProjectileSystem::update(float deltaTime, EntityWorld &world, const SpatialGrid &grid,
+        Player &player, const sf::FloatRect &playerBox, EventBuffer *events)
+{
+    const int count = _count;
+    float *posX = _posX.data();
+    float *posY = _posY.data();
+    const float *velX = _velX.data();
+    const float *velY = _velY.data();
+    float *life = _life.data();
+
+    // First the hit pass, each projectile sweeps the segment it is about to travel
+    for(int i = 0; i < count; i++)
+    {
+        const sf::Vector2<float> start(posX[i], posY[i]);
+        const sf::Vector2<float> delta(velX[i] * deltaTime, velY[i] * deltaTime);
+        SweepHit hit;
+        _dead[i] = 0;
+
+        if(_team[i] == EnemyTeam)
+        {
+            if(player.isAlive() && sweepSegment(start, delta, playerBox, hit))
+            {
+                player.doDamage(_damage[i], events);
+                _dead[i] = 1;
+            }
+            continue;
+        }
+
+        // Only the enemies in the cells around the segment can be hit
+        const sf::FloatRect area(std::min(start.x, start.x + delta.x), std::min(start.y, start.y + delta.y),
+                std::abs(delta.x), std::abs(delta.y));
+        float bestTime = 2;
+        EntityId bestId;
+        grid.query(area, [&](EntityId id, const sf::FloatRect &box)
+        {
+            SweepHit enemyHit;
+            if(sweepSegment(start, delta, box, enemyHit) && enemyHit.time < bestTime)
+            {
+                bestTime = enemyHit.time;
+                bestId = id;
+            }
+        });
+
+        // The closest enemy along the path takes the hit
+        if(bestId.isValid())
+        {
+            doDamage(world, bestId, _damage[i], events);
+            _dead[i] = 1;
+        }
+    }
+
+    // Then move everything in one straight pass over the arrays
+    for(int i = 0; i < count; i++)
+    {
+        posX[i] += velX[i] * deltaTime;
+        posY[i] += velY[i] * deltaTime;
+        life[i] -= deltaTime;
+    }
+
+    // Finally pack the survivors, walking backwards so swapped in projectiles are already checked
+    const float right = _bounds.left + _bounds.width;
+    const float bottom = _bounds.top + _bounds.height;
+    for(int i = count - 1; i >= 0; i--)
+    {
+        if(_dead[i] || life[i] <= 0 || posX[i] < _bounds.left || posX[i] > right
+                || posY[i] < _bounds.top || posY[i] > bottom)
+        {
+            removeAt(i);
+        }
+    }
+}
+
+void ProjectileSystem::draw(RenderCounter &target)
+{
+    if(_count == 0)
+    {
+        return;
+    }
+
+    const float halfSize = 2;
+    const sf::Color colors[TeamCount] = {sf::Color(120, 220, 255), sf::Color(255, 90, 40)};
+
+    _vertices.resize(_count * 4);
+    for(int i = 0; i < _count; i++)
+    {
+        const sf::Color &color = colors[_team[i]];
+        sf::Vertex *quad = &_vertices[i * 4];
+        quad[0] = sf::Vertex(sf::Vector2<float>(_posX[i] - halfSize, _posY[i] - halfSize), color);
+        quad[1] = sf::Vertex(sf::Vector2<float>(_posX[i] + halfSize, _posY[i] - halfSize), color);
+        quad[2] = sf::Vertex(sf::Vector2<float>(_posX[i] + halfSize, _posY[i] + halfSize), color);
+        quad[3] = sf::Vertex(sf::Vector2<float>(_posX[i] - halfSize, _posY[i] + halfSize), color);
+    }
+
+    target.draw(_vertices);
+}
+
+void ProjectileSystem::clear()
+{
+    _count = 0;
+}
+
+int ProjectileSystem::size() const
+{
+    return _count;
+}
+
+int ProjectileSystem::getCapacity() const
+{
+    return _capacity;
+}
+
+void ProjectileSystem::saveTo(Snapshot &snapshot) const
+{
+    snapshot.write((std::int32_t)_count);
+    snapshot.write(_posX.data(), _count * sizeof(float));
+    snapshot.write(_posY.data(), _count * sizeof(float));
+    snapshot.write(_velX.data(), _count * sizeof(float));
+    snapshot.write(_velY.data(), _count * sizeof(float));
+    snapshot.write(_life.data(), _count * sizeof(float));
+    snapshot.write(_damage.data(), _count * sizeof(std::int16_t));
+    snapshot.write(_team.data(), _count * sizeof(std::uint8_t));
+}
+
+bool ProjectileSystem::loadFrom(Snapshot &snapshot)
+{
+    std::int32_t count;
+    if(!snapshot.read(count) || count < 0 || count > _capacity)
+    {
+        return false;
+    }
+
+    _count = count;
+    if(!snapshot.read(_posX.data(), _count * sizeof(float))
+            || !snapshot.read(_posY.data(), _count * sizeof(float))
+            || !snapshot.read(_velX.data(), _count * sizeof(float))
+            || !snapshot.read(_velY.data(), _count * sizeof(float))
+            || !snapshot.read(_life.data(), _count * sizeof(float))
+            || !snapshot.read(_damage.data(), _count * sizeof(std::int16_t))
+            || !snapshot.read(_team.data(), _count * sizeof(std::uint8_t)))
+    {
+        return false;
+    }
+
+    // The team picks the colour a projectile is drawn in and who it hits
+    for(int i = 0; i < _count; i++)
+    {
+        if(_team[i] >= TeamCount)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ProjectileSystem::removeAt(int index)
+{
+    const int last = --_count;
+    _posX[index] = _posX[last];
+    _posY[index] = _posY[last];
+    _velX[index] = _velX[last];
+    _velY[index] = _velY[last];
+    _life[index] = _life[last];
+    _damage[index] = _damage[last];
+    _team[index] = _team[last];
+    _dead[index] = _dead[last];
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <SFML/Graphics.hpp>
+
+#include "EntityWorld.h"
+#include "SpatialGrid.h"
+#include "Player.h"
+#include "Snapshot.h"
+#include "RenderCounter.h"
+
+/** Which side fired a projectile, and so who it can hit. */
+enum ProjectileTeam
+{
+    /** Fired by the player, hits enemies. */
+    PlayerTeam,
+    /** Fired by enemies, hits the player. */
+    EnemyTeam,
+    TeamCount
+};
+
+/** Class which owns every projectile in flight.
+ *
+ * Projectiles are stored as a fixed capacity pool of parallel arrays (structure of arrays),
+ * with the live ones packed at the front. update() moves all of them in one straight pass,
+ * then sweeps the segment each one travelled this tick against the boxes it could hit, so
+ * fast projectiles can't pass through a target between frames. Nothing is allocated after
+ * construction.
+ */
+class ProjectileSystem
+{
+    public:
+        /**
+         * @brief Creates an empty pool
+         *
+         * @param capacity The most projectiles that can be in flight at once
+         * @param bounds Projectiles leaving this area are removed
+         */
+        ProjectileSystem(int capacity, sf::FloatRect bounds);
+
+        /**
+         * @brief Launches a projectile
+         *
+         * @param position Where it starts
+         * @param velocity How fast it moves, in pixels per second
+         * @param damage Damage done to whatever it hits
+         * @param team Who fired it
+         * @param lifetime How many seconds it flies before it is removed
+         *
+         * @return false if the pool is full and nothing was fired
+         */
+        bool fire(sf::Vector2<float> position, sf::Vector2<float> velocity, int damage,
+                ProjectileTeam team, float lifetime);
+
+        /**
+         * @brief Moves every projectile and applies the damage of everything that hit
+         *
+         * @param deltaTime Time between last update and this one
+         * @param world The world the targets live in
+         * @param grid Index of the enemies, built this tick
+         * @param player The player
+         * @param playerBox The player's box this tick
+         * @param events If given, the events of every hit go in it, on the player or on enemies
+         */
+        void update(float deltaTime, EntityWorld &world, const SpatialGrid &grid, Player &player,
+                const sf::FloatRect &playerBox, EventBuffer *events = nullptr);
+
+        /**
+         * @brief Draws every projectile in a single draw call
+         *
+         * @param target Where to draw to
+         */
+        void draw(RenderCounter &target);
+
+        /**
+         * @brief Removes every projectile
+         */
+        void clear();
+
+        /**
+         * @brief Writes every projectile in flight into a snapshot, one memcpy per field
+         *
+         * @param snapshot Where to write to
+         */
+        void saveTo(Snapshot &snapshot) const;
+
+        /**
+         * @brief Replaces every projectile with the ones in a snapshot
+         *
+         * @param snapshot Where to read from
+         *
+         * @return false if the snapshot is cut short, holds more than the pool fits or has a
+         *  projectile of no team
+         */
+        bool loadFrom(Snapshot &snapshot);
+
+        /**
+         * @brief Getter for the number of projectiles in flight
+         *
+         * @return Number of live projectiles
+         */
+        int size() const;
+
+        /**
+         * @brief Getter for the pool size
+         *
+         * @return Most projectiles that can be in flight at once
+         */
+        int getCapacity() const;
+
+    private:
+        int _capacity;
+        int _count;
+        sf::FloatRect _bounds;
+
+        // One array per field, live projectiles are [0, _count)
+        std::vector<float> _posX;
+        std::vector<float> _posY;
+        std::vector<float> _velX;
+        std::vector<float> _velY;
+        std::vector<float> _life;
+        std::vector<std::int16_t> _damage;
+        std::vector<std::uint8_t> _team;
+
+        /** Set during the hit pass for projectiles that need removing */
+        std::vector<std::uint8_t> _dead;
+
+        sf::VertexArray _vertices;
+
+        /**
+         * @brief Removes a projectile by moving the last live one into its slot
+         *
+         * @param index The projectile to remove
+         */
+        void removeAt(int index);
+};
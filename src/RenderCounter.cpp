@@ -0,0 +1,125 @@
+#include "RenderCounter.h"
+
+RenderCounter::RenderCounter(sf::RenderTarget &target) :
+    _target(&target)
+{
+    reset();
+}
+
+void RenderCounter::draw(const sf::Vertex *vertices, std::size_t count, sf::PrimitiveType type,
+        const sf::RenderStates &states)
+{
+    if(count == 0)
+    {
+        return;
+    }
+
+    this->count(count, type, states.texture);
+    _target->draw(vertices, count, type, states);
+}
+
+void RenderCounter::draw(const sf::VertexArray &vertices, const sf::RenderStates &states)
+{
+    if(vertices.getVertexCount() == 0)
+    {
+        return;
+    }
+
+    this->count(vertices.getVertexCount(), vertices.getPrimitiveType(), states.texture);
+    _target->draw(vertices, states);
+}
+
+void RenderCounter::draw(const sf::Sprite &sprite, const sf::RenderStates &states)
+{
+    this->count(4, sf::TriangleStrip, sprite.getTexture());
+    _target->draw(sprite, states);
+}
+
+void RenderCounter::draw(const sf::Text &text, const sf::RenderStates &states)
+{
+    // Spaces and line breaks don't get any vertices
+    const sf::String &string = text.getString();
+    std::size_t characters = 0;
+    for(std::size_t i = 0; i < string.getSize(); i++)
+    {
+        characters += (string[i] != ' ' && string[i] != '\t' && string[i] != '\n') ? 1 : 0;
+    }
+    if(characters == 0)
+    {
+        return;
+    }
+
+    // The outline is a draw of its own under the fill
+    if(text.getOutlineThickness() != 0)
+    {
+        this->count(characters * 6, sf::Triangles, text.getFont());
+    }
+    this->count(characters * 6, sf::Triangles, text.getFont());
+    _target->draw(text, states);
+}
+
+void RenderCounter::setTarget(sf::RenderTarget &target)
+{
+    _target = &target;
+
+    // Every target has its own bindings
+    _lastTexture = this;
+}
+
+sf::RenderTarget& RenderCounter::getTarget()
+{
+    return *_target;
+}
+
+const RenderCounts& RenderCounter::getCounts() const
+{
+    return _counts;
+}
+
+void RenderCounter::reset()
+{
+    _counts.drawCalls = 0;
+    _counts.vertices = 0;
+    _counts.primitives = 0;
+    _counts.textureBinds = 0;
+    _counts.bytes = 0;
+
+    // Whatever was bound last frame is unknown now
+    _lastTexture = this;
+}
+
+void RenderCounter::count(std::size_t vertices, sf::PrimitiveType type, const void *texture)
+{
+    _counts.drawCalls++;
+    _counts.vertices += vertices;
+    _counts.bytes += vertices * sizeof(sf::Vertex);
+
+    switch(type)
+    {
+        case sf::Points:
+            _counts.primitives += vertices;
+            break;
+        case sf::Lines:
+            _counts.primitives += vertices / 2;
+            break;
+        case sf::Triangles:
+            _counts.primitives += vertices / 3;
+            break;
+        case sf::Quads:
+            _counts.primitives += vertices / 4;
+            break;
+        case sf::LineStrip:
+            _counts.primitives += vertices - 1;
+            break;
+        default:
+            // Triangle strips and fans share every vertex but the first two
+            _counts.primitives += vertices > 2 ? vertices - 2 : 0;
+            break;
+    }
+
+    if(texture != _lastTexture)
+    {
+        _counts.textureBinds += texture != nullptr ? 1 : 0;
+        _lastTexture = texture;
+    }
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstddef>
+#include <SFML/Graphics.hpp>
+
+/** What was drawn through a RenderCounter since it was last reset. */
+struct RenderCounts
+{
+    /** Draw calls that reached the target */
+    int drawCalls;
+
+    /** Vertices handed to those draw calls */
+    std::size_t vertices;
+
+    /** Points, lines, triangles or quads those vertices make up */
+    std::size_t primitives;
+
+    /** Draw calls that used a different texture to the draw before them */
+    int textureBinds;
+
+    /** Bytes of vertex data handed over */
+    std::size_t bytes;
+};
+
+/** Class which passes draws on to a render target and counts them.
+ *
+ * Everything in the frame is drawn through one of these instead of straight to the
+ * window, so the same draw code can be measured drawing into a window or an
+ * sf::RenderTexture. Draws with nothing in them aren't passed on or counted, the same as
+ * SFML skips them. A frame drawn into more than one target moves the counter between them
+ * with setTarget(), and the counts cover all of it.
+ *
+ * A texture bind is counted whenever a draw uses a different texture to the one before it,
+ * which is when SFML has to switch. Text counts as drawn with its font, whose glyph page is
+ * the texture.
+ */
+class RenderCounter
+{
+    public:
+        /**
+         * @brief Starts counting draws to a target
+         *
+         * @param target Where everything gets drawn, must outlive the counter
+         */
+        explicit RenderCounter(sf::RenderTarget &target);
+
+        /**
+         * @brief Draws some vertices
+         *
+         * @param vertices The vertices
+         * @param count How many
+         * @param type What they make up
+         * @param states Texture, blending and transform to draw with
+         */
+        void draw(const sf::Vertex *vertices, std::size_t count, sf::PrimitiveType type,
+                const sf::RenderStates &states = sf::RenderStates::Default);
+
+        /**
+         * @brief Draws a vertex array
+         *
+         * @param vertices The vertex array
+         * @param states Texture, blending and transform to draw with
+         */
+        void draw(const sf::VertexArray &vertices, const sf::RenderStates &states = sf::RenderStates::Default);
+
+        /**
+         * @brief Draws a sprite, which is one quad
+         *
+         * @param sprite The sprite
+         * @param states Blending and transform to draw with
+         */
+        void draw(const sf::Sprite &sprite, const sf::RenderStates &states = sf::RenderStates::Default);
+
+        /**
+         * @brief Draws some text, which is two triangles per character and again for the outline
+         *
+         * @param text The text
+         * @param states Blending and transform to draw with
+         */
+        void draw(const sf::Text &text, const sf::RenderStates &states = sf::RenderStates::Default);
+
+        /**
+         * @brief Draws to another target from now on, keeping the counts so far
+         *
+         * @param target Where everything gets drawn, must outlive the counter
+         */
+        void setTarget(sf::RenderTarget &target);
+
+        /**
+         * @brief Getter for the target being drawn to, for setting its view and clearing it
+         *
+         * @return The target
+         */
+        sf::RenderTarget& getTarget();
+
+        /**
+         * @brief Getter for the counts since the last reset()
+         *
+         * @return The counts
+         */
+        const RenderCounts& getCounts() const;
+
+        /**
+         * @brief Sets every count back to 0, call at the start of each frame
+         */
+        void reset();
+
+    private:
+        sf::RenderTarget *_target;
+        RenderCounts _counts;
+
+        /** Texture (or font) of the last draw, nullptr for untextured */
+        const void *_lastTexture;
+
+        /**
+         * @brief Adds a draw call to the counts
+         *
+         * @param count Vertices drawn
+         * @param type What they make up
+         * @param texture What it's drawn with, a texture or a font
+         */
+        void count(std::size_t vertices, sf::PrimitiveType type, const void *texture);
+};
@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <cstdio>
+
+#include "RenderStatsOverlay.h"
+#include "AssetArchive.h"
+
+RenderStatsOverlay::RenderStatsOverlay() :
+    _frameCount(0),
+    _nextFrame(0),
+    _resolutionScale(1),
+    _sinceRefresh(0),
+    _visible(false)
+{
+    _counts.drawCalls = 0;
+    _counts.vertices = 0;
+    _counts.primitives = 0;
+    _counts.textureBinds = 0;
+    _counts.bytes = 0;
+    _particles.live = 0;
+    _particles.spawned = 0;
+    _particles.dropped = 0;
+
+    if(!loadAsset(_font, "fonts/Helvetica.ttf"))
+    {
+        printf("ERROR: font can not be loaded!!\n");
+    }
+    _text.setFont(_font);
+    _text.setCharacterSize(14);
+    _text.setFillColor(sf::Color::White);
+    _text.setPosition(8, 6);
+}
+
+void RenderStatsOverlay::toggle()
+{
+    _visible = !_visible;
+
+    // Show something straight away rather than after the next refresh
+    if(_visible)
+    {
+        refresh();
+    }
+}
+
+bool RenderStatsOverlay::isVisible() const
+{
+    return _visible;
+}
+
+void RenderStatsOverlay::addFrame(sf::Time frameTime, const RenderCounts &counts, const ParticleStats &particles,
+        float resolutionScale)
+{
+    _frameTimes[_nextFrame] = frameTime.asSeconds() * 1000;
+    _nextFrame = (_nextFrame + 1) % _historySize;
+    _frameCount = _frameCount < _historySize ? _frameCount + 1 : _historySize;
+    _counts = counts;
+    _particles = particles;
+    _resolutionScale = resolutionScale;
+
+    _sinceRefresh += frameTime.asSeconds();
+    if(_visible && _sinceRefresh >= _refreshPeriod)
+    {
+        refresh();
+    }
+}
+
+void RenderStatsOverlay::refresh()
+{
+    _sinceRefresh = 0;
+
+    // Percentiles of whatever's been recorded so far, from a sorted copy
+    float sorted[_historySize];
+    std::copy(_frameTimes, _frameTimes + _frameCount, sorted);
+    std::sort(sorted, sorted + _frameCount);
+    float p50 = 0, p95 = 0, p99 = 0, worst = 0;
+    if(_frameCount > 0)
+    {
+        p50 = sorted[(_frameCount - 1) * 50 / 100];
+        p95 = sorted[(_frameCount - 1) * 95 / 100];
+        p99 = sorted[(_frameCount - 1) * 99 / 100];
+        worst = sorted[_frameCount - 1];
+    }
+
+    char label[384];
+    snprintf(label, sizeof(label),
+            "frame ms   p50 %.2f   p95 %.2f   p99 %.2f   max %.2f\n"
+            "draw calls %d   texture binds %d\n"
+            "vertices %u   primitives %u   vertex data %.1f KB\n"
+            "particles %d   spawned %d   over budget %d\n"
+            "particle ms   update %.3f   build %.3f\n"
+            "world resolution %d%%",
+            p50, p95, p99, worst, _counts.drawCalls, _counts.textureBinds, (unsigned)_counts.vertices,
+            (unsigned)_counts.primitives, _counts.bytes / 1024.0, _particles.live, _particles.spawned,
+            _particles.dropped, _particles.updateTime.asSeconds() * 1000, _particles.buildTime.asSeconds() * 1000,
+            (int)(_resolutionScale * 100 + 0.5f));
+    _text.setString(label);
+}
+
+void RenderStatsOverlay::draw(RenderCounter &target)
+{
+    if(!_visible)
+    {
+        return;
+    }
+
+    // Drawn in window pixels rather than world coordinates, so it doesn't move with the camera
+    const sf::View view = target.getTarget().getView();
+    target.getTarget().setView(target.getTarget().getDefaultView());
+
+    const sf::FloatRect bounds = _text.getGlobalBounds();
+    const sf::Color backing(0, 0, 0, 160);
+    const float right = bounds.left + bounds.width + 8;
+    const float bottom = bounds.top + bounds.height + 8;
+    const sf::Vertex quad[4] = {
+        sf::Vertex(sf::Vector2<float>(0, 0), backing),
+        sf::Vertex(sf::Vector2<float>(right, 0), backing),
+        sf::Vertex(sf::Vector2<float>(right, bottom), backing),
+        sf::Vertex(sf::Vector2<float>(0, bottom), backing)
+    };
+    target.draw(quad, 4, sf::Quads);
+    target.draw(_text);
+
+    target.getTarget().setView(view);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include "RenderCounter.h"
+#include "ParticleSystem.h"
+
+/** Class which shows what the last frame drew, what its particles cost and how long recent
+ *  frames took.
+ *
+ * Every frame's time and RenderCounter counts are recorded whether or not it's showing,
+ * so the percentiles are ready as soon as it's turned on. The text is only rebuilt a few
+ * times a second, so showing it doesn't cost much of what it measures.
+ */
+class RenderStatsOverlay
+{
+    public:
+        RenderStatsOverlay();
+
+        /**
+         * @brief Shows the overlay if it's hidden, or hides it
+         */
+        void toggle();
+
+        /**
+         * @brief Getter for whether the overlay is showing
+         *
+         * @return true if it's showing
+         */
+        bool isVisible() const;
+
+        /**
+         * @brief Records a frame
+         *
+         * @param frameTime How long the frame took
+         * @param counts What the frame drew
+         * @param particles What updating and building the frame's particles cost
+         * @param resolutionScale How much of the window's resolution the world was drawn at
+         */
+        void addFrame(sf::Time frameTime, const RenderCounts &counts, const ParticleStats &particles,
+                float resolutionScale = 1);
+
+        /**
+         * @brief Draws the overlay in the top left corner of the screen, if it's showing
+         *
+         * @param target Where to draw to, its view is put back afterwards
+         */
+        void draw(RenderCounter &target);
+
+    private:
+        /** How many frames the percentiles cover */
+        static const int _historySize = 240;
+
+        /** Seconds between rebuilding the text */
+        static constexpr float _refreshPeriod = 0.25;
+
+        /** Recent frame times in milliseconds, a ring buffer */
+        float _frameTimes[_historySize];
+        int _frameCount;
+        int _nextFrame;
+
+        /** Counts, particle costs and world resolution of the last frame recorded */
+        RenderCounts _counts;
+        ParticleStats _particles;
+        float _resolutionScale;
+
+        float _sinceRefresh;
+        bool _visible;
+
+        sf::Font _font;
+        sf::Text _text;
+
+        /**
+         * @brief Rebuilds the text from the recorded frames
+         */
+        void refresh();
+};
@@ -0,0 +1,296 @@
+#include <algorithm>
+#include <cstdio>
+#include <exception>
+
+#include "ScriptScheduler.h"
+#include "WaveManager.h"
+
+static bool startedBefore(const WaveScript::Handle &a, const WaveScript::Handle &b)
+{
+    return a.promise().id < b.promise().id;
+}
+
+WaveScript WaveScript::promise_type::get_return_object()
+{
+    return WaveScript(Handle::from_promise(*this));
+}
+
+std::suspend_always WaveScript::promise_type::initial_suspend() noexcept
+{
+    return std::suspend_always();
+}
+
+std::suspend_always WaveScript::promise_type::final_suspend() noexcept
+{
+    return std::suspend_always();
+}
+
+void WaveScript::promise_type::return_void()
+{
+
+}
+
+void WaveScript::promise_type::unhandled_exception()
+{
+    printf("ERROR: wave script %d threw!!\n", script);
+    std::terminate();
+}
+
+WaveScript::WaveScript(Handle handle) :
+    _handle(handle)
+{
+
+}
+
+WaveScript::WaveScript(WaveScript &&other) :
+    _handle(other._handle)
+{
+    other._handle = Handle();
+}
+
+WaveScript::~WaveScript()
+{
+    if(_handle)
+    {
+        _handle.destroy();
+    }
+}
+
+WaveScript::Handle WaveScript::release()
+{
+    Handle handle = _handle;
+    _handle = Handle();
+    return handle;
+}
+
+bool Sleep::await_ready() const
+{
+    return false;
+}
+
+bool Sleep::await_suspend(WaveScript::Handle script)
+{
+    return script.promise().scheduler->sleep(script, seconds);
+}
+
+void Sleep::await_resume() const
+{
+
+}
+
+bool Until::await_ready() const
+{
+    return false;
+}
+
+bool Until::await_suspend(WaveScript::Handle script)
+{
+    return script.promise().scheduler->wait(script, signal);
+}
+
+void Until::await_resume() const
+{
+
+}
+
+ScriptScheduler::ScriptScheduler(WaveManager &waves, const ScriptFunction *library, int scripts) :
+    _waves(&waves),
+    _library(library),
+    _scripts(scripts),
+    _time(0),
+    _nextId(0)
+{
+
+}
+
+ScriptScheduler::~ScriptScheduler()
+{
+    clear();
+}
+
+void ScriptScheduler::start(int script, int arg)
+{
+    start(script, arg, _nextId++, 0, 0);
+}
+
+void ScriptScheduler::start(int script, int arg, std::uint32_t id, std::uint32_t steps, double wake)
+{
+    if(script < 0 || script >= _scripts)
+    {
+        printf("ERROR: there is no wave script %d!!\n", script);
+        return;
+    }
+
+    WaveScript::Handle handle = _library[script](*_waves, arg).release();
+    WaveScript::promise_type &promise = handle.promise();
+    promise.scheduler = this;
+    promise.script = script;
+    promise.arg = arg;
+    promise.id = id;
+    promise.steps = 0;
+
+    // A restored script runs through every co_await before the one it was suspended at
+    promise.skip = steps > 0 ? steps - 1 : 0;
+    promise.restored = steps > 0;
+    promise.wake = wake;
+
+    _running.push_back(handle);
+    resume(handle);
+}
+
+void ScriptScheduler::update(float deltaTime)
+{
+    _time += deltaTime;
+
+    // Take every script that's due off first, so one that sleeps again waits for the next update
+    while(!_timers.empty() && _timers.front().wake <= _time)
+    {
+        std::pop_heap(_timers.begin(), _timers.end(), wakesLater);
+        _resuming.push_back(_timers.back().script);
+        _timers.pop_back();
+    }
+    for(std::size_t i = 0; i < _resuming.size(); i++)
+    {
+        resume(_resuming[i]);
+    }
+    _resuming.clear();
+}
+
+void ScriptScheduler::signal(ScriptSignal signal)
+{
+    if(_waiting[signal].empty() || !_waves->holds(signal))
+    {
+        return;
+    }
+
+    _resuming.swap(_waiting[signal]);
+    for(std::size_t i = 0; i < _resuming.size(); i++)
+    {
+        resume(_resuming[i]);
+    }
+    _resuming.clear();
+}
+
+void ScriptScheduler::clear()
+{
+    for(std::size_t i = 0; i < _running.size(); i++)
+    {
+        _running[i].destroy();
+    }
+    _running.clear();
+    _timers.clear();
+    for(int i = 0; i < ScriptSignalCount; i++)
+    {
+        _waiting[i].clear();
+    }
+}
+
+bool ScriptScheduler::wakesLater(const Timer &a, const Timer &b)
+{
+    return a.wake > b.wake || (a.wake == b.wake && a.id > b.id);
+}
+
+int ScriptScheduler::getRunning() const
+{
+    return (int)_running.size();
+}
+
+void ScriptScheduler::resume(WaveScript::Handle script)
+{
+    script.resume();
+    if(script.done())
+    {
+        _running.erase(std::find(_running.begin(), _running.end(), script));
+        script.destroy();
+    }
+}
+
+bool ScriptScheduler::skip(WaveScript::Handle script)
+{
+    WaveScript::promise_type &promise = script.promise();
+    promise.steps++;
+    if(promise.skip > 0)
+    {
+        promise.skip--;
+        return true;
+    }
+    return false;
+}
+
+bool ScriptScheduler::sleep(WaveScript::Handle script, float seconds)
+{
+    if(skip(script))
+    {
+        return false;
+    }
+
+    WaveScript::promise_type &promise = script.promise();
+    promise.wake = promise.restored ? promise.wake : _time + seconds;
+    promise.restored = false;
+
+    const Timer timer = {promise.wake, promise.id, script};
+    _timers.push_back(timer);
+    std::push_heap(_timers.begin(), _timers.end(), wakesLater);
+    return true;
+}
+
+bool ScriptScheduler::wait(WaveScript::Handle script, ScriptSignal signal)
+{
+    if(skip(script))
+    {
+        return false;
+    }
+
+    // A restored script was waiting when the snapshot was taken, so it goes on waiting until
+    // the signal is next checked, the same as it would have
+    WaveScript::promise_type &promise = script.promise();
+    if(!promise.restored && _waves->holds(signal))
+    {
+        return false;
+    }
+    promise.restored = false;
+
+    std::vector<WaveScript::Handle> &waiting = _waiting[signal];
+    waiting.insert(std::upper_bound(waiting.begin(), waiting.end(), script, startedBefore), script);
+    return true;
+}
+
+void ScriptScheduler::saveTo(Snapshot &snapshot) const
+{
+    snapshot.write(_time);
+    snapshot.write(_nextId);
+    snapshot.write((std::uint32_t)_running.size());
+    for(std::size_t i = 0; i < _running.size(); i++)
+    {
+        const WaveScript::promise_type &promise = _running[i].promise();
+        snapshot.write((std::int32_t)promise.script);
+        snapshot.write((std::int32_t)promise.arg);
+        snapshot.write(promise.id);
+        snapshot.write(promise.steps);
+        snapshot.write(promise.wake);
+    }
+}
+
+bool ScriptScheduler::loadFrom(Snapshot &snapshot)
+{
+    clear();
+
+    std::uint32_t count;
+    if(!snapshot.read(_time) || !snapshot.read(_nextId) || !snapshot.read(count))
+    {
+        return false;
+    }
+    for(std::uint32_t i = 0; i < count; i++)
+    {
+        std::int32_t script, arg;
+        std::uint32_t id, steps;
+        double wake;
+        if(!snapshot.read(script) || !snapshot.read(arg) || !snapshot.read(id)
+                || !snapshot.read(steps) || !snapshot.read(wake))
+        {
+            return false;
+        }
+        start(script, arg, id, steps, wake);
+    }
+    return true;
+}
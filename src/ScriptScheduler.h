@@ -0,0 +1,243 @@
+#pragma once
+
+#include <coroutine>
+#include <cstdint>
+#include <vector>
+
+#include "Snapshot.h"
+
+class WaveManager;
+class ScriptScheduler;
+
+/** Something that happens in a wave, which scripts can wait for. */
+enum ScriptSignal
+{
+    /** Every enemy released so far has come in */
+    SpawnsInSignal,
+    /** Every enemy released so far has come in and is dead */
+    ClearedSignal,
+    ScriptSignalCount
+};
+
+/** A running wave script, what every script coroutine returns.
+ *
+ * A script is a coroutine that suspends with co_await Sleep or co_await Until, and is handed
+ * straight to a ScriptScheduler which owns it from then on. It starts suspended, the scheduler
+ * runs it up to its first co_await.
+ */
+class WaveScript
+{
+    public:
+        struct promise_type
+        {
+            ScriptScheduler *scheduler;
+
+            /** Which script of the library this is and what it was started with */
+            int script;
+            int arg;
+
+            /** Order scripts were started in, ties between them are broken by it */
+            std::uint32_t id;
+
+            /** co_awaits reached so far, and how many of them to run straight through */
+            std::uint32_t steps;
+            std::uint32_t skip;
+
+            /** When its timer runs out, and whether that's been restored from a snapshot */
+            double wake;
+            bool restored;
+
+            WaveScript get_return_object();
+            std::suspend_always initial_suspend() noexcept;
+            std::suspend_always final_suspend() noexcept;
+            void return_void();
+            void unhandled_exception();
+        };
+
+        typedef std::coroutine_handle<promise_type> Handle;
+
+        WaveScript(WaveScript &&other);
+        ~WaveScript();
+
+        /**
+         * @brief Gives up ownership of the coroutine
+         *
+         * @return The coroutine, whoever takes it has to destroy it
+         */
+        Handle release();
+
+    private:
+        Handle _handle;
+
+        explicit WaveScript(Handle handle);
+};
+
+/** A function a script coroutine is started from. */
+typedef WaveScript (*ScriptFunction)(WaveManager &waves, int arg);
+
+/** co_await Sleep(seconds) suspends a script for that long in game time. */
+struct Sleep
+{
+    float seconds;
+
+    bool await_ready() const;
+    bool await_suspend(WaveScript::Handle script);
+    void await_resume() const;
+};
+
+/** co_await Until(signal) suspends a script until the signal holds, straight through if it already does. */
+struct Until
+{
+    ScriptSignal signal;
+
+    bool await_ready() const;
+    bool await_suspend(WaveScript::Handle script);
+    void await_resume() const;
+};
+
+/** Class which runs wave scripts, resuming each only when what it waits for comes about.
+ *
+ * Sleeping scripts sit in a heap ordered by when they wake, scripts waiting for a signal sit
+ * in a list per signal. update() only looks at the top of the heap and signal() only at its
+ * own list, so a suspended script costs nothing per tick, however many there are.
+ *
+ * Coroutines can't be written into a snapshot, so scripts are instead restarted when one is
+ * loaded: every co_await the script had already got past runs straight through, and the one
+ * it was suspended at carries on with the time it had left. This holds as long as what a
+ * script does between co_awaits can be done twice, which is why WaveManager::release() takes
+ * a total rather than a number to add, and why scripts never start other scripts.
+ */
+class ScriptScheduler
+{
+    public:
+        /**
+         * @brief Constructs a scheduler for the scripts of a library
+         *
+         * @param waves The wave manager scripts are started with, and that signals are checked on
+         * @param library Every script that can be started, by index
+         * @param scripts Number of scripts in the library
+         */
+        ScriptScheduler(WaveManager &waves, const ScriptFunction *library, int scripts);
+        ~ScriptScheduler();
+
+        /**
+         * @brief Starts a script and runs it up to its first co_await
+         *
+         * @param script Index of the script in the library
+         * @param arg What to start it with
+         */
+        void start(int script, int arg);
+
+        /**
+         * @brief Moves game time on and resumes every script whose sleep has run out, in the
+         *  order they wake
+         *
+         * @param deltaTime Time since the last update (in seconds)
+         */
+        void update(float deltaTime);
+
+        /**
+         * @brief Resumes the scripts waiting for a signal, if it holds
+         *  Cheap enough to call every tick, it's only checked if some script is waiting
+         *
+         * @param signal The signal that may have come about
+         */
+        void signal(ScriptSignal signal);
+
+        /**
+         * @brief Destroys every script without finishing it
+         */
+        void clear();
+
+        /**
+         * @brief Getter for the number of scripts that haven't finished
+         *
+         * @return Number of scripts
+         */
+        int getRunning() const;
+
+        /**
+         * @brief Writes the game time and how far along every script is into a snapshot
+         *
+         * @param snapshot Where to write to
+         */
+        void saveTo(Snapshot &snapshot) const;
+
+        /**
+         * @brief Replaces every script with the ones in a snapshot, each restarted and run up
+         *  to where it had got to
+         *
+         * @param snapshot Where to read from
+         *
+         * @return false if the snapshot is cut short
+         */
+        bool loadFrom(Snapshot &snapshot);
+
+        /**
+         * @brief Called by Sleep, puts a script to sleep
+         *
+         * @return false if the script goes straight on
+         */
+        bool sleep(WaveScript::Handle script, float seconds);
+
+        /**
+         * @brief Called by Until, has a script wait for a signal
+         *
+         * @return false if the script goes straight on
+         */
+        bool wait(WaveScript::Handle script, ScriptSignal signal);
+
+    private:
+        /** A sleeping script */
+        struct Timer
+        {
+            double wake;
+            std::uint32_t id;
+            WaveScript::Handle script;
+        };
+
+        /**
+         * @brief Orders the timer heap, soonest on top and scripts started first going first
+         *  when they wake together
+         */
+        static bool wakesLater(const Timer &a, const Timer &b);
+
+        WaveManager *_waves;
+        const ScriptFunction *_library;
+        int _scripts;
+
+        /** Game time since the scheduler was made, in seconds */
+        double _time;
+        std::uint32_t _nextId;
+
+        /** Every script that hasn't finished, in the order they were started */
+        std::vector<WaveScript::Handle> _running;
+
+        /** Heap of sleeping scripts, soonest first */
+        std::vector<Timer> _timers;
+
+        /** Scripts waiting for each signal in the order they were started, and the ones being resumed */
+        std::vector<WaveScript::Handle> _waiting[ScriptSignalCount];
+        std::vector<WaveScript::Handle> _resuming;
+
+        /**
+         * @brief Starts a script, possibly one being restored from a snapshot
+         */
+        void start(int script, int arg, std::uint32_t id, std::uint32_t steps, double wake);
+
+        /**
+         * @brief Resumes a script, destroying it if that finished it
+         */
+        void resume(WaveScript::Handle script);
+
+        /**
+         * @brief Counts a co_await reached by a script
+         *
+         * @return true if the script is being restored and already got past this one
+         */
+        bool skip(WaveScript::Handle script);
+
+        /** Scripts are owned by one scheduler, they can't be shared between copies */
+        ScriptScheduler(const ScriptScheduler &) = delete;
+        ScriptScheduler& operator=(const ScriptScheduler &) = delete;
+};
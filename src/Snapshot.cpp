@@ -0,0 +1,105 @@
+#include <cstdio>
+
+#include "Snapshot.h"
+
+const std::uint32_t Snapshot::magic;
+const std::uint32_t Snapshot::version;
+
+Snapshot::Snapshot()
+{
+    _readPos = 0;
+}
+
+void Snapshot::beginWrite()
+{
+    // clear() keeps the capacity, so this only allocates the first time round
+    _data.clear();
+    _readPos = 0;
+    write(magic);
+    write(version);
+}
+
+bool Snapshot::beginRead()
+{
+    _readPos = 0;
+
+    std::uint32_t fileMagic;
+    std::uint32_t fileVersion;
+    if(!read(fileMagic) || !read(fileVersion))
+    {
+        return false;
+    }
+    return fileMagic == magic && fileVersion == version;
+}
+
+void Snapshot::write(const void *data, std::size_t size)
+{
+    const std::size_t start = _data.size();
+    _data.resize(start + size);
+    std::memcpy(&_data[start], data, size);
+}
+
+bool Snapshot::read(void *data, std::size_t size)
+{
+    if(size > _data.size() - _readPos)
+    {
+        return false;
+    }
+    std::memcpy(data, &_data[_readPos], size);
+    _readPos += size;
+    return true;
+}
+
+bool Snapshot::saveToFile(const std::string &path) const
+{
+    FILE *file = fopen(path.c_str(), "wb");
+    if(file == nullptr)
+    {
+        printf("ERROR: checkpoint %s can not be written!!\n", path.c_str());
+        return false;
+    }
+
+    const bool written = fwrite(_data.data(), 1, _data.size(), file) == _data.size();
+    fclose(file);
+    return written;
+}
+
+bool Snapshot::loadFromFile(const std::string &path)
+{
+    FILE *file = fopen(path.c_str(), "rb");
+    if(file == nullptr)
+    {
+        printf("ERROR: checkpoint %s can not be read!!\n", path.c_str());
+        return false;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    _data.resize(size < 0 ? 0 : size);
+    _readPos = 0;
+    const bool read = fread(_data.data(), 1, _data.size(), file) == _data.size();
+    fclose(file);
+    return read;
+}
+
+const std::vector<unsigned char>& Snapshot::getData() const
+{
+    return _data;
+}
+
+void Snapshot::setData(const void *data, std::size_t size)
+{
+    _data.resize(size);
+    if(size > 0)
+    {
+        std::memcpy(_data.data(), data, size);
+    }
+    _readPos = 0;
+}
+
+std::size_t Snapshot::size() const
+{
+    return _data.size();
+}
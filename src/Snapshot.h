@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/** A versioned binary copy of the game state.
+ *
+ * Everything is written as raw bytes: single plain-data values, and whole arrays of them
+ * (component columns, id lists) with one memcpy each. Restoring reads them back the same
+ * way, so neither direction does any work per entity. The buffer is kept between uses,
+ * so after the first capture a snapshot doesn't allocate.
+ *
+ * A snapshot starts with a header holding magic and version. Bump version whenever the
+ * layout of anything written changes, old snapshots are then rejected instead of misread.
+ */
+class Snapshot
+{
+    public:
+        Snapshot();
+
+        /** "HSSN" in little endian */
+        static const std::uint32_t magic = 0x4E535348;
+
+        /** Version of the snapshot layout */
+        static const std::uint32_t version = 4;
+
+        /**
+         * @brief Empties the snapshot and writes the header
+         */
+        void beginWrite();
+
+        /**
+         * @brief Goes back to the start and checks the header
+         *
+         * @return false if this isn't a snapshot, or is one from another version
+         */
+        bool beginRead();
+
+        /**
+         * @brief Appends raw bytes
+         *
+         * @param data Where to copy from
+         * @param size Number of bytes
+         */
+        void write(const void *data, std::size_t size);
+
+        /**
+         * @brief Appends a plain-data value
+         *
+         * @param value The value to write
+         */
+        template<typename T>
+        void write(const T &value)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Only plain data can be written");
+            write(&value, sizeof(T));
+        }
+
+        /**
+         * @brief Appends an array of plain data, prefixed with its length
+         *
+         * @param values The array to write
+         */
+        template<typename T>
+        void writeVector(const std::vector<T> &values)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Only plain data can be written");
+            write((std::uint32_t)values.size());
+            if(!values.empty())
+            {
+                write(values.data(), values.size() * sizeof(T));
+            }
+        }
+
+        /**
+         * @brief Reads raw bytes
+         *
+         * @param data Where to copy to
+         * @param size Number of bytes
+         *
+         * @return false if the snapshot ends first
+         */
+        bool read(void *data, std::size_t size);
+
+        /**
+         * @brief Reads a plain-data value
+         *
+         * @param value Where to put it
+         *
+         * @return false if the snapshot ends first
+         */
+        template<typename T>
+        bool read(T &value)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Only plain data can be read");
+            return read(&value, sizeof(T));
+        }
+
+        /**
+         * @brief Reads an array written with writeVector()
+         *
+         * @param values Where to put it, resized to fit
+         *
+         * @return false if the snapshot ends first
+         */
+        template<typename T>
+        bool readVector(std::vector<T> &values)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Only plain data can be read");
+            std::uint32_t count;
+            if(!read(count) || count * sizeof(T) > _data.size() - _readPos)
+            {
+                return false;
+            }
+            values.resize(count);
+            return count == 0 || read(values.data(), count * sizeof(T));
+        }
+
+        /**
+         * @brief Writes the snapshot to a file in a single write
+         *
+         * @param path Path of the checkpoint file
+         *
+         * @return false if the file can't be written
+         */
+        bool saveToFile(const std::string &path) const;
+
+        /**
+         * @brief Replaces the snapshot with the contents of a file, read in a single read
+         *
+         * @param path Path of the checkpoint file
+         *
+         * @return false if the file can't be read
+         */
+        bool loadFromFile(const std::string &path);
+
+        /**
+         * @brief Getter for the raw bytes
+         *
+         * @return Everything written so far
+         */
+        const std::vector<unsigned char>& getData() const;
+
+        /**
+         * @brief Replaces the snapshot with raw bytes
+         *
+         * @param data Where to copy from
+         * @param size Number of bytes
+         */
+        void setData(const void *data, std::size_t size);
+
+        /**
+         * @brief Getter for the size of the snapshot
+         *
+         * @return Number of bytes written
+         */
+        std::size_t size() const;
+
+    private:
+        std::vector<unsigned char> _data;
+        std::size_t _readPos;
+};
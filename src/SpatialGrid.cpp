@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <cmath>
+
+#include "SpatialGrid.h"
+#include "Entity.h"
+#include "Enemy.h"
+
+SpatialGrid::SpatialGrid(sf::FloatRect bounds, float cellSize)
+{
+    _bounds = bounds;
+    _cellSize = cellSize;
+    _columns = std::max(1, (int)std::ceil(bounds.width / cellSize));
+    _rows = std::max(1, (int)std::ceil(bounds.height / cellSize));
+    _maxExtent = 0;
+    _cellStart.assign(_columns * _rows + 1, 0);
+}
+
+void SpatialGrid::build(EntityWorld &world, const TextureCache &textures)
+{
+    _scratchCells.clear();
+    _scratchIds.clear();
+    _scratchBoxes.clear();
+    _maxExtent = 0;
+
+    // Gather every living enemy along with the cell its position falls in
+    world.eachBatch<Transform, Health, SpriteRef, EnemyBrain>([&](std::size_t count, const EntityId *ids,
+            Transform *transform, Health *health, SpriteRef *sprite, EnemyBrain *brain)
+    {
+        for(std::size_t i = 0; i < count; i++)
+        {
+            if(!health[i].alive)
+            {
+                continue;
+            }
+
+            const SpriteDef &def = textures.getSprite(sprite[i].sprite);
+            const sf::Vector2<float> &position = transform[i].position;
+            const sf::FloatRect box(position.x - def.origin.x, position.y - def.origin.y,
+                    (float)def.rect.width, (float)def.rect.height);
+
+            _maxExtent = std::max(_maxExtent, std::max(box.width, box.height));
+            _scratchCells.push_back(cellOf(position));
+            _scratchIds.push_back(ids[i]);
+            _scratchBoxes.push_back(box);
+        }
+    });
+
+    // Counting sort: count each cell, turn the counts into start offsets, then scatter
+    std::fill(_cellStart.begin(), _cellStart.end(), 0);
+    for(std::size_t i = 0; i < _scratchCells.size(); i++)
+    {
+        _cellStart[_scratchCells[i] + 1]++;
+    }
+    for(std::size_t c = 1; c < _cellStart.size(); c++)
+    {
+        _cellStart[c] += _cellStart[c - 1];
+    }
+
+    _ids.resize(_scratchIds.size());
+    _boxes.resize(_scratchBoxes.size());
+    _cursor.assign(_cellStart.begin(), _cellStart.end() - 1);
+    for(std::size_t i = 0; i < _scratchCells.size(); i++)
+    {
+        const int slot = _cursor[_scratchCells[i]]++;
+        _ids[slot] = _scratchIds[i];
+        _boxes[slot] = _scratchBoxes[i];
+    }
+}
+
+int SpatialGrid::getCellCount(int col, int row) const
+{
+    const int cell = row * _columns + col;
+    return _cellStart[cell + 1] - _cellStart[cell];
+}
+
+int SpatialGrid::cellOf(const sf::Vector2<float> &position) const
+{
+    return rowOf(position.y) * _columns + columnOf(position.x);
+}
+
+int SpatialGrid::getColumns() const
+{
+    return _columns;
+}
+
+int SpatialGrid::getRows() const
+{
+    return _rows;
+}
+
+const sf::FloatRect& SpatialGrid::getBounds() const
+{
+    return _bounds;
+}
+
+int SpatialGrid::size() const
+{
+    return (int)_ids.size();
+}
+
+int SpatialGrid::columnOf(float x) const
+{
+    const int col = (int)std::floor((x - _bounds.left) / _cellSize);
+    return std::min(std::max(col, 0), _columns - 1);
+}
+
+int SpatialGrid::rowOf(float y) const
+{
+    const int row = (int)std::floor((y - _bounds.top) / _cellSize);
+    return std::min(std::max(row, 0), _rows - 1);
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <vector>
+#include <SFML/Graphics.hpp>
+
+#include "EntityWorld.h"
+#include "TextureCache.h"
+
+/** Uniform grid over the map that indexes every living enemy by position.
+ *
+ * The grid is rebuilt from scratch once per tick with a counting sort, so entries of one
+ * cell sit next to each other and a query only touches the cells it overlaps. Each entry
+ * keeps the enemy's box (its sprite rect placed at its position) for narrow phase tests.
+ */
+class SpatialGrid
+{
+    public:
+        /**
+         * @brief Creates an empty grid
+         *
+         * @param bounds The area covered, anything outside is put in the nearest edge cell
+         * @param cellSize Width and height of each cell
+         */
+        SpatialGrid(sf::FloatRect bounds, float cellSize);
+
+        /**
+         * @brief Rebuilds the grid from every living enemy in the world
+         *
+         * @param world The world the enemies live in
+         * @param textures Where the enemy sprite rects come from
+         */
+        void build(EntityWorld &world, const TextureCache &textures);
+
+        /**
+         * @brief Visits every enemy whose box could overlap an area
+         *
+         * @param area The area to search, in world coordinates
+         * @param fn Called as fn(id, box) for every enemy in the overlapped cells
+         */
+        template<typename F>
+        void query(const sf::FloatRect &area, F fn) const
+        {
+            // Boxes stick out of the cell their position is in by at most _maxExtent
+            const int minCol = columnOf(area.left - _maxExtent);
+            const int maxCol = columnOf(area.left + area.width + _maxExtent);
+            const int minRow = rowOf(area.top - _maxExtent);
+            const int maxRow = rowOf(area.top + area.height + _maxExtent);
+
+            for(int row = minRow; row <= maxRow; row++)
+            {
+                for(int col = minCol; col <= maxCol; col++)
+                {
+                    const int cell = row * _columns + col;
+                    for(int i = _cellStart[cell]; i < _cellStart[cell + 1]; i++)
+                    {
+                        fn(_ids[i], _boxes[i]);
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Getter for the number of enemies in a cell
+         *
+         * @param col Column of the cell
+         * @param row Row of the cell
+         *
+         * @return Number of enemies indexed in that cell
+         */
+        int getCellCount(int col, int row) const;
+
+        /**
+         * @brief Finds the cell a point falls in
+         *
+         * @param position A point in world coordinates, outside ones get the nearest edge cell
+         *
+         * @return The cell's index, row * getColumns() + column
+         */
+        int cellOf(const sf::Vector2<float> &position) const;
+
+        /**
+         * @brief Getter for the number of columns
+         *
+         * @return Number of columns
+         */
+        int getColumns() const;
+
+        /**
+         * @brief Getter for the number of rows
+         *
+         * @return Number of rows
+         */
+        int getRows() const;
+
+        /**
+         * @brief Getter for the area the grid covers
+         *
+         * @return The bounds given to the constructor
+         */
+        const sf::FloatRect& getBounds() const;
+
+        /**
+         * @brief Getter for the number of indexed enemies
+         *
+         * @return Number of enemies found by the last build()
+         */
+        int size() const;
+
+    private:
+        sf::FloatRect _bounds;
+        float _cellSize;
+        int _columns;
+        int _rows;
+
+        /** How far past its cell the biggest box reaches */
+        float _maxExtent;
+
+        /** Entries of cell c are [_cellStart[c], _cellStart[c + 1]) */
+        std::vector<int> _cellStart;
+        std::vector<EntityId> _ids;
+        std::vector<sf::FloatRect> _boxes;
+
+        /** Unsorted entries gathered at the start of build() */
+        std::vector<int> _scratchCells;
+        std::vector<EntityId> _scratchIds;
+        std::vector<sf::FloatRect> _scratchBoxes;
+
+        /** Next free slot of each cell while scattering */
+        std::vector<int> _cursor;
+
+        int columnOf(float x) const;
+        int rowOf(float y) const;
+};
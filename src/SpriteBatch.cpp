@@ -0,0 +1,155 @@
+#include <algorithm>
+
+#include "SpriteBatch.h"
+
+SpriteBatch::SpriteBatch() :
+    _reused(false)
+{
+
+}
+
+void SpriteBatch::build(EntityWorld &world, const TextureCache &textures)
+{
+    // Keep the arrays around between frames so their storage gets reused
+    _items.clear();
+    _ids.clear();
+    _depths.clear();
+
+    world.eachBatch<Transform, Health, SpriteRef>([this, &textures](std::size_t count, const EntityId *ids,
+            Transform *transform, Health *health, SpriteRef *sprite)
+    {
+        for(std::size_t i = 0; i < count; i++)
+        {
+            if(!health[i].alive)
+            {
+                continue;
+            }
+
+            // Sprites are ordered by where their feet are, the bottom edge of the sprite
+            const SpriteDef &def = textures.getSprite(sprite[i].sprite);
+            const Item item = {transform[i].position - def.origin, sprite[i].sprite};
+            _items.push_back(item);
+            _ids.push_back(ids[i]);
+            _depths.push_back(item.topLeft.y + def.rect.height);
+        }
+    });
+
+    // Spread the depths of this frame over the whole key range
+    const std::size_t count = _items.size();
+    float nearest = 0, furthest = 0;
+    if(count > 0)
+    {
+        nearest = *std::min_element(_depths.begin(), _depths.end());
+        furthest = *std::max_element(_depths.begin(), _depths.end());
+    }
+    const float scale = furthest > nearest ? 65535 / (furthest - nearest) : 0;
+    _keys.resize(count);
+    for(std::size_t i = 0; i < count; i++)
+    {
+        _keys[i] = (std::uint16_t)((_depths[i] - nearest) * scale);
+    }
+
+    // The same entities gathered in the same order means last frame's order is nearly right
+    _reused = _ids == _lastIds && _order.size() == count && patchOrder();
+    if(!_reused)
+    {
+        radixSort();
+    }
+    _lastIds.swap(_ids);
+
+    // Write the quads back to front, starting a new run whenever the texture changes
+    _quads.clear();
+    _runs.clear();
+    for(std::size_t i = 0; i < count; i++)
+    {
+        const Item &item = _items[_order[i]];
+        const SpriteDef &def = textures.getSprite(item.sprite);
+        if(_runs.empty() || _runs.back().texture != def.texture)
+        {
+            const Run run = {def.texture, _quads.size(), 0};
+            _runs.push_back(run);
+        }
+
+        const sf::IntRect &rect = def.rect;
+        const sf::Vector2<float> &topLeft = item.topLeft;
+        const float width = (float)rect.width;
+        const float height = (float)rect.height;
+        const float u = (float)rect.left;
+        const float v = (float)rect.top;
+
+        _quads.push_back(sf::Vertex(topLeft, sf::Vector2<float>(u, v)));
+        _quads.push_back(sf::Vertex(topLeft + sf::Vector2<float>(width, 0), sf::Vector2<float>(u + width, v)));
+        _quads.push_back(sf::Vertex(topLeft + sf::Vector2<float>(width, height), sf::Vector2<float>(u + width, v + height)));
+        _quads.push_back(sf::Vertex(topLeft + sf::Vector2<float>(0, height), sf::Vector2<float>(u, v + height)));
+        _runs.back().count += 4;
+    }
+}
+
+void SpriteBatch::radixSort()
+{
+    const std::size_t count = _keys.size();
+    _order.resize(count);
+    _scratch.resize(count);
+    for(std::size_t i = 0; i < count; i++)
+    {
+        _order[i] = (std::uint32_t)i;
+    }
+
+    // Low byte then high byte, each pass is a stable counting sort so ties keep gather order
+    for(int shift = 0; shift < 16; shift += 8)
+    {
+        std::size_t offsets[257] = {0};
+        for(std::size_t i = 0; i < count; i++)
+        {
+            offsets[((_keys[_order[i]] >> shift) & 0xFF) + 1]++;
+        }
+        for(int bucket = 1; bucket < 257; bucket++)
+        {
+            offsets[bucket] += offsets[bucket - 1];
+        }
+        for(std::size_t i = 0; i < count; i++)
+        {
+            _scratch[offsets[(_keys[_order[i]] >> shift) & 0xFF]++] = _order[i];
+        }
+        _order.swap(_scratch);
+    }
+}
+
+bool SpriteBatch::patchOrder()
+{
+    // The radix sort goes over everything about four times, past that it's the cheaper one
+    const std::size_t limit = _order.size() * 4;
+    std::size_t moves = 0;
+    for(std::size_t i = 1; i < _order.size(); i++)
+    {
+        const std::uint32_t item = _order[i];
+        const std::uint16_t key = _keys[item];
+        std::size_t j = i;
+        while(j > 0 && _keys[_order[j - 1]] > key)
+        {
+            _order[j] = _order[j - 1];
+            j--;
+            if(++moves > limit)
+            {
+                _order[j] = item;
+                return false;
+            }
+        }
+        _order[j] = item;
+    }
+    return true;
+}
+
+void SpriteBatch::draw(RenderCounter &target, const TextureCache &textures)
+{
+    for(std::size_t i = 0; i < _runs.size(); i++)
+    {
+        const Run &run = _runs[i];
+        target.draw(&_quads[run.first], run.count, sf::Quads, &textures.get(run.texture));
+    }
+}
+
+bool SpriteBatch::reusedOrder() const
+{
+    return _reused;
+}
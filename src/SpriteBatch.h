@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <SFML/Graphics.hpp>
+
+#include "Entity.h"
+#include "TextureCache.h"
+#include "RenderCounter.h"
+
+/** Class which draws every entity sprite back to front in as few draw calls as possible.
+ *
+ * Each frame build() walks the SpriteRef components of the world once, and orders every
+ * living entity by the bottom edge of its sprite, so whoever stands further down the screen
+ * is drawn over whoever is behind them. The sort is a stable radix sort on 16 bit keys.
+ * When the same entities are drawn as last frame, last frame's order is patched up with an
+ * insertion sort instead, which costs next to nothing while little has moved.
+ *
+ * The quads all go into one array in that order, and draw() issues one draw call per run
+ * of quads that share a texture. Every sprite sharing one texture is a single draw call.
+ */
+class SpriteBatch
+{
+    public:
+        SpriteBatch();
+
+        /**
+         * @brief Rebuilds the draw list from the current state of the world
+         *
+         * @param world The world to draw the entities of
+         * @param textures The textures the SpriteRefs point into
+         */
+        void build(EntityWorld &world, const TextureCache &textures);
+
+        /**
+         * @brief Draws everything gathered by the last build()
+         *
+         * @param target Where to draw to
+         * @param textures The textures the SpriteRefs point into
+         */
+        void draw(RenderCounter &target, const TextureCache &textures);
+
+        /**
+         * @brief Getter for whether the last build() kept the order of the frame before
+         *
+         * @return false if it had to radix sort
+         */
+        bool reusedOrder() const;
+
+    private:
+        /** A sprite to draw, gathered from the world */
+        struct Item
+        {
+            sf::Vector2<float> topLeft;
+            std::uint16_t sprite;
+        };
+
+        /** Quads of a texture from _quads[first] on */
+        struct Run
+        {
+            int texture;
+            std::size_t first;
+            std::size_t count;
+        };
+
+        /** What to draw this frame, the entity of each, and each one's depth */
+        std::vector<Item> _items;
+        std::vector<EntityId> _ids;
+        std::vector<float> _depths;
+
+        /** The entities drawn last frame, in the order they were gathered */
+        std::vector<EntityId> _lastIds;
+
+        /** Indices into _items back to front, and spare room for sorting them */
+        std::vector<std::uint16_t> _keys;
+        std::vector<std::uint32_t> _order;
+        std::vector<std::uint32_t> _scratch;
+
+        std::vector<sf::Vertex> _quads;
+        std::vector<Run> _runs;
+        bool _reused;
+
+        /**
+         * @brief Orders _order by _keys from scratch
+         */
+        void radixSort();
+
+        /**
+         * @brief Fixes up last frame's _order by insertion sort, unless that turns out to be
+         *  more work than a radix sort
+         *
+         * @return false if it gave up, _order is then half sorted
+         */
+        bool patchOrder();
+};
@@ -0,0 +1,298 @@
+#include <cstdio>
+#include <cstring>
+
+#include "StateHistory.h"
+
+const std::uint32_t StateHistory::magic;
+const std::uint32_t StateHistory::version;
+
+// Matching runs shorter than this are cheaper to keep as changed bytes than to skip,
+// since skipping one means starting a new run header
+static const std::size_t minSkip = 4;
+
+// Both lengths in a run header are 16 bit
+static const std::size_t maxRun = 0xFFFF;
+
+// A delta is a list of runs: a 16 bit count of bytes that match the keyframe, a 16 bit
+// count of bytes that don't, then those bytes. Returns 0 if the delta wouldn't be any
+// smaller than the tick itself, in which case it's better off as a keyframe.
+static std::size_t encodeDelta(const unsigned char *keyframe, const unsigned char *tick,
+        std::size_t size, unsigned char *out)
+{
+    std::size_t written = 0;
+    std::size_t i = 0;
+    while(i < size)
+    {
+        const std::size_t skipStart = i;
+        while(i < size && i - skipStart < maxRun && keyframe[i] == tick[i])
+        {
+            i++;
+        }
+        const std::size_t skip = i - skipStart;
+
+        const std::size_t copyStart = i;
+        while(i < size && i - copyStart < maxRun - minSkip)
+        {
+            if(keyframe[i] != tick[i])
+            {
+                i++;
+                continue;
+            }
+
+            // Only stop copying for a run of matches long enough to be worth skipping
+            std::size_t same = 0;
+            while(i + same < size && same < minSkip && keyframe[i + same] == tick[i + same])
+            {
+                same++;
+            }
+            if(same == minSkip || i + same == size)
+            {
+                break;
+            }
+            i += same;
+        }
+        const std::size_t copy = i - copyStart;
+
+        if(written + 4 + copy >= size)
+        {
+            return 0;
+        }
+
+        const std::uint16_t header[2] = {(std::uint16_t)skip, (std::uint16_t)copy};
+        std::memcpy(out + written, header, sizeof(header));
+        std::memcpy(out + written + sizeof(header), tick + copyStart, copy);
+        written += sizeof(header) + copy;
+    }
+    return written;
+}
+
+// Patches a copy of the keyframe into the tick a delta was made from
+static void applyDelta(const unsigned char *delta, std::size_t deltaSize, unsigned char *tick)
+{
+    std::size_t read = 0;
+    std::size_t pos = 0;
+    while(read < deltaSize)
+    {
+        std::uint16_t header[2];
+        std::memcpy(header, delta + read, sizeof(header));
+        read += sizeof(header);
+        pos += header[0];
+        std::memcpy(tick + pos, delta + read, header[1]);
+        pos += header[1];
+        read += header[1];
+    }
+}
+
+StateHistory::StateHistory(std::size_t byteCapacity, int maxFrames, int keyframeInterval) :
+    _buffer(byteCapacity),
+    _frames(maxFrames),
+    _firstFrame(0),
+    _frameCount(0),
+    _writePos(0),
+    _bytesUsed(0),
+    _keyframeInterval(keyframeInterval)
+{
+}
+
+void StateHistory::record(const Snapshot &snapshot)
+{
+    const std::vector<unsigned char> &tick = snapshot.getData();
+    const std::size_t size = tick.size();
+
+    // Start a new keyframe every interval, and whenever the state changes size (like when a
+    // wave spawns), since a delta can only describe bytes that were already there
+    bool keyframe = _frameCount == 0 || size != _keyframe.size()
+        || (int)frameAt(_frameCount - 1).keyframeDistance + 1 >= _keyframeInterval;
+
+    std::size_t deltaSize = 0;
+    if(!keyframe)
+    {
+        // resize() only allocates when the state has grown past anything seen before
+        _delta.resize(size);
+        deltaSize = encodeDelta(_keyframe.data(), tick.data(), size, _delta.data());
+        keyframe = deltaSize == 0;
+    }
+
+    if(_frameCount == (int)_frames.size())
+    {
+        dropOldestKeyframe();
+    }
+    if(!reserve(keyframe ? size : deltaSize))
+    {
+        printf("ERROR: a %zu byte tick doesn't fit in the history!!\n", size);
+        return;
+    }
+
+    // Making room can drop the keyframe this delta was made against, then it has to be one
+    if(!keyframe && _frameCount == 0)
+    {
+        keyframe = true;
+        reserve(size);
+    }
+
+    HistoryFrame frame;
+    frame.offset = (std::uint32_t)_writePos;
+    frame.snapshotSize = (std::uint32_t)size;
+    if(keyframe)
+    {
+        frame.size = (std::uint32_t)size;
+        frame.keyframeDistance = 0;
+        std::memcpy(&_buffer[_writePos], tick.data(), size);
+        _keyframe.assign(tick.begin(), tick.end());
+    }
+    else
+    {
+        frame.size = (std::uint32_t)deltaSize;
+        frame.keyframeDistance = frameAt(_frameCount - 1).keyframeDistance + 1;
+        std::memcpy(&_buffer[_writePos], _delta.data(), deltaSize);
+    }
+
+    _frames[(_firstFrame + _frameCount) % _frames.size()] = frame;
+    _frameCount++;
+    _writePos += frame.size;
+    _bytesUsed += frame.size;
+}
+
+bool StateHistory::getFrame(int frame, Snapshot &snapshot)
+{
+    if(frame < 0 || frame >= _frameCount)
+    {
+        return false;
+    }
+
+    const HistoryFrame &entry = frameAt(frame);
+    const HistoryFrame &key = frameAt(frame - entry.keyframeDistance);
+    if(entry.keyframeDistance == 0)
+    {
+        snapshot.setData(&_buffer[entry.offset], entry.size);
+        return true;
+    }
+
+    _delta.resize(entry.snapshotSize);
+    std::memcpy(_delta.data(), &_buffer[key.offset], key.size);
+    applyDelta(&_buffer[entry.offset], entry.size, _delta.data());
+    snapshot.setData(_delta.data(), _delta.size());
+    return true;
+}
+
+void StateHistory::truncate(int frameCount)
+{
+    if(frameCount >= _frameCount)
+    {
+        return;
+    }
+    if(frameCount <= 0)
+    {
+        clear();
+        return;
+    }
+
+    while(_frameCount > frameCount)
+    {
+        _frameCount--;
+        _bytesUsed -= frameAt(_frameCount).size;
+    }
+
+    // Carry on writing right after the newest tick kept, against its keyframe
+    const HistoryFrame &last = frameAt(_frameCount - 1);
+    const HistoryFrame &key = frameAt(_frameCount - 1 - last.keyframeDistance);
+    _writePos = last.offset + last.size;
+    _keyframe.assign(_buffer.begin() + key.offset, _buffer.begin() + key.offset + key.size);
+}
+
+void StateHistory::clear()
+{
+    _firstFrame = 0;
+    _frameCount = 0;
+    _writePos = 0;
+    _bytesUsed = 0;
+    _keyframe.clear();
+}
+
+bool StateHistory::dumpToFile(const std::string &path) const
+{
+    FILE *file = fopen(path.c_str(), "wb");
+    if(file == nullptr)
+    {
+        printf("ERROR: history %s can not be written!!\n", path.c_str());
+        return false;
+    }
+
+    // Header, then every tick oldest first as its entry followed by its bytes
+    const std::uint32_t header[4] = {magic, version, (std::uint32_t)_frameCount,
+        (std::uint32_t)_keyframeInterval};
+    bool written = fwrite(header, sizeof(header), 1, file) == 1;
+    for(int i = 0; i < _frameCount && written; i++)
+    {
+        const HistoryFrame &frame = frameAt(i);
+        const std::uint32_t entry[3] = {frame.size, frame.snapshotSize, frame.keyframeDistance};
+        written = fwrite(entry, sizeof(entry), 1, file) == 1
+            && fwrite(&_buffer[frame.offset], 1, frame.size, file) == frame.size;
+    }
+
+    fclose(file);
+    return written;
+}
+
+int StateHistory::size() const
+{
+    return _frameCount;
+}
+
+std::size_t StateHistory::getBytesUsed() const
+{
+    return _bytesUsed;
+}
+
+std::size_t StateHistory::getCapacity() const
+{
+    return _buffer.size();
+}
+
+StateHistory::HistoryFrame& StateHistory::frameAt(int frame)
+{
+    return _frames[(_firstFrame + frame) % _frames.size()];
+}
+
+const StateHistory::HistoryFrame& StateHistory::frameAt(int frame) const
+{
+    return _frames[(_firstFrame + frame) % _frames.size()];
+}
+
+bool StateHistory::reserve(std::size_t size)
+{
+    if(size > _buffer.size())
+    {
+        return false;
+    }
+
+    // Ticks are never split, one that doesn't fit before the end goes back to the start.
+    // Anything past the write position is older than what's at the start, so it goes first.
+    if(_writePos + size > _buffer.size())
+    {
+        while(_frameCount > 0 && frameAt(0).offset >= _writePos)
+        {
+            dropOldestKeyframe();
+        }
+        _writePos = 0;
+    }
+
+    // The oldest ticks are the ones right after the write position, drop them until there's room
+    while(_frameCount > 0 && frameAt(0).offset < _writePos + size
+            && frameAt(0).offset + frameAt(0).size > _writePos)
+    {
+        dropOldestKeyframe();
+    }
+    return true;
+}
+
+void StateHistory::dropOldestKeyframe()
+{
+    do
+    {
+        _bytesUsed -= frameAt(0).size;
+        _firstFrame = (_firstFrame + 1) % _frames.size();
+        _frameCount--;
+    }
+    while(_frameCount > 0 && frameAt(0).keyframeDistance != 0);
+}
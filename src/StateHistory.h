@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Snapshot.h"
+
+/** Rolling history of the game state, one Snapshot per tick.
+ *
+ * Every so often a tick is stored whole as a keyframe. The ticks in between are stored as
+ * deltas against their keyframe: runs of bytes that haven't changed since the keyframe are
+ * skipped, only the ones that did are kept. Because every delta only needs its keyframe,
+ * any tick can be rebuilt with one copy and one pass over its delta, which keeps scrubbing
+ * back and forth cheap.
+ *
+ * Everything lives in a fixed size ring buffer that is allocated once. When it fills up the
+ * oldest keyframe is dropped along with every delta against it, so the history always starts
+ * on a keyframe.
+ */
+class StateHistory
+{
+    public:
+        /**
+         * @brief Creates an empty history
+         *
+         * @param byteCapacity Size of the ring buffer in bytes
+         * @param maxFrames The most ticks kept at once
+         * @param keyframeInterval How many ticks a keyframe covers, itself included
+         */
+        StateHistory(std::size_t byteCapacity, int maxFrames, int keyframeInterval);
+
+        /** "HSHI" in little endian */
+        static const std::uint32_t magic = 0x49485348;
+
+        /** Version of the dump file layout */
+        static const std::uint32_t version = 1;
+
+        /**
+         * @brief Adds a tick to the end of the history, dropping the oldest ones if needed
+         *
+         * @param snapshot The state at the end of the tick
+         */
+        void record(const Snapshot &snapshot);
+
+        /**
+         * @brief Rebuilds the state of a tick
+         *
+         * @param frame Which tick, 0 is the oldest one kept
+         * @param snapshot Where to put the state
+         *
+         * @return false if frame is out of range
+         */
+        bool getFrame(int frame, Snapshot &snapshot);
+
+        /**
+         * @brief Forgets every tick after the first frameCount ones
+         *  Used when the game carries on from a tick that was rewound to
+         *
+         * @param frameCount How many ticks to keep
+         */
+        void truncate(int frameCount);
+
+        /**
+         * @brief Forgets every tick
+         */
+        void clear();
+
+        /**
+         * @brief Writes the whole history to a file, still compressed
+         *
+         * @param path Path of the dump file
+         *
+         * @return false if the file can't be written
+         */
+        bool dumpToFile(const std::string &path) const;
+
+        /**
+         * @brief Getter for the number of ticks kept
+         *
+         * @return Number of ticks
+         */
+        int size() const;
+
+        /**
+         * @brief Getter for the number of bytes the kept ticks take up
+         *
+         * @return Bytes in use in the ring buffer
+         */
+        std::size_t getBytesUsed() const;
+
+        /**
+         * @brief Getter for the size of the ring buffer
+         *
+         * @return Size in bytes
+         */
+        std::size_t getCapacity() const;
+
+    private:
+        /** Where a tick is in the ring buffer */
+        struct HistoryFrame
+        {
+            std::uint32_t offset;
+            std::uint32_t size;
+
+            /** Size of the snapshot the tick rebuilds into */
+            std::uint32_t snapshotSize;
+
+            /** How many ticks back this tick's keyframe is, 0 for a keyframe */
+            std::uint32_t keyframeDistance;
+        };
+
+        std::vector<unsigned char> _buffer;
+        std::vector<HistoryFrame> _frames;
+        int _firstFrame;
+        int _frameCount;
+        std::size_t _writePos;
+        std::size_t _bytesUsed;
+        int _keyframeInterval;
+
+        /** Copy of the newest keyframe, deltas are made against this */
+        std::vector<unsigned char> _keyframe;
+
+        /** Scratch space deltas are encoded into before they go into the ring */
+        std::vector<unsigned char> _delta;
+
+        /**
+         * @brief Looks up a tick
+         *
+         * @param frame Which tick, 0 is the oldest one kept
+         *
+         * @return The tick's entry
+         */
+        HistoryFrame& frameAt(int frame);
+        const HistoryFrame& frameAt(int frame) const;
+
+        /**
+         * @brief Finds room for a new tick at the write position, dropping old ticks in the way
+         *
+         * @param size Bytes needed
+         *
+         * @return false if the tick is bigger than the whole buffer
+         */
+        bool reserve(std::size_t size);
+
+        /**
+         * @brief Drops the oldest keyframe and every delta against it
+         */
+        void dropOldestKeyframe();
+};
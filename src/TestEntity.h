@@ -1,11 +0,0 @@
-#ifndef TESTENTITY_H
-#define TESTENTITY_H
-#include "Entity.h"
-
-class TestEntity : public Entity
-{
-    public:
-        TestEntity();
-};
-
-#endif
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include <cstdio>
+
+#include "TextureCache.h"
+#include "AssetArchive.h"
+
+TextureCache::TextureCache(bool headless) :
+    _headless(headless)
+{
+
+}
+
+int TextureCache::load(const std::string &path)
+{
+    // Hand back the existing copy if we've loaded this one before
+    for(std::size_t i = 0; i < _paths.size(); i++)
+    {
+        if(_paths[i] == path)
+        {
+            return (int)i;
+        }
+    }
+
+    // Headless caches keep an empty texture, only the image size is needed
+    sf::Texture *texture = new sf::Texture();
+    if(_headless)
+    {
+        sf::Image image;
+        if(!loadAsset(image, path))
+        {
+            printf("ERROR: image %s can not be loaded!!\n", path.c_str());
+        }
+        _sizes.push_back(image.getSize());
+    }
+    else
+    {
+        if(!loadAsset(*texture, path))
+        {
+            printf("ERROR: texture %s can not be loaded!!\n", path.c_str());
+        }
+        _sizes.push_back(texture->getSize());
+    }
+
+    _textures.push_back(texture);
+    _paths.push_back(path);
+    return (int)_textures.size() - 1;
+}
+
+const sf::Texture& TextureCache::get(int index) const
+{
+    return *_textures.at(index);
+}
+
+int TextureCache::size() const
+{
+    return (int)_textures.size();
+}
+
+int TextureCache::addSprite(int texture, sf::IntRect rect)
+{
+    // An empty rect means the whole texture
+    if(rect.width == 0 || rect.height == 0)
+    {
+        const sf::Vector2u textureSize = _sizes.at(texture);
+        rect = sf::IntRect(0, 0, textureSize.x, textureSize.y);
+    }
+
+    for(std::size_t i = 0; i < _sprites.size(); i++)
+    {
+        if(_sprites[i].texture == texture && _sprites[i].rect == rect)
+        {
+            return (int)i;
+        }
+    }
+
+    SpriteDef sprite = {texture, rect, sf::Vector2<float>((int)(rect.width / 2), (int)(rect.height / 2))};
+    _sprites.push_back(sprite);
+    return (int)_sprites.size() - 1;
+}
+
+const SpriteDef& TextureCache::getSprite(int index) const
+{
+    return _sprites.at(index);
+}
+
+int TextureCache::getSpriteCount() const
+{
+    return (int)_sprites.size();
+}
+
+TextureCache::~TextureCache()
+{
+    while(_textures.size() > 0)
+    {
+        delete _textures.at(_textures.size()-1);
+        _textures.pop_back();
+    }
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <SFML/Graphics.hpp>
+
+/** A region of a texture that entities can be drawn with. */
+struct SpriteDef
+{
+    /** Index of the texture in the TextureCache */
+    int texture;
+
+    /** Region of the texture to draw */
+    sf::IntRect rect;
+
+    /** Point of the rect that sits on the entity's position */
+    sf::Vector2<float> origin;
+};
+
+/** Class which owns every texture and sprite the game draws entities with.
+ *
+ * Each texture is loaded once and each sprite is defined once, and entities refer to
+ * them by index (see SpriteRef), so entities sharing an image also share the one copy
+ * of it instead of carrying their own.
+ *
+ * A headless cache, for running without a window, only reads the size of each image so
+ * sprites still get their real bounds, and never creates any textures on the GPU.
+ */
+class TextureCache
+{
+    public:
+        /**
+         * @brief Creates an empty cache
+         *
+         * @param headless true to only read image sizes instead of loading textures
+         */
+        explicit TextureCache(bool headless = false);
+
+        ~TextureCache();
+
+        /**
+         * @brief Loads a texture, or finds it if it was already loaded
+         *
+         * @param path Path of the image file
+         *
+         * @return Index of the texture
+         */
+        int load(const std::string &path);
+
+        /**
+         * @brief Getter for a loaded texture
+         *
+         * @param index Index returned from load()
+         *
+         * @return The texture
+         */
+        const sf::Texture& get(int index) const;
+
+        /**
+         * @brief Getter for the number of loaded textures
+         *
+         * @return Number of textures
+         */
+        int size() const;
+
+        /**
+         * @brief Defines a sprite as a region of a loaded texture, or finds the existing definition
+         *
+         * @param texture Index returned from load()
+         * @param rect Region of the texture, the whole texture if it's empty
+         *
+         * @return Index of the sprite, centered on the middle of rect
+         */
+        int addSprite(int texture, sf::IntRect rect);
+
+        /**
+         * @brief Getter for a defined sprite
+         *
+         * @param index Index returned from addSprite()
+         *
+         * @return The sprite definition
+         */
+        const SpriteDef& getSprite(int index) const;
+
+        /**
+         * @brief Getter for the number of defined sprites
+         *
+         * @return Number of sprites
+         */
+        int getSpriteCount() const;
+
+    private:
+        // Textures are never moved once loaded, sprites keep pointers to them
+        std::vector<sf::Texture*> _textures;
+        std::vector<sf::Vector2u> _sizes;
+        std::vector<std::string> _paths;
+        bool _headless;
+        std::vector<SpriteDef> _sprites;
+
+        // Not copyable, the cache owns the textures
+        TextureCache(const TextureCache&);
+        TextureCache& operator=(const TextureCache&);
+};
@@ -1,15 +1,84 @@
-#include <stdexcept>
-#include <time.h>
-#include <cstdlib>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
 
 #include "WaveManager.h"
 #include "Enemy.h"
+#include "AllocTracker.h"
 
-WaveManager::WaveManager()
+// Where enemies spawn, how far apart, and how far from the player
+static const int spawnWidth = 1450;
+static const int spawnHeight = 1125;
+static const float spawnSpacing = 30;
+static const float playerClearance = 100;
+
+// Tries at a clear spot per enemy, after that it goes wherever the last try was,
+// so a wave too crowded to fit still gets planned
+static const int maxSpawnTries = 1000;
+
+// Every this many waves is a boss wave, and how long its boss waits once the rest are in
+static const int bossEvery = 5;
+static const float bossDelay = 5;
+
+// Scripts a wave can run, each is started with the wave number
+enum WaveScriptKind
+{
+    SteadyScript,
+    BossScript,
+    WaveScriptCount
+};
+
+// Everyone comes in straight away, cycling through the kinds of enemies
+static WaveScript steadyWave(WaveManager &waves, int wave)
+{
+    waves.release(wave);
+    co_return;
+}
+
+// Everyone but the boss comes in, then a little after the last of them it turns up as
+// whichever kind of enemy has the most health
+static WaveScript bossWave(WaveManager &waves, int wave)
+{
+    waves.release(wave - 1);
+    co_await Until {SpawnsInSignal};
+    co_await Sleep {bossDelay};
+
+    const EnemyArchetypes &archetypes = waves.getArchetypes();
+    int boss = 0;
+    for(int i = 1; i < archetypes.size(); i++)
+    {
+        boss = archetypes.get(i).health > archetypes.get(boss).health ? i : boss;
+    }
+    waves.release(wave, boss);
+}
+
+static const ScriptFunction waveScripts[WaveScriptCount] = {steadyWave, bossWave};
+
+// One coordinate moved playerClearance away from the player, to whichever side is on the map
+static float pushOut(float player, float offset, float limit)
+{
+    const float side = offset < 0 ? -1 : 1;
+    const float pushed = player + side * playerClearance;
+    return pushed >= 0 && pushed < limit ? pushed : player - side * playerClearance;
+}
+
+WaveManager::WaveManager() :
+    _scripts(*this, waveScripts, WaveScriptCount)
 {
     currentWave = 0;
     enemyCount = 0;
     aliveEnemyCount =0;
+    _player = nullptr;
+    _world = nullptr;
+    _projectiles = nullptr;
+    _events = nullptr;
+    _seed = 1;
+    _nextSpawn = 0;
+    _released = 0;
+    _spawnBudget = 8;
+    _planAhead = true;
+    _plannedWave = 0;
+    _plannedSeed = 0;
 }
 
 void WaveManager::setPlayer(Player &play)
@@ -17,66 +86,255 @@ void WaveManager::setPlayer(Player &play)
     _player = &play;
 }
 
+void WaveManager::setProjectiles(ProjectileSystem &projectiles)
+{
+    _projectiles = &projectiles;
+}
+
+void WaveManager::setEvents(EventQueue *events)
+{
+    _events = events;
+}
+
+void WaveManager::setSeed(std::uint32_t seed)
+{
+    // xorshift never leaves 0
+    _seed = seed != 0 ? seed : 1;
+}
+
+int WaveManager::random(std::uint32_t &seed, int range)
+{
+    // xorshift32, same as the particles use
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return (int)(seed % (std::uint32_t)range);
+}
+
+void WaveManager::setWorld(EntityWorld &world)
+{
+    _world = &world;
+}
+
+void WaveManager::setArchetypes(const EnemyArchetypes &types)
+{
+    archetypes = types;
+}
+
 bool WaveManager::waveOver()
 {
-    for(int i=0; i<enemyCount; i++)
+    // Not over until everyone has at least turned up
+    return(getSpawnsPending() == 0 && aliveEnemyCount == 0);
+}
+
+void WaveManager::countEvents(const EventBuffer &events)
+{
+    // The player dies too, and an enemy of a wave that's been ended is no longer in the world
+    for(std::size_t i = 0; i < events.deaths.size(); i++)
     {
-        if(enemies.at(i)->isAlive())
+        if(_world->get<EnemyBrain>(events.deaths[i].target) != nullptr)
         {
-            return(false);
+            aliveEnemyCount--;
         }
     }
-    return(true);
 }
 
 void WaveManager::beginWave()
 {
     currentWave++;
-    // For now, waves will progress linearly for simple demonstration sake
-    enemyCount = currentWave;
-    aliveEnemyCount = currentWave;
-    // Spawn enemies
-    Enemy* temp = nullptr;
-    for(int i=0; i<enemyCount; i++)
+    // Wave n plans n enemies, its script decides when they come in
+    enemyCount = 0;
+    aliveEnemyCount = 0;
+
+    // The plan is normally ready from the last wave, unless the wave or seed has changed since
+    SpawnPlan plan;
+    if(_nextPlan.valid() && _plannedWave == currentWave && _plannedSeed == _seed)
+    {
+        plan = _nextPlan.get();
+    }
+    else
+    {
+        plan = planWave(currentWave, _seed);
+    }
+    _seed = plan.endSeed;
+    _pending.swap(plan.spawns);
+    _nextSpawn = 0;
+    _released = 0;
+    _kinds.clear();
+    _kinds.reserve(_pending.size());
+
+    if(_events != nullptr)
+    {
+        _events->getBuffer(WaveProducer).waves.push_back(WaveEvent {currentWave, true});
+    }
+
+    // The script decides when the planned enemies come in
+    _scripts.start(currentWave % bossEvery == 0 ? BossScript : SteadyScript, currentWave);
+
+    prepareNextWave();
+}
+
+SpawnPlan WaveManager::planWave(int wave, std::uint32_t seed)
+{
+    SpawnPlan plan;
+    plan.wave = wave;
+    plan.startSeed = seed;
+    plan.spawns.reserve(wave);
+
+    // Spawns closer than spawnSpacing are never in the same cell of this size, so a cell
+    // holds at most one and only the cells around a candidate need checking against it
+    const int columns = spawnWidth / (int)spawnSpacing + 1;
+    const int rows = spawnHeight / (int)spawnSpacing + 1;
+    std::vector<int> cells(columns * rows, -1);
+    for(int i=0; i<wave; i++)
     {
-        temp = new Enemy();
         sf::Vector2<float> spawn;
-        bool loop;
-        srand(time(0));
-        do {
-            spawn = sf::Vector2<float> (rand()%1450, rand()%1125);
-            if(spawn.x-_player->getPosition().x<100&&spawn.x-_player->getPosition().x>-100
-                    &&spawn.y-_player->getPosition().y<100&&spawn.y-_player->getPosition().y>-100)
-            {
-                loop = true;
-            }
-            else
+        int column = 0, row = 0;
+        bool clear = false;
+        for(int tries=0; tries<maxSpawnTries && !clear; tries++)
+        {
+            spawn = sf::Vector2<float> (random(seed, spawnWidth), random(seed, spawnHeight));
+            column = (int)(spawn.x / spawnSpacing);
+            row = (int)(spawn.y / spawnSpacing);
+            clear = true;
+            for(int y=std::max(row-1, 0); y<=std::min(row+1, rows-1) && clear; y++)
             {
-                loop = false;
-                for(int j=0; j<i; j++)
+                for(int x=std::max(column-1, 0); x<=std::min(column+1, columns-1) && clear; x++)
                 {
-                    if(spawn.x-enemies.at(j)->getPosition().x<30&&spawn.x-enemies.at(j)->getPosition().x>-30
-                            &&spawn.y-enemies.at(j)->getPosition().y<30&&spawn.y-enemies.at(j)->getPosition().y>-30)
-                    {
-                        loop = true;
-                        break;
-                    }
+                    const int other = cells[y * columns + x];
+                    clear = other < 0 || std::fabs(spawn.x - plan.spawns[other].x) >= spawnSpacing
+                        || std::fabs(spawn.y - plan.spawns[other].y) >= spawnSpacing;
                 }
             }
-        }while(loop);
-        temp->spawn(spawn); 
-        temp->setPlayer(_player);
-        temp->setFriends(enemies);
-        enemies.push_back(temp);
+        }
+        if(cells[row * columns + column] < 0)
+        {
+            cells[row * columns + column] = i;
+        }
+        plan.spawns.push_back(spawn);
+    }
+
+    plan.endSeed = seed;
+    return plan;
+}
+
+void WaveManager::setPlanAhead(bool planAhead)
+{
+    _planAhead = planAhead;
+    if(!planAhead && _nextPlan.valid())
+    {
+        _nextPlan = std::future<SpawnPlan>();
+    }
+}
+
+void WaveManager::prepareNextWave()
+{
+    if(!_planAhead || (_nextPlan.valid() && _plannedWave == currentWave + 1 && _plannedSeed == _seed))
+    {
+        return;
+    }
+
+    // Picking spawns only moves the seed on, so the plan comes out the same on any thread
+    _plannedWave = currentWave + 1;
+    _plannedSeed = _seed;
+    _nextPlan = std::async(std::launch::async, &WaveManager::planWave, _plannedWave, _plannedSeed);
+}
+
+sf::Vector2<float> WaveManager::awayFromPlayer(sf::Vector2<float> spawn) const
+{
+    // The plan was made before anyone knew where the player would be when it's used
+    const sf::Vector2<float> player = _player->getPosition();
+    const sf::Vector2<float> offset = spawn - player;
+    if(std::fabs(offset.x) >= playerClearance || std::fabs(offset.y) >= playerClearance)
+    {
+        return spawn;
     }
+
+    // Out along whichever axis is the shorter way
+    if(std::fabs(offset.x) >= std::fabs(offset.y))
+    {
+        spawn.x = pushOut(player.x, offset.x, spawnWidth);
+    }
+    else
+    {
+        spawn.y = pushOut(player.y, offset.y, spawnHeight);
+    }
+    return spawn;
+}
+
+int WaveManager::spawnPending(int budget)
+{
+    int spawned = 0;
+    while(spawned < budget && _nextSpawn < _released)
+    {
+        spawnEnemy(_kinds[_nextSpawn], awayFromPlayer(_pending[_nextSpawn]));
+        _nextSpawn++;
+        spawned++;
+    }
+    return spawned;
+}
+
+void WaveManager::release(int count, int archetype)
+{
+    count = std::min(count, (int)_pending.size());
+    for(int i = _released; i < count; i++)
+    {
+        _kinds.push_back((std::uint16_t)(archetype < 0 ? i % archetypes.size() : archetype));
+    }
+    _released = std::max(_released, count);
+}
+
+bool WaveManager::holds(ScriptSignal signal)
+{
+    const bool spawnsIn = _nextSpawn >= _released;
+    if(signal == ClearedSignal)
+    {
+        return spawnsIn && aliveEnemyCount == 0;
+    }
+    return spawnsIn;
+}
+
+void WaveManager::setSpawnBudget(int budget)
+{
+    _spawnBudget = std::max(budget, 1);
+}
+
+int WaveManager::getSpawnsPending() const
+{
+    return (int)_pending.size() - _nextSpawn;
+}
+
+EntityId WaveManager::spawnEnemy(int archetype, sf::Vector2<float> pos)
+{
+    EntityId enemy = Enemy::spawn(*_world, archetypes, archetype, pos);
+    enemies.push_back(enemy);
+    if(_events != nullptr)
+    {
+        _events->getBuffer(WaveProducer).spawns.push_back(SpawnEvent {enemy, archetype, pos});
+    }
+    enemyCount++;
+    aliveEnemyCount++;
+    return enemy;
 }
 
 void WaveManager::endWave()
 {
+    if(_events != nullptr)
+    {
+        _events->getBuffer(WaveProducer).waves.push_back(WaveEvent {currentWave, false});
+    }
+
+    // The next wave starts straight after, so it may as well wait for its plan here
+    if(_nextPlan.valid())
+    {
+        _nextPlan.wait();
+    }
+
     // Clear gamestate
+    _scripts.clear();
     while(enemies.size() > 0)
     {
-        delete enemies.at(enemies.size()-1);
+        _world->destroy(enemies.at(enemies.size()-1));
         enemies.pop_back();
     }
 }
@@ -86,9 +344,20 @@ int WaveManager::getWave()
     return(currentWave);
 }
 
+void WaveManager::setWave(int wave)
+{
+    currentWave = wave;
+
+    // Letting go of a future from std::async waits for its thread
+    if(_nextPlan.valid() && _plannedWave != currentWave + 1)
+    {
+        _nextPlan = std::future<SpawnPlan>();
+    }
+}
+
 int WaveManager::getEnemies()
 {
-    return(enemyCount);
+    return(enemyCount + getSpawnsPending());
 }
 
 int WaveManager::getEnemiesAlive()
@@ -101,7 +370,7 @@ int WaveManager::getEnemiesRemaining()
     int alive = 0;
     for(int i=0; i<enemyCount; i++)
     {
-        if(enemies.at(i)->isAlive())
+        if(isAlive(*_world, enemies.at(i)))
         {
             alive++;
         }
@@ -118,68 +387,122 @@ void WaveManager::update(float deltaTime)
         beginWave();
     }
 
-    // Update all our enemy objects
-    for(int i=0; i<enemyCount; i++)
-    {
-        if(enemies.at(i)->isAlive())
-        {
-            enemies.at(i)->update(deltaTime);
-        }
-    }
+    // Scripts whose sleep has run out may let more of the wave in
+    _scripts.update(deltaTime);
+
+    // A new wave comes in a few enemies at a time rather than all in one frame
+    spawnPending(_spawnBudget);
+
+    // Then scripts waiting on what that or the last step brought about go on
+    _scripts.signal(SpawnsInSignal);
+    _scripts.signal(ClearedSignal);
 
-    // Update the alive enemy count
-    aliveEnemyCount = getEnemiesRemaining();
+    // Sorting enemies by state only needs as much room as there are entities
+    _groups.reserve(_world->getEntityCount(), archetypes.getBehaviors().getStateCount());
+
+    // Between waves is the only time enemies get created, so from here on nothing may allocate
+    NoAllocZone zone("WaveManager::update");
+
+    // Update all our enemies in one pass
+    Enemy::updateAll(*_world, archetypes, *_player, *_projectiles, _groups, deltaTime,
+            _events != nullptr ? &_events->getBuffer(EnemyProducer) : nullptr);
 }
 
-void WaveManager::waveDraw()
+EntityId WaveManager::getEnemy(int n)
 {
-    for(int i=0; i<enemyCount; i++)
+    if(n>=0 && n<(int)enemies.size())
     {
-        if(enemies.at(i)->isAlive())
-        {
-            enemies.at(i)->onDraw();
-        }
+        return(enemies[n]);
     }
+    // Same as an enemy that's been destroyed, isAlive() and EntityWorld::get() turn it away
+    return(EntityId());
 }
 
-sf::RectangleShape WaveManager::getHealthBarBorder(Enemy* e)
+const std::vector<EntityId>& WaveManager::getEnemiesVec() const
 {
-    const sf::Vector2<float> barOutterSize{50.f, 5.f};
-    const sf::Vector2<float> barPosition{(e->_position.x)-23, (e->_position.y)-30};
-    sf::RectangleShape outsideRect(barOutterSize);
-    outsideRect.setPosition(barPosition);
-    outsideRect.setFillColor(sf::Color(45, 45, 45, 255));
-    outsideRect.setOutlineColor(sf::Color::Black);
-    outsideRect.setOutlineThickness(2);
-    return outsideRect;
-
+    return this->enemies;
 }
 
-sf::RectangleShape WaveManager::getHealthBar(Enemy* e)
+const EnemyArchetypes& WaveManager::getArchetypes() const
 {
-    const sf::Vector2<float> barOutterSize{50.f, 5.f};
-    const sf::Vector2<float> barInnerSize{barOutterSize.x * ((float)e->getHealth() / 100.0f), barOutterSize.y};
-    const sf::Vector2<float> barPosition{(e->_position.x)-23, (e->_position.y)-30};
-    sf::RectangleShape insideRect(barInnerSize);
-    insideRect.setPosition(barPosition);
-    insideRect.setFillColor(sf::Color(255, 0, 0, 255));
-    return insideRect;
+    return this->archetypes;
 }
 
+void WaveManager::saveTo(Snapshot &snapshot) const
+{
+    snapshot.write((std::int32_t)currentWave);
+    snapshot.write((std::int32_t)enemyCount);
+    snapshot.write((std::int32_t)aliveEnemyCount);
+    snapshot.write(_seed);
+    snapshot.writeVector(enemies);
+    snapshot.write((std::int32_t)_nextSpawn);
+    snapshot.writeVector(_pending);
+    snapshot.write((std::int32_t)_released);
+    snapshot.writeVector(_kinds);
+    _scripts.saveTo(snapshot);
+}
 
-Enemy* WaveManager::getEnemy(int n)
+bool WaveManager::loadFrom(Snapshot &snapshot)
 {
-    // Blah blah not how blah blah no enemies blah blah
-    if(n<(int)enemies.size())
+    std::int32_t wave, count, alive, nextSpawn, released;
+    if(!snapshot.read(wave) || !snapshot.read(count) || !snapshot.read(alive)
+            || !snapshot.read(_seed) || !snapshot.readVector(enemies)
+            || !snapshot.read(nextSpawn) || !snapshot.readVector(_pending)
+            || !snapshot.read(released) || !snapshot.readVector(_kinds))
     {
-        return(enemies.at(n));
+        return false;
     }
-    // no clue how this is gonna work with enemies, god I wish we used rust
-    //return(-1);
-    throw std::runtime_error("literally how");
-}
 
-const std::vector<Enemy*>& WaveManager::getEnemiesVec() const
-{
-    return this->enemies;
+    // spawnPending() indexes the spawn points and kinds with these, and wave n always plans
+    // n spawn points, so anything that doesn't add up is a corrupt snapshot
+    bool valid = wave >= 0 && (std::size_t)wave == _pending.size()
+        && count >= 0 && (std::size_t)count == enemies.size() && alive >= 0 && alive <= count
+        && nextSpawn >= 0 && nextSpawn <= released && (std::size_t)released <= _pending.size()
+        && _kinds.size() == (std::size_t)released;
+    for(std::size_t i = 0; i < _kinds.size() && valid; i++)
+    {
+        valid = _kinds[i] < archetypes.size();
+    }
+    if(!valid)
+    {
+        return false;
+    }
+
+    currentWave = wave;
+    enemyCount = count;
+    aliveEnemyCount = alive;
+    _nextSpawn = nextSpawn;
+    _released = released;
+
+    // Enemy::updateAll() indexes the state tables with what the snapshot holds, so a state
+    // from other behaviors than the ones loaded goes back to its archetype's start state
+    const BehaviorTable &behaviors = archetypes.getBehaviors();
+    const int stateCount = behaviors.getStateCount();
+    bool known = true;
+    _world->each<EnemyBrain>([&](EntityId, EnemyBrain &brain)
+    {
+        if(brain.archetype >= archetypes.size())
+        {
+            known = false;
+        }
+        else if(brain.state >= stateCount)
+        {
+            brain.state = behaviors.getStartState(archetypes.get(brain.archetype).behavior);
+        }
+    });
+    if(!known)
+    {
+        printf("ERROR: snapshot has enemies of an unknown archetype!!\n");
+        return false;
+    }
+
+    // The scripts go last, restarting them may call back into the wave restored above
+    if(!_scripts.loadFrom(snapshot))
+    {
+        return false;
+    }
+
+    // Replanning only happens if this went back past a wave change
+    prepareNextWave();
+    return true;
 }
@@ -1,13 +1,43 @@
 #pragma once
 
+#include <cstdint>
+#include <future>
 #include <vector>
 #include "Enemy.h"
 #include "Player.h"
+#include "EntityWorld.h"
+#include "TextureCache.h"
+#include "EnemyArchetypes.h"
+#include "ProjectileSystem.h"
+#include "GameEvents.h"
+#include "Snapshot.h"
+#include "ScriptScheduler.h"
+
+/** Where every enemy of one wave will spawn, worked out ahead of time. */
+struct SpawnPlan
+{
+    int wave;
+
+    /** Spawn seed the plan was made from, and the seed once it's been used */
+    std::uint32_t startSeed;
+    std::uint32_t endSeed;
+
+    /** One position per enemy, in spawn order */
+    std::vector<sf::Vector2<float> > spawns;
+};
 
 /** Class which is used by GameManager to spawn and update hoards of enemies.
  * 
  * WaveManager exclusively owns the enemies of the game, so it is calling
  * the drawing and updating functions for them.
+ *
+ * While a wave is being played, where the next one spawns is worked out on another thread.
+ * A new wave doesn't appear all at once either, it enters a few enemies per update (see
+ * setSpawnBudget()), so moving between waves never costs one frame much more than another.
+ *
+ * When the enemies of a wave are let in is up to the wave's script, a coroutine run by a
+ * ScriptScheduler. Most waves let everyone in straight away, every fifth one holds its last
+ * enemy back for a few seconds and sends it in as the toughest kind there is.
  */
 class WaveManager
 {
@@ -15,8 +45,75 @@ class WaveManager
         int currentWave;
         int enemyCount;
         int aliveEnemyCount;
-        std::vector<Enemy*> enemies;
+        std::vector<EntityId> enemies;
         Player* _player;
+        EntityWorld* _world;
+        ProjectileSystem* _projectiles;
+        EventQueue* _events;
+        EnemyArchetypes archetypes;
+
+        /** Enemies sorted by behavior state each update, kept so its storage is reused */
+        BehaviorGroups _groups;
+
+        /** State of the generator spawn points are picked with, see random() */
+        std::uint32_t _seed;
+
+        /** Spawn points of the current wave, and how many of them have been used */
+        std::vector<sf::Vector2<float> > _pending;
+        int _nextSpawn;
+
+        /** How many spawn points the wave's scripts have let in, and the kind of enemy for each */
+        int _released;
+        std::vector<std::uint16_t> _kinds;
+
+        /** Runs the scripts of the current wave */
+        ScriptScheduler _scripts;
+
+        /** Most enemies spawned by one update */
+        int _spawnBudget;
+
+        /** The next wave's plan, being made in the background from _plannedSeed, if planning ahead */
+        bool _planAhead;
+        std::future<SpawnPlan> _nextPlan;
+        int _plannedWave;
+        std::uint32_t _plannedSeed;
+
+        /**
+         * @brief picks a random number from a generator, each wave manager has its
+         *  own so separate games never share random state
+         * 
+         * @param seed generator state, moved on
+         * @param range how many numbers to pick from
+         * 
+         * @return a number from 0 to range - 1
+         */
+        static int random(std::uint32_t &seed, int range);
+
+        /**
+         * @brief picks where every enemy of a wave spawns, at least 30 apart from each other
+         *  only touches its arguments, so it can run on any thread
+         * 
+         * @param wave the wave to plan, wave n has n enemies
+         * @param seed spawn seed to start from
+         * 
+         * @return the spawn points and the seed after picking them
+         */
+        static SpawnPlan planWave(int wave, std::uint32_t seed);
+
+        /**
+         * @brief starts planning the wave after the current one in the background, unless
+         *  that's already under way
+         */
+        void prepareNextWave();
+
+        /**
+         * @brief moves a spawn point out from around the player
+         * 
+         * @param spawn the planned spawn point
+         * 
+         * @return a spawn point at least 100 from the player on one axis
+         */
+        sf::Vector2<float> awayFromPlayer(sf::Vector2<float> spawn) const;
 
     public:
         /** WaveManager constructor */
@@ -29,23 +126,151 @@ class WaveManager
          */ 
         void setPlayer(Player &play);
 
+        /**
+         * @brief establishes the world the enemies are spawned into
+         * 
+         * @param world world owned by GameManager
+         */ 
+        void setWorld(EntityWorld &world);
+
+        /**
+         * @brief sets the definitions of every kind of enemy that can be spawned
+         * 
+         * @param types enemy archetypes, loaded by GameManager
+         */ 
+        void setArchetypes(const EnemyArchetypes &types);
+
+        /**
+         * @brief establishes the projectile pool ranged enemies fire into
+         * 
+         * @param projectiles projectile pool owned by GameManager
+         */ 
+        void setProjectiles(ProjectileSystem &projectiles);
+
+        /**
+         * @brief establishes where spawns, wave changes and enemy hits get raised, the wave
+         *  manager writes into the WaveProducer and EnemyProducer buffers
+         * 
+         * @param events event queue owned by GameSimulation, or nullptr to raise nothing
+         */ 
+        void setEvents(EventQueue *events);
+
+        /**
+         * @brief seeds where enemies get spawned, the same seed always gives the same waves
+         * 
+         * @param seed any number but 0
+         */ 
+        void setSeed(std::uint32_t seed);
+
         /**
          * @brief determines if the current wave has no remaininig enemies
+         *  goes by the count kept from death events, see countEvents()
          * 
          * @return returns true if no enemies remain
          */
         bool waveOver();
 
         /**
-         * @brief begins a new wave when called
+         * @brief takes the enemies that died in a tick off the alive count
+         *  the wave ends and the HUD counts down by this, rather than by looking at every enemy
+         * 
+         * @param events every event of the tick, after EventQueue::merge()
+         */
+        void countEvents(const EventBuffer &events);
+
+        /**
+         * @brief begins a new wave when called and starts its script, the enemies the script
+         *  lets in come in over the next updates or all at once with spawnPending()
          */
         void beginWave();
 
         /**
-         * @brief ends the current wave when called
+         * @brief called by wave scripts, lets the first spawn points of the wave in
+         *  a total rather than a number to add, so a script restored from a snapshot can do it again
+         * 
+         * @param count how many spawn points in total may have come in, at most the wave's enemies
+         * @param archetype kind of enemy for the ones let in now, or -1 to cycle through every kind
+         */
+        void release(int count, int archetype = -1);
+
+        /**
+         * @brief checks whether what a script waits for has come about
+         * 
+         * @param signal what the script waits for
+         * 
+         * @return true if it holds right now
+         */
+        bool holds(ScriptSignal signal);
+
+        /**
+         * @brief spawns enemies of the current wave that haven't come in yet
+         * 
+         * @param budget the most to spawn
+         * 
+         * @return how many were spawned
+         */
+        int spawnPending(int budget);
+
+        /**
+         * @brief sets how many enemies may enter per update while a wave is coming in
+         * 
+         * @param budget at least 1
+         */
+        void setSpawnBudget(int budget);
+
+        /**
+         * @brief sets whether the next wave is planned in the background while this one plays
+         *  off, each wave is planned when it begins, and a plan under way is waited for
+         * 
+         * @param planAhead true to plan ahead, the default
+         */
+        void setPlanAhead(bool planAhead);
+
+        /**
+         * @brief gets how many enemies of the current wave are still to come in, including the
+         *  ones its script hasn't let in yet
+         * 
+         * @return number of enemies not spawned yet
+         */
+        int getSpawnsPending() const;
+
+        /**
+         * @brief ends the current wave when called, stopping its scripts
+         *  waits for the next wave's plan if it's still being made
          */
         void endWave();
 
+        /**
+         * @brief adds a single enemy to the current wave
+         * 
+         * @param archetype which kind of enemy to spawn
+         * @param pos where to spawn it
+         * 
+         * @return the new enemy
+         */
+        EntityId spawnEnemy(int archetype, sf::Vector2<float> pos);
+
+        /**
+         * @brief writes the wave progress, spawn seed, the ids of its enemies, where the
+         *  rest of them will spawn and how far its scripts are into a snapshot
+         * 
+         * @param snapshot where to write to
+         */
+        void saveTo(Snapshot &snapshot) const;
+
+        /**
+         * @brief replaces the wave progress, spawn seed, enemy ids, spawn points and scripts
+         *  with the ones in a snapshot
+         *  the enemies themselves are restored with the EntityWorld, which has to be loaded first
+         *  so their behavior states can be checked
+         * 
+         * @param snapshot where to read from
+         * 
+         * @return false if the snapshot is cut short, its spawn progress doesn't add up, or it
+         *  has enemies of an unknown archetype
+         */
+        bool loadFrom(Snapshot &snapshot);
+
         /**
          * @brief gets current wave number
          * 
@@ -54,7 +279,15 @@ class WaveManager
         int getWave();
 
         /**
-         * @brief gets total number of enemies in current wave (alive or dead)
+         * @brief sets the current wave number, the next beginWave() starts the one after it
+         *  a plan being made for any other wave is waited for and thrown away
+         * 
+         * @param wave the wave to carry on from
+         */
+        void setWave(int wave);
+
+        /**
+         * @brief gets total number of enemies in current wave (alive, dead or still to come in)
          * 
          * @return total number of enemies
          */
@@ -62,6 +295,7 @@ class WaveManager
 
         /**
          * @brief gets number of remaining alive enemies in current wave
+         *  kept from spawns and death events, so it's up to date as of the last tick
          * 
          * @return number of remaining enemies
          */
@@ -69,6 +303,8 @@ class WaveManager
 
         /**
          * @brief gets number of remaining enemies
+         *  looks at every enemy, unlike getEnemiesAlive() an enemy killed this tick counts
+         *  until its health is next updated
          * 
          * @return number of remaining enemies
          */
@@ -88,28 +324,19 @@ class WaveManager
         void updateAliveEnemyCount();
 
         /**
-         * @brief calls upon all enemies to update their position for the next frame
+         * @brief fetches enemy at requested position
          * 
-         * @param time used to adjust position in the event that frames take uneven calculation times
-         */
-        void updateEnemies(float time);
-
-        /**
-         * @brief calls upon all enemies to prepare for drawing
+         * @param n enemy number
+         * 
+         * @return returns the id of the requested enemy, or an invalid id if there's no enemy n
          */
-        void waveDraw();
-
-        sf::RectangleShape getHealthBarBorder(Enemy* e);
-
-        sf::RectangleShape getHealthBar(Enemy* e);
+        EntityId getEnemy(int n);
+        const std::vector<EntityId> &getEnemiesVec() const;
 
         /**
-         * @brief fetches enemy at requested position
-         * 
-         * @param n enemy number
+         * @brief gets the definitions of every kind of enemy
          * 
-         * @return returns a pointer to the requested enemy
+         * @return the enemy archetypes
          */
-        Enemy* getEnemy(int n);
-        const std::vector<Enemy*> &getEnemiesVec() const;
+        const EnemyArchetypes &getArchetypes() const;
 };
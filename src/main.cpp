@@ -1,9 +1,127 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+
 #include "GameManager.h"
+#include "GameServer.h"
+#include "GameClient.h"
+#include "BatchSimulator.h"
+#include "AllocTracker.h"
+#include "AssetArchive.h"
+
+// Port used when none is given
+static const unsigned short defaultPort = 27015;
+
+/** Headless client that wanders around for a while, for trying out a server without a window. */
+static int runBot(const sf::IpAddress &address, unsigned short port, int seconds)
+{
+    GameClient client;
+    if(!client.connect(address, port))
+    {
+        return 1;
+    }
+
+    // Turn to a new random direction every half a second and attack now and then
+    sf::Clock clock;
+    PlayerInput input = {sf::Vector2<float>(0, 0), false, false};
+    int frame = 0;
+    NetFrame netFrame;
+    while(clock.getElapsedTime() < sf::seconds((float)seconds))
+    {
+        if(frame % 30 == 0)
+        {
+            input.move = sf::Vector2<float>(rand() % 3 - 1, rand() % 3 - 1);
+        }
+        input.attack = frame % 45 == 0;
+        input.dodge = frame % 120 == 0;
+
+        client.sendInput(input);
+        client.update();
+        client.interpolate(netFrame);
+
+        frame++;
+        sf::sleep(sf::milliseconds(16));
+    }
+
+    if(!client.isConnected())
+    {
+        printf("ERROR: server %s:%d never answered!!\n", address.toString().c_str(), (int)port);
+        return 1;
+    }
+    return 0;
+}
 
-/** Creates a GameManager and runs the main game loop. */
-int main()
+/** Finds the directory the executable is in, with a trailing slash. */
+static std::string executableDirectory(const char *argv0)
 {
+    char path[4096];
+    const ssize_t length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+    const std::string executable = length > 0 ? std::string(path, length) : std::string(argv0);
+    const std::size_t slash = executable.find_last_of('/');
+    return slash == std::string::npos ? std::string() : executable.substr(0, slash + 1);
+}
+
+/** Creates a GameManager and runs the main game loop.
+ *
+ * Usage:
+ *     Gaming.out                                play locally
+ *     Gaming.out --server [port]                run a headless server
+ *     Gaming.out --connect address [port]       play on a server
+ *     Gaming.out --bot address [port] [seconds] headless client that wanders around
+ *     Gaming.out --batch runs [waves] [threads] [file]
+ *                                               play seeded games without a window, write
+ *                                               CSV of every wave to file (default stdout)
+ */
+int main(int argc, char **argv)
+{
+    // ALLOC_SAMPLING=n prints where one in every n allocations came from, in ALLOC_TRACKING builds
+    if(getenv("ALLOC_SAMPLING") != nullptr)
+    {
+        AllocTracker::setSampling(atoi(getenv("ALLOC_SAMPLING")));
+    }
+
+    // Assets come out of the archive next to the executable, so it runs from any directory.
+    // Without one they're read as loose files from the working directory instead.
+    if(!AssetArchive::mount(executableDirectory(argv[0]) + "assets.pak"))
+    {
+        printf("No asset archive, loading loose files\n");
+    }
+
+    if(argc > 1 && strcmp(argv[1], "--server") == 0)
+    {
+        GameServer server(argc > 2 ? (unsigned short)atoi(argv[2]) : defaultPort);
+        if(!server.isListening())
+        {
+            return 1;
+        }
+        printf("Listening on port %d\n", (int)server.getPort());
+        server.run(-1);
+        return 0;
+    }
+
+    if(argc > 2 && strcmp(argv[1], "--bot") == 0)
+    {
+        return runBot(sf::IpAddress(argv[2]), argc > 3 ? (unsigned short)atoi(argv[3]) : defaultPort,
+                argc > 4 ? atoi(argv[4]) : 10);
+    }
+
+    if(argc > 2 && strcmp(argv[1], "--batch") == 0)
+    {
+        BatchSimulator batch(atoi(argv[2]), argc > 3 ? atoi(argv[3]) : 10, 1);
+        sf::Clock clock;
+        batch.run(argc > 4 ? atoi(argv[4]) : 0);
+        fprintf(stderr, "Played %d runs in %.2f seconds\n", atoi(argv[2]), clock.getElapsedTime().asSeconds());
+        return batch.writeCsv(argc > 5 ? argv[5] : "-") ? 0 : 1;
+    }
+
     GameManager gaming;
+    if(argc > 2 && strcmp(argv[1], "--connect") == 0
+            && !gaming.connect(sf::IpAddress(argv[2]), argc > 3 ? (unsigned short)atoi(argv[3]) : defaultPort))
+    {
+        return 1;
+    }
     gaming.runGame();
 
     return 0;
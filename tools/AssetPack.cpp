@@ -0,0 +1,39 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "AssetArchive.h"
+
+/** Packs loose asset files into one archive the game maps at startup.
+ *
+ * Usage:
+ *     AssetPack.out archive file...
+ *
+ * Files are named in the archive by the path given, so run it from the repo root with the
+ * same relative paths the game loads them by (make pack does this).
+ */
+int main(int argc, char **argv)
+{
+    if(argc < 3)
+    {
+        printf("Usage: %s archive file...\n", argv[0]);
+        return 1;
+    }
+
+    const std::vector<std::string> files(argv + 2, argv + argc);
+    if(!AssetArchive::pack(argv[1], files))
+    {
+        return 1;
+    }
+
+    // Read it back the way the game will, so a bad archive fails the build instead
+    AssetArchive archive;
+    if(!archive.open(argv[1]) || !archive.verify() || archive.size() != (int)files.size())
+    {
+        printf("ERROR: %s doesn't read back!!\n", argv[1]);
+        return 1;
+    }
+
+    printf("Packed %d files into %s\n", archive.size(), argv[1]);
+    return 0;
+}